@@ -0,0 +1,146 @@
+#define RL_IMPLEMENTATION
+#include "../roguelike.h"
+
+#include <stdio.h>
+#include <time.h>
+
+#define WIDTH 80
+#define HEIGHT 30
+
+/* simple tracking allocator - counts live allocations */
+typedef struct {
+    size_t allocations;
+    size_t live;
+} Tracker;
+
+void *tracker_alloc(void *user, size_t size)
+{
+    Tracker *t = (Tracker*) user;
+    t->allocations++;
+    t->live++;
+    return malloc(size);
+}
+
+void tracker_free(void *user, void *ptr)
+{
+    Tracker *t = (Tracker*) user;
+    t->live--;
+    free(ptr);
+}
+
+int main(int argc, char **argv)
+{
+    unsigned long seed = time(0);
+    if (argc > 1) {
+        seed = atol(argv[1]);
+    }
+    printf("Seed: %lu\n", seed);
+    srand(seed);
+
+    /* BSP nodes from a pool */
+    RL_Pool pool = rl_pool_create(sizeof(RL_BSP), 64);
+    RL_Allocator pool_allocator = rl_pool_allocator(&pool);
+    RL_Map map = rl_map_create(WIDTH, HEIGHT);
+    RL_BSP *bsp = rl_bsp_create_ex(WIDTH, HEIGHT, &pool_allocator);
+    if (rl_mapgen_bsp_ex(map, bsp, RL_MAPGEN_BSP_DEFAULTS) != RL_OK) {
+        fprintf(stderr, "Error during mapgen\n");
+        return 1;
+    }
+    printf("BSP leaves: %zu\n", rl_bsp_leaf_count(bsp));
+    rl_bsp_destroy(bsp);
+
+    /* graphs & paths from an arena - reset once per "turn" */
+    RL_Arena arena = rl_arena_create(WIDTH * HEIGHT * sizeof(RL_GraphNode) * 4);
+    RL_Allocator arena_allocator = rl_arena_allocator(&arena);
+    for (int turn = 0; turn < 10; ++turn) {
+        unsigned int sx, sy, ex, ey;
+        rl_rng_map_passable(map, &sx, &sy);
+        rl_rng_map_passable(map, &ex, &ey);
+        RL_Path *path = rl_path_create_ex(map, rl_point(sx, sy), rl_point(ex, ey), NULL, NULL, &arena_allocator);
+        assert(path != NULL);
+        int length = 0;
+        while ((path = rl_path_walk(path))) length++;
+        printf("Turn %d: path length %d (arena used %zu bytes)\n", turn, length, arena.used);
+        rl_arena_reset(&arena);
+    }
+
+    /* tracking allocator - ensure everything is freed */
+    Tracker tracker = {0};
+    RL_Allocator tracking_allocator = { tracker_alloc, tracker_free, &tracker };
+    RL_Map tracked_map = rl_map_create_ex(WIDTH, HEIGHT, &tracking_allocator);
+    RL_FOV fov = rl_fov_create_ex(WIDTH, HEIGHT, &tracking_allocator);
+    RL_Graph graph = rl_graph_create_ex(WIDTH, HEIGHT, NULL, &tracking_allocator);
+    rl_mapgen_automata(tracked_map, RL_MAPGEN_AUTOMATA_DEFAULTS);
+    unsigned int x, y;
+    rl_rng_map_passable(tracked_map, &x, &y);
+    rl_graph_score(graph, tracked_map, rl_point(x, y), NULL);
+    rl_fov_calculate(fov, tracked_map, x, y, 8);
+    rl_graph_destroy(graph);
+
+    /* the map sized modules - including the memory they grow into */
+    graph = rl_graph_create_scored_ex(tracked_map, rl_point(x, y), NULL, NULL, &tracking_allocator);
+    assert(graph.nodes != NULL && graph.allocator == &tracking_allocator);
+    rl_graph_destroy(graph);
+    RL_PathSearch *search = rl_path_search_create_ex(tracked_map, rl_point(x, y), rl_point(x, y), NULL, NULL, NULL, &tracking_allocator);
+    rl_path_search_step(search, 100);
+    rl_path_destroy(rl_path_search_path(search));
+    rl_path_search_destroy(search);
+    RL_Occupancy occupancy = rl_occupancy_create_ex(WIDTH, HEIGHT, 1, &tracking_allocator);
+    assert(rl_occupancy_insert(&occupancy, 100, x, y));
+    rl_path_destroy(rl_path_create_occupancy_ex(tracked_map, &occupancy, rl_point(x, y), rl_point(x, y), 100, FLT_MAX, &tracking_allocator));
+    rl_occupancy_destroy(occupancy);
+    RL_Coop *coop = rl_coop_create_ex(tracked_map, 1, 8, NULL, &tracking_allocator);
+    rl_coop_set_agent(coop, 0, rl_point(x, y), rl_point(x, y));
+    assert(rl_coop_plan(coop) == RL_OK);
+    rl_coop_destroy(coop);
+    graph = rl_graph_create_approach_ex(tracked_map, rl_point(x, y), 6, &tracking_allocator);
+    assert(graph.nodes != NULL);
+    rl_graph_destroy(graph);
+    RL_Influence *influence = rl_influence_create_ex(tracked_map, NULL, NULL, &tracking_allocator);
+    RL_InfluenceSource source = { .x = x, .y = y, .strength = 10, .radius = 20, .falloff = RL_FalloffLinear };
+    assert(rl_influence_add(influence, &source) == RL_OK);
+    rl_influence_destroy(influence);
+    RL_Explore *explore = rl_explore_create_ex(tracked_map, fov, NULL, NULL, &tracking_allocator);
+    assert(rl_explore_update(explore, x, y, 8) == RL_OK);
+    rl_explore_destroy(explore);
+    RL_FloodFill *fill = rl_floodfill_create_ex(WIDTH, HEIGHT, &tracking_allocator);
+    assert(rl_floodfill(fill, tracked_map, x, y, true, NULL, NULL, NULL) == RL_OK);
+    rl_floodfill_destroy(fill);
+    RL_Reachability *reach = rl_reachability_create_ex(tracked_map, &tracking_allocator);
+    assert(rl_reachability_connected(reach, x, y, x, y));
+    rl_reachability_destroy(reach);
+    RL_Diffusion *diffusion = rl_diffusion_create_ex(tracked_map, &tracking_allocator);
+    rl_diffusion_destroy(diffusion);
+    RL_AoeTable aoe = rl_aoe_table_create_ex(8, &tracking_allocator);
+    RL_Point tiles[256];
+    assert(rl_aoe_blast(&aoe, tracked_map, rl_point(x, y), 8, tiles, 256) > 0);
+    rl_aoe_table_destroy(aoe);
+    RL_Rect halves[2] = { { 0, 0, WIDTH / 2, HEIGHT }, { WIDTH / 2, 0, WIDTH / 2, HEIGHT } };
+    RL_RoomTable rooms = rl_room_table_create_ex(map, halves, 2, &tracking_allocator);
+    assert(rooms.distances != NULL);
+    rl_room_table_destroy(rooms);
+    RL_BSP *tracked_bsp = rl_bsp_create_ex(WIDTH, HEIGHT, &tracking_allocator);
+    rooms = rl_room_table_create_bsp_ex(map, tracked_bsp, &tracking_allocator);
+    assert(rooms.distances != NULL && rooms.room_count == 1);
+    rl_room_table_destroy(rooms);
+    rl_bsp_destroy(tracked_bsp);
+    const float weights[] = { 50, 30, 15, 5 };
+    RL_WeightedTable weighted = rl_weighted_table_create_ex(weights, 4, &tracking_allocator);
+    assert(rl_weighted_table_sample(weighted) < 4);
+    rl_weighted_table_destroy(weighted);
+    RL_MapAnalysis analysis = rl_map_analysis_create_ex(WIDTH, HEIGHT, &tracking_allocator);
+    assert(rl_map_analyze(analysis, tracked_map, 1) == RL_OK);
+    rl_map_analysis_destroy(analysis);
+    rl_fov_destroy_ex(fov, &tracking_allocator);
+    rl_map_destroy_ex(tracked_map, &tracking_allocator);
+    printf("Tracked allocations: %zu, live: %zu\n", tracker.allocations, tracker.live);
+    assert(tracker.live == 0);
+
+    rl_arena_destroy(arena);
+    rl_pool_destroy(pool);
+    rl_map_destroy(map);
+
+    printf("Done\n");
+
+    return 0;
+}
@@ -0,0 +1,126 @@
+#define RL_IMPLEMENTATION
+#include "../roguelike.h"
+
+#include <stdio.h>
+#include <time.h>
+
+#define WIDTH 40
+#define HEIGHT 20
+
+/* counts the connected areas of passable tiles, skipping the removed tile & the step between a and b */
+static int count_areas(RL_Map map, long removed, long a, long b)
+{
+    static long stack[WIDTH * HEIGHT];
+    static bool visited[WIDTH * HEIGHT];
+    int areas = 0;
+    memset(visited, 0, sizeof(visited));
+    for (long start = 0; start < WIDTH * HEIGHT; ++start) {
+        if (start == removed || visited[start] || !rl_map_is_passable(map, start % WIDTH, start / WIDTH)) continue;
+        areas++;
+        long len = 0;
+        stack[len++] = start;
+        visited[start] = true;
+        while (len) {
+            long cur = stack[--len];
+            for (int dy = -1; dy <= 1; ++dy) {
+                for (int dx = -1; dx <= 1; ++dx) {
+                    unsigned int x = cur % WIDTH + dx, y = cur / WIDTH + dy;
+                    long n = x + y * WIDTH;
+                    if ((dx == 0 && dy == 0) || !rl_map_in_bounds(map, x, y) || !rl_map_is_passable(map, x, y)) continue;
+                    if (n == removed || visited[n] || (cur == a && n == b) || (cur == b && n == a)) continue;
+                    visited[n] = true;
+                    stack[len++] = n;
+                }
+            }
+        }
+    }
+
+    return areas;
+}
+
+int main(int argc, char **argv)
+{
+    unsigned long seed = time(0);
+    if (argc > 1) {
+        seed = atol(argv[1]);
+    }
+    printf("Seed: %lu\n", seed);
+    srand(seed);
+
+    /* articulation points & bridges match removing each tile & step */
+    RL_Map map = rl_map_create(WIDTH, HEIGHT);
+    RL_MapgenConfigAutomata config = RL_MAPGEN_AUTOMATA_DEFAULTS;
+    config.cull_unconnected = false;
+    config.fill_border = true;
+    if (rl_mapgen_automata(map, config) != RL_OK) {
+        fprintf(stderr, "Error during mapgen\n");
+        return 1;
+    }
+    RL_MapAnalysis analysis = rl_map_analysis_create(WIDTH, HEIGHT);
+    assert(rl_map_analyze(analysis, map, 1) == RL_OK);
+    int areas = count_areas(map, -1, -1, -1), articulations = 0, bridges = 0;
+    for (long i = 0; i < WIDTH * HEIGHT; ++i) {
+        unsigned int x = i % WIDTH, y = i / WIDTH;
+        bool articulation = false, bridge = false;
+        if (!rl_map_is_passable(map, x, y)) {
+            assert(rl_map_analysis_flags(analysis, x, y) == 0);
+            continue;
+        }
+        if (count_areas(map, i, -1, -1) > areas) articulation = true;
+        for (int dy = -1; dy <= 1; ++dy) {
+            for (int dx = -1; dx <= 1; ++dx) {
+                if ((dx == 0 && dy == 0) || !rl_map_is_passable(map, x + dx, y + dy)) continue;
+                if (count_areas(map, -1, i, (x + dx) + (y + dy) * WIDTH) > areas) bridge = true;
+            }
+        }
+        assert(articulation == !!(rl_map_analysis_flags(analysis, x, y) & RL_AnalysisArticulation));
+        assert(bridge == !!(rl_map_analysis_flags(analysis, x, y) & RL_AnalysisBridge));
+        articulations += articulation;
+        bridges += bridge;
+    }
+    printf("Matched %d articulation points & %d bridge ends in %d areas\n", articulations, bridges, areas);
+    rl_map_analysis_destroy(analysis);
+    rl_map_destroy(map);
+
+    /* two rooms joined by a corridor - the corridor is narrow with chokepoints on both ends */
+    map = rl_map_create(21, 9);
+    for (unsigned int y = 1; y < 8; ++y) {
+        for (unsigned int x = 1; x < 20; ++x) {
+            if (x < 7 || x > 13 || y == 4) map.tiles[x + y*map.width] = RL_TileRoom;
+        }
+    }
+    analysis = rl_map_analysis_create(21, 9);
+    assert(rl_map_analyze(analysis, map, 1) == RL_OK);
+    for (unsigned int y = 0; y < 9; ++y) {
+        for (unsigned int x = 0; x < 21; ++x) {
+            RL_Byte flags = rl_map_analysis_flags(analysis, x, y);
+            bool corridor = y == 4 && x >= 7 && x <= 13;
+            bool mouth = y == 4 && (x == 7 || x == 13);
+            assert(!!(flags & RL_AnalysisNarrow) == corridor);
+            assert(!!(flags & RL_AnalysisChokepoint) == mouth);
+            if (corridor) assert(flags & RL_AnalysisArticulation && flags & RL_AnalysisBridge);
+            printf("%c", mouth ? '+' : corridor ? '-' : flags ? '?' : (char) map.tiles[x + y*map.width]);
+        }
+        printf("\n");
+    }
+    assert(analysis.clearance[4 + 4*21] == 3);
+    rl_map_analysis_destroy(analysis);
+    rl_map_destroy(map);
+
+    /* large map */
+    map = rl_map_create(250, 250);
+    rl_mapgen_automata(map, config); /* unculled, so there are many separate areas */
+    analysis = rl_map_analysis_create(250, 250);
+    assert(rl_map_analyze(analysis, map, 1) == RL_OK);
+    int chokepoints = 0;
+    for (size_t i = 0; i < 250 * 250; ++i) {
+        if (analysis.flags[i] & RL_AnalysisChokepoint) chokepoints++;
+    }
+    printf("Analyzed 250x250 map (%d chokepoints)\n", chokepoints);
+    rl_map_analysis_destroy(analysis);
+    rl_map_destroy(map);
+
+    printf("Done\n");
+
+    return 0;
+}
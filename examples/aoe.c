@@ -0,0 +1,87 @@
+#define RL_IMPLEMENTATION
+#include "../roguelike.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <time.h>
+
+#define WIDTH 41
+#define HEIGHT 41
+#define MAX_RADIUS 10
+#define BLASTS 10000
+
+static bool contains(const RL_Point *tiles, size_t count, unsigned int x, unsigned int y)
+{
+    for (size_t i = 0; i < count; ++i) {
+        if (tiles[i].x == x && tiles[i].y == y) return true;
+    }
+
+    return false;
+}
+
+int main(void)
+{
+    static RL_Point tiles[WIDTH * HEIGHT];
+    RL_AoeTable aoe = rl_aoe_table_create(MAX_RADIUS);
+    assert(aoe.offsets != NULL);
+    RL_Map map = rl_map_create(WIDTH, HEIGHT);
+    memset(map.tiles, RL_TileRoom, WIDTH * HEIGHT);
+    RL_Point center = rl_point(20, 20);
+
+    /* open map - a blast hits every tile within radius, a cone those within the angle */
+    for (float radius = 0; radius <= MAX_RADIUS; radius += 2.5f) {
+        size_t blast = rl_aoe_blast(&aoe, map, center, radius, tiles, WIDTH * HEIGHT);
+        size_t expected = 0;
+        for (unsigned int y = 0; y < HEIGHT; ++y) {
+            for (unsigned int x = 0; x < WIDTH; ++x) {
+                if (rl_distance_euclidian(center, rl_point(x, y)) <= radius) {
+                    expected++;
+                    assert(contains(tiles, blast, x, y));
+                }
+            }
+        }
+        assert(blast == expected);
+        size_t cone = rl_aoe_cone(&aoe, map, center, rl_point(30, 20), radius, 0.5f, tiles, WIDTH * HEIGHT);
+        for (size_t i = 0; i < cone; ++i) {
+            float angle = atan2f(tiles[i].y - center.y, tiles[i].x - center.x);
+            assert(tiles[i].x > center.x && fabsf(angle) <= 0.5f);
+        }
+        printf("Radius %.1f: blast %zu tiles, cone %zu tiles\n", radius, blast, cone);
+    }
+
+    /* the buffer is never overrun */
+    assert(rl_aoe_blast(&aoe, map, center, MAX_RADIUS, tiles, 10) == 10);
+
+    /* a pillar shadows the tiles behind it, the pillar itself is hit */
+    map.tiles[23 + 20*WIDTH] = RL_TileRock;
+    size_t blast = rl_aoe_blast(&aoe, map, center, MAX_RADIUS, tiles, WIDTH * HEIGHT);
+    assert(contains(tiles, blast, 23, 20) && contains(tiles, blast, 22, 20));
+    for (unsigned int x = 24; x <= 30; ++x) {
+        assert(!contains(tiles, blast, x, 20));
+    }
+    assert(contains(tiles, blast, 17, 20) && contains(tiles, blast, 20, 30));
+
+    /* a beam stops before the wall */
+    size_t beam = rl_aoe_line(map, center, rl_point(21, 20), 20, tiles, WIDTH * HEIGHT);
+    assert(beam == 2 && tiles[0].x == 21 && tiles[1].x == 22);
+    beam = rl_aoe_line(map, center, rl_point(22, 21), 15, tiles, WIDTH * HEIGHT);
+    assert(beam == 15);
+    for (size_t i = 0; i < beam; ++i) {
+        assert(rl_distance_chebyshev(i ? tiles[i - 1] : center, tiles[i]) == 1);
+    }
+
+    /* many blasts at once */
+    clock_t start = clock();
+    size_t total = 0;
+    for (int i = 0; i < BLASTS; ++i) {
+        total += rl_aoe_blast(&aoe, map, rl_point(rand() % WIDTH, rand() % HEIGHT), 5, tiles, WIDTH * HEIGHT);
+    }
+    printf("%d blasts (%zu tiles) in %.3f ms\n", BLASTS, total, (double) (clock() - start) / CLOCKS_PER_SEC * 1000);
+
+    rl_aoe_table_destroy(aoe);
+    rl_map_destroy(map);
+
+    printf("Done\n");
+
+    return 0;
+}
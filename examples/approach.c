@@ -0,0 +1,76 @@
+#define RL_IMPLEMENTATION
+#include "../roguelike.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <time.h>
+
+#define WIDTH 80
+#define HEIGHT 30
+#define RANGE 6
+#define MONSTERS 20
+
+int main(void)
+{
+    srand(time(0));
+    RL_Map map = rl_map_create(WIDTH, HEIGHT);
+    if (rl_mapgen_automata(map, RL_MAPGEN_AUTOMATA_DEFAULTS) != RL_OK) {
+        fprintf(stderr, "Error during mapgen\n");
+        return 1;
+    }
+    unsigned int x, y;
+    rl_rng_map_passable(map, &x, &y);
+    RL_Point player = rl_point(x, y);
+
+    /* one approach graph shared by every monster */
+    clock_t start = clock();
+    RL_Graph approach = rl_graph_create_approach(map, player, RANGE);
+    printf("Built approach graph in %.3f ms\n", (double) (clock() - start) / CLOCKS_PER_SEC * 1000);
+    assert(approach.nodes != NULL);
+    RL_FOV fov = rl_fov_create(WIDTH, HEIGHT);
+    rl_fov_calculate(fov, map, player.x, player.y, RANGE);
+
+    /* seeds - tiles the player can see, 0 at range */
+    for (unsigned int ty = 0; ty < HEIGHT; ++ty) {
+        for (unsigned int tx = 0; tx < WIDTH; ++tx) {
+            float distance = rl_distance_euclidian(player, rl_point(tx, ty));
+            float score = approach.nodes[tx + ty*WIDTH].score;
+            if (rl_fov_is_visible(fov, tx, ty) && rl_map_is_passable(map, tx, ty) && distance > RANGE - 1 && distance <= RANGE) {
+                assert(score == 0);
+            }
+            if (score == 0) assert(rl_fov_is_visible(fov, tx, ty) && distance > RANGE - 1 && distance <= RANGE);
+            if (!rl_map_is_passable(map, tx, ty)) assert(score == FLT_MAX);
+        }
+    }
+
+    /* monsters walking down the graph stop at range with line of sight */
+    int in_position = 0;
+    for (int m = 0; m < MONSTERS; ++m) {
+        rl_rng_map_passable(map, &x, &y);
+        RL_GraphNode *node = rl_graph_node(approach, rl_point(x, y));
+        if (node->score == FLT_MAX) continue; /* the player can't be reached */
+        for (int step = 0; step < WIDTH * HEIGHT; ++step) {
+            RL_GraphNode *next = rl_graph_node_lowest_neighbor(approach, map, node);
+            if (next == NULL || next->score >= node->score) break;
+            node = next;
+        }
+        float distance = rl_distance_euclidian(player, node->point);
+        assert(rl_fov_is_visible(fov, node->point.x, node->point.y) && distance <= RANGE);
+        assert(node->score < RANGE);
+        if (node->score == 0) in_position++;
+    }
+    printf("%d of %d monsters stopped at range %d\n", in_position, MONSTERS, RANGE);
+
+    /* rescoring for a new target reuses the graph & FOV */
+    rl_rng_map_passable(map, &x, &y);
+    assert(rl_graph_score_approach(approach, fov, map, rl_point(x, y), RANGE) == RL_OK);
+    assert(rl_graph_node(approach, rl_point(x, y))->score > 0);
+
+    rl_fov_destroy(fov);
+    rl_graph_destroy(approach);
+    rl_map_destroy(map);
+
+    printf("Done\n");
+
+    return 0;
+}
@@ -0,0 +1,83 @@
+#define RL_IMPLEMENTATION
+#define _POSIX_C_SOURCE 199309L /* clock_gettime for the RL_CLOCK_US time budget */
+
+#include "../roguelike.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define WIDTH 80
+#define HEIGHT 30
+
+/* Generates an automata map a little at a time (e.g. once per frame), checking it matches rl_mapgen_automata. */
+int main(int argc, char **argv)
+{
+    unsigned long seed = time(0);
+    if (argc > 1) {
+        seed = atol(argv[1]);
+    }
+    printf("Seed: %ld\n", seed);
+
+    RL_Map map = rl_map_create(WIDTH, HEIGHT);
+    RL_Map expected = rl_map_create(WIDTH, HEIGHT);
+    srand(seed);
+    if (rl_mapgen_automata(expected, RL_MAPGEN_AUTOMATA_DEFAULTS) != RL_OK) {
+        fprintf(stderr, "Error during mapgen\n");
+        return 1;
+    }
+
+    /* same map when generated with the low level functions */
+    srand(seed);
+    rl_mapgen_automata_generate_rooms(map, 0, 0, WIDTH, HEIGHT, 45, 5, 4, 3, true);
+    rl_mapgen_connect_unconnected_rooms(map, false);
+    rl_mapgen_cull_unconnected_rooms(map);
+    assert(memcmp(map.tiles, expected.tiles, WIDTH * HEIGHT) == 0);
+
+    /* same map when generated in small steps */
+    RL_MapgenAutomata gen;
+    int steps = 0;
+    srand(seed);
+    memset(map.tiles, RL_TileRock, WIDTH * HEIGHT);
+    if (rl_mapgen_automata_begin(&gen, map, RL_MAPGEN_AUTOMATA_DEFAULTS) != RL_OK) {
+        fprintf(stderr, "Error during mapgen\n");
+        return 1;
+    }
+    while (!rl_mapgen_automata_step(&gen, 500)) {
+        steps++;
+    }
+    printf("Generated in %d steps\n", steps + 1);
+    assert(gen.status == RL_OK);
+    assert(gen.stage == RL_MapgenAutomataDone);
+    assert(memcmp(map.tiles, expected.tiles, WIDTH * HEIGHT) == 0);
+
+    /* time budget */
+    steps = 0;
+    srand(seed);
+    rl_mapgen_automata_begin(&gen, map, RL_MAPGEN_AUTOMATA_DEFAULTS);
+    while (!rl_mapgen_automata_step_us(&gen, 100)) {
+        steps++;
+    }
+    assert(gen.status == RL_OK);
+    assert(memcmp(map.tiles, expected.tiles, WIDTH * HEIGHT) == 0);
+
+    /* abandon generation part way through */
+    rl_mapgen_automata_begin(&gen, map, RL_MAPGEN_AUTOMATA_DEFAULTS);
+    while (!rl_mapgen_automata_step(&gen, 100) && gen.stage < RL_MapgenAutomataCullScan) {}
+    rl_mapgen_automata_end(&gen);
+
+    for (unsigned int y=0; y<map.height; ++y) {
+        for (unsigned int x=0; x<map.width; ++x) {
+            RL_Tile t = expected.tiles[x + y*map.width];
+            if (t == RL_TileRoom || t == RL_TileCorridor)
+                printf("%c", '.');
+            else
+                printf("%c", rl_map_is_wall(expected, x, y) ? '*' : ' ');
+        }
+        printf("\n");
+    }
+
+    rl_map_destroy(map);
+    rl_map_destroy(expected);
+
+    return 0;
+}
@@ -0,0 +1,278 @@
+/**
+ * Benchmark suite - times mapgen, pathfinding, FOV & file functions across map sizes with fixed seeds.
+ *
+ * Usage: ./benchmark [-j] [-a] [-s seed] [-m max_dimension] [-t seconds]
+ *
+ *  -j  output JSON instead of CSV
+ *  -a  run every benchmark at every map size (some mapgen functions take minutes on large maps)
+ *  -s  seed passed to srand before each benchmark (defaults to 1)
+ *  -m  skip map sizes with a width or height larger than this
+ *  -t  time budget per benchmark & map size in seconds (defaults to 1)
+ */
+#define _POSIX_C_SOURCE 199309L /* clock_gettime */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* count allocations made by the library */
+static size_t allocations;
+static size_t allocated_bytes;
+static void *bench_malloc(size_t size)
+{
+    allocations++;
+    allocated_bytes += size;
+    return malloc(size);
+}
+static void *bench_calloc(size_t count, size_t size)
+{
+    allocations++;
+    allocated_bytes += count * size;
+    return calloc(count, size);
+}
+static void *bench_realloc(void *ptr, size_t size)
+{
+    allocations++;
+    allocated_bytes += size;
+    return realloc(ptr, size);
+}
+#define RL_MALLOC bench_malloc
+#define RL_CALLOC bench_calloc
+#define RL_REALLOC bench_realloc
+
+#define RL_IMPLEMENTATION
+#include "../roguelike.h"
+
+#define MAX_SAMPLES 1000
+#define MIN_SAMPLES 3
+#define START_ATTEMPTS 8
+
+typedef struct {
+    unsigned int width;
+    unsigned int height;
+} Size;
+
+static const Size sizes[] = {
+    { 80, 25 },
+    { 256, 256 },
+    { 1024, 1024 },
+    { 4096, 4096 },
+};
+
+typedef struct {
+    RL_Map map;   /* pre-generated cave map for benchmarks that aren't mapgen */
+    RL_Map dest;  /* scratch map for mapgen */
+    unsigned int x, y;
+    RL_Graph reach; /* scored from x, y - path ends are picked from the same component */
+    FILE *file;
+} Context;
+
+typedef struct {
+    const char *name;
+    unsigned int max_dimension; /* default largest width/height to run (mapgen with corridors scales badly) */
+    void (*run)(Context *ctx);
+} Benchmark;
+
+static void bench_mapgen_bsp(Context *ctx)
+{
+    rl_mapgen_bsp(ctx->dest, RL_MAPGEN_BSP_DEFAULTS);
+}
+
+static void bench_mapgen_automata(Context *ctx)
+{
+    rl_mapgen_automata(ctx->dest, RL_MAPGEN_AUTOMATA_DEFAULTS);
+}
+
+static void bench_mapgen_automata_rooms(Context *ctx)
+{
+    RL_MapgenConfigAutomata config = RL_MAPGEN_AUTOMATA_DEFAULTS;
+    config.draw_corridors = false;
+    config.cull_unconnected = false;
+    rl_mapgen_automata(ctx->dest, config);
+}
+
+static void bench_mapgen_maze(Context *ctx)
+{
+    rl_mapgen_maze(ctx->dest);
+}
+
+static void bench_path_create(Context *ctx)
+{
+    unsigned int x = ctx->x, y = ctx->y;
+    do {
+        rl_rng_map_passable(ctx->map, &x, &y);
+    } while (ctx->reach.nodes[x + y*ctx->map.width].score == FLT_MAX);
+    rl_path_destroy(rl_path_create(ctx->map, rl_point(ctx->x, ctx->y), rl_point(x, y), NULL, NULL));
+}
+
+static void bench_graph_score(Context *ctx)
+{
+    RL_Graph graph = rl_graph_create_from_map(ctx->map, NULL);
+    rl_graph_score(graph, ctx->map, rl_point(ctx->x, ctx->y), NULL);
+    rl_graph_destroy(graph);
+}
+
+static void bench_fov_calculate(Context *ctx)
+{
+    RL_FOV fov = rl_fov_create(ctx->map.width, ctx->map.height);
+    rl_fov_calculate(fov, ctx->map, ctx->x, ctx->y, 16);
+    rl_fov_destroy(fov);
+}
+
+static void bench_file_map(Context *ctx)
+{
+    RL_Map loaded;
+    rewind(ctx->file);
+    rl_file_save_map(ctx->map, ctx->file);
+    rewind(ctx->file);
+    if (rl_file_load_map(&loaded, ctx->file)) {
+        rl_map_destroy(loaded);
+    }
+}
+
+static const Benchmark benchmarks[] = {
+    { "rl_mapgen_bsp",               256,  bench_mapgen_bsp },
+    { "rl_mapgen_automata",          256,  bench_mapgen_automata },
+    { "rl_mapgen_automata_no_cull",  4096, bench_mapgen_automata_rooms },
+    { "rl_mapgen_maze",              4096, bench_mapgen_maze },
+    { "rl_path_create",              4096, bench_path_create },
+    { "rl_graph_score",              4096, bench_graph_score },
+    { "rl_fov_calculate",            4096, bench_fov_calculate },
+    { "rl_file_map",                 4096, bench_file_map },
+};
+
+static double now_us(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1e6 + t.tv_nsec / 1e3;
+}
+
+static int compare_double(const void *a, const void *b)
+{
+    double da = *(const double*) a, db = *(const double*) b;
+    return (da > db) - (da < db);
+}
+
+/* nearest-rank percentile of sorted samples */
+static double percentile(const double *samples, int count, double p)
+{
+    int rank = (int) (p / 100.0 * count + 0.5);
+    if (rank < 1) rank = 1;
+    if (rank > count) rank = count;
+    return samples[rank - 1];
+}
+
+int main(int argc, char **argv)
+{
+    static double samples[MAX_SAMPLES];
+    bool json = false, all = false, first = true;
+    unsigned int seed = 1, max_dimension = 0;
+    double budget_us = 1e6;
+    size_t b, s;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "-j") == 0) json = true;
+        else if (strcmp(argv[i], "-a") == 0) all = true;
+        else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) seed = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc) max_dimension = atoi(argv[++i]);
+        else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) budget_us = atof(argv[++i]) * 1e6;
+        else {
+            fprintf(stderr, "Usage: %s [-j] [-a] [-s seed] [-m max_dimension] [-t seconds]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (json) printf("[\n");
+    else printf("name,width,height,samples,median_us,p90_us,p99_us,min_us,max_us,allocations,allocated_bytes\n");
+
+    for (s = 0; s < sizeof(sizes) / sizeof(*sizes); ++s) {
+        Context ctx;
+        RL_MapgenConfigAutomata config = RL_MAPGEN_AUTOMATA_DEFAULTS;
+        Size size = sizes[s];
+        if (max_dimension && (size.width > max_dimension || size.height > max_dimension)) continue;
+
+        /* pre-generate a cave map (corridors & culling are too slow on large maps) */
+        srand(seed);
+        ctx.map = rl_map_create(size.width, size.height);
+        ctx.dest = rl_map_create(size.width, size.height);
+        ctx.file = tmpfile();
+        config.draw_corridors = false;
+        config.cull_unconnected = false;
+        ctx.reach.nodes = NULL;
+        if (ctx.file == NULL || rl_mapgen_automata(ctx.map, config) != RL_OK) {
+            fprintf(stderr, "Error setting up %ux%u benchmarks\n", size.width, size.height);
+            return 1;
+        }
+        /* caves aren't culled, so start from the largest of a few random components */
+        for (int attempt = 0, best = 0; attempt < START_ATTEMPTS; ++attempt) {
+            unsigned int x = 0, y = 0;
+            int reached = 0;
+            RL_Graph reach;
+            if (rl_rng_map_passable(ctx.map, &x, &y) != RL_OK) break;
+            reach = rl_graph_create_scored(ctx.map, rl_point(x, y), NULL, NULL);
+            if (reach.nodes == NULL) break;
+            for (size_t i = 0; i < reach.length; ++i) {
+                if (reach.nodes[i].score != FLT_MAX) reached++;
+            }
+            if (reached > best) {
+                if (ctx.reach.nodes) rl_graph_destroy(ctx.reach);
+                ctx.reach = reach;
+                ctx.x = x;
+                ctx.y = y;
+                best = reached;
+            } else {
+                rl_graph_destroy(reach);
+            }
+        }
+        if (ctx.reach.nodes == NULL) {
+            fprintf(stderr, "Error setting up %ux%u benchmarks\n", size.width, size.height);
+            return 1;
+        }
+
+        for (b = 0; b < sizeof(benchmarks) / sizeof(*benchmarks); ++b) {
+            const Benchmark *bench = &benchmarks[b];
+            size_t start_allocations, start_bytes;
+            double total_us = 0;
+            int count = 0;
+            if (!all && (size.width > bench->max_dimension || size.height > bench->max_dimension)) continue;
+
+            srand(seed);
+            start_allocations = allocations;
+            start_bytes = allocated_bytes;
+            while (count < MAX_SAMPLES && (count < MIN_SAMPLES || total_us < budget_us)) {
+                double start = now_us();
+                bench->run(&ctx);
+                samples[count] = now_us() - start;
+                total_us += samples[count++];
+            }
+            qsort(samples, count, sizeof(*samples), compare_double);
+
+            if (json) {
+                printf("%s  {\"name\": \"%s\", \"width\": %u, \"height\": %u, \"samples\": %d, \"median_us\": %.2f, "
+                       "\"p90_us\": %.2f, \"p99_us\": %.2f, \"min_us\": %.2f, \"max_us\": %.2f, \"allocations\": %.1f, "
+                       "\"allocated_bytes\": %.1f}",
+                       first ? "" : ",\n", bench->name, size.width, size.height, count, percentile(samples, count, 50),
+                       percentile(samples, count, 90), percentile(samples, count, 99), samples[0], samples[count - 1],
+                       (double) (allocations - start_allocations) / count, (double) (allocated_bytes - start_bytes) / count);
+            } else {
+                printf("%s,%u,%u,%d,%.2f,%.2f,%.2f,%.2f,%.2f,%.1f,%.1f\n",
+                       bench->name, size.width, size.height, count, percentile(samples, count, 50),
+                       percentile(samples, count, 90), percentile(samples, count, 99), samples[0], samples[count - 1],
+                       (double) (allocations - start_allocations) / count, (double) (allocated_bytes - start_bytes) / count);
+            }
+            fflush(stdout);
+            first = false;
+        }
+
+        fclose(ctx.file);
+        rl_graph_destroy(ctx.reach);
+        rl_map_destroy(ctx.map);
+        rl_map_destroy(ctx.dest);
+    }
+
+    if (json) printf("\n]\n");
+
+    return 0;
+}
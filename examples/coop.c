@@ -0,0 +1,151 @@
+#define RL_IMPLEMENTATION
+#include "../roguelike.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <time.h>
+
+#define GROUP_SIZE 6
+#define AGENT_COUNT 24
+#define WINDOW 8
+#define MAX_TURNS 300
+
+/* moves every agent one turn, checking no two agents share a tile or swap places */
+static int step(RL_Coop *coop, RL_Point *positions, const RL_Point *goals, size_t count)
+{
+    RL_Point next[AGENT_COUNT];
+    int arrived = 0;
+    for (size_t i = 0; i < count; ++i) {
+        rl_coop_set_agent(coop, i, positions[i], goals[i]);
+    }
+    assert(rl_coop_plan(coop) == RL_OK);
+    for (size_t i = 0; i < count; ++i) {
+        next[i] = rl_coop_next(coop, i);
+        assert(RL_PASSABLE_F(coop->map, next[i].x, next[i].y));
+        assert(rl_distance_chebyshev(positions[i], next[i]) <= 1);
+    }
+    for (size_t i = 0; i < count; ++i) {
+        for (size_t j = i + 1; j < count; ++j) {
+            assert(next[i].x != next[j].x || next[i].y != next[j].y);
+            assert(!(next[i].x == positions[j].x && next[i].y == positions[j].y &&
+                     next[j].x == positions[i].x && next[j].y == positions[i].y));
+        }
+    }
+    for (size_t i = 0; i < count; ++i) {
+        positions[i] = next[i];
+        if (positions[i].x == goals[i].x && positions[i].y == goals[i].y) arrived++;
+    }
+
+    return arrived;
+}
+
+int main(int argc, char **argv)
+{
+    RL_Point positions[AGENT_COUNT], goals[AGENT_COUNT];
+    int turn, arrived = 0;
+    unsigned long seed = time(0);
+    if (argc > 1) {
+        seed = atol(argv[1]);
+    }
+    printf("Seed: %lu\n", seed);
+    srand(seed);
+
+    /* a column of agents through a 1 wide corridor, then two groups swapping rooms through a 3 wide corridor */
+    for (int lanes = 1; lanes <= 3; lanes += 2) {
+        RL_Map map = rl_map_create(30, 11);
+        for (unsigned int y = 1; y < 10; ++y) {
+            for (unsigned int x = 1; x < 29; ++x) {
+                if (x < 7 || x > 22 || (y >= 5 && y < 5 + (unsigned int) lanes)) map.tiles[x + y*map.width] = RL_TileRoom;
+            }
+        }
+        for (int i = 0; i < GROUP_SIZE; ++i) {
+            positions[i] = rl_point(2 + i % 3, 2 + i / 3);
+            goals[i] = rl_point(24 + i % 3, 2 + i / 3);
+            if (lanes == 1) {
+                positions[GROUP_SIZE + i] = rl_point(2 + i % 3, 7 + i / 3);
+                goals[GROUP_SIZE + i] = rl_point(24 + i % 3, 7 + i / 3);
+            } else {
+                positions[GROUP_SIZE + i] = goals[i];
+                goals[GROUP_SIZE + i] = positions[i];
+            }
+        }
+        RL_Coop *coop = rl_coop_create(map, GROUP_SIZE * 2, WINDOW, NULL);
+        assert(coop != NULL);
+        arrived = 0;
+        for (turn = 0; turn < MAX_TURNS && arrived < GROUP_SIZE * 2; ++turn) {
+            arrived = step(coop, positions, goals, GROUP_SIZE * 2);
+        }
+        printf("%d agents through a %d wide corridor in %d turns\n", arrived, lanes, turn);
+        assert(arrived == GROUP_SIZE * 2);
+        rl_coop_destroy(coop);
+        rl_map_destroy(map);
+    }
+
+    /* random goals in a cave */
+    RL_Map map = rl_map_create(60, 30);
+    if (rl_mapgen_automata(map, RL_MAPGEN_AUTOMATA_DEFAULTS) != RL_OK) {
+        fprintf(stderr, "Error during mapgen\n");
+        return 1;
+    }
+    for (int i = 0; i < AGENT_COUNT; ++i) {
+        unsigned int x, y;
+        bool taken;
+        do {
+            rl_rng_map_passable(map, &x, &y);
+            taken = false;
+            for (int j = 0; j < i; ++j) {
+                if (positions[j].x == x && positions[j].y == y) taken = true;
+            }
+        } while (taken);
+        positions[i] = rl_point(x, y);
+        do {
+            rl_rng_map_passable(map, &x, &y);
+            taken = false;
+            for (int j = 0; j < i; ++j) {
+                if (goals[j].x == x && goals[j].y == y) taken = true;
+            }
+        } while (taken);
+        goals[i] = rl_point(x, y);
+    }
+    RL_Coop *coop = rl_coop_create(map, AGENT_COUNT, WINDOW, NULL);
+    assert(coop != NULL);
+    arrived = 0;
+    for (turn = 0; turn < MAX_TURNS && arrived < AGENT_COUNT; ++turn) {
+        arrived = step(coop, positions, goals, AGENT_COUNT);
+    }
+    printf("%d of %d agents arrived in %d turns\n", arrived, AGENT_COUNT, turn);
+    rl_coop_destroy(coop);
+
+    /* a group chasing a goal that moves every turn shares one heuristic, which is exact where it has been scored */
+    RL_Graph dijkstra = rl_graph_create(map.width, map.height, NULL);
+    RL_Point target;
+    {
+        unsigned int x, y;
+        rl_rng_map_passable(map, &x, &y);
+        target = rl_point(x, y);
+    }
+    coop = rl_coop_create(map, GROUP_SIZE, WINDOW, NULL);
+    assert(coop != NULL);
+    for (turn = 0; turn < 50; ++turn) {
+        RL_Point goals_now[GROUP_SIZE];
+        for (int i = 0; i < GROUP_SIZE; ++i) goals_now[i] = target;
+        step(coop, positions, goals_now, GROUP_SIZE);
+        assert(coop->heuristics_len == 1);
+        rl_graph_score(dijkstra, map, target, NULL);
+        const RL_CoopHeuristic *h = &coop->heuristics[0];
+        for (size_t i = 0; i < dijkstra.length; ++i) {
+            if (h->closed[i]) assert(fabs(h->graph.nodes[i].score - dijkstra.nodes[i].score) < 0.01f);
+        }
+        /* the target wanders */
+        unsigned int x = target.x + rl_rng_generate(0, 2) - 1, y = target.y + rl_rng_generate(0, 2) - 1;
+        if (RL_PASSABLE_F(map, x, y)) target = rl_point(x, y);
+    }
+    printf("%d agents chased a moving goal for %d turns\n", GROUP_SIZE, turn);
+    rl_coop_destroy(coop);
+    rl_graph_destroy(dijkstra);
+    rl_map_destroy(map);
+
+    printf("Done\n");
+
+    return 0;
+}
@@ -0,0 +1,145 @@
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <vector>
+
+#include "../roguelike_coro.hpp"
+
+#define WIDTH 80
+#define HEIGHT 30
+#define FOV_COUNT 40
+
+/* Awaits the search task from another coroutine - the search resumes this coroutine when it finishes. */
+static rl::Task<int> find_path(rl::ManualExecutor &executor, RL_Map map, RL_Point start, RL_Point end)
+{
+    int length = 0;
+    RL_Path *path = co_await rl::search(executor, map, start, end, {}, 16);
+    if (path == nullptr) co_return -1;
+    while ((path = rl_path_walk(path))) length++;
+
+    co_return length;
+}
+
+/* Runs the executor until the task is done, returns the count of resumed slices. */
+template <typename T>
+static int run(rl::ManualExecutor &executor, rl::Task<T> &task)
+{
+    int slices = 0;
+    task.start();
+    while (!task.done() && executor.run_one()) slices++;
+
+    return slices;
+}
+
+/* Checks the coroutine tasks match the C API on the same map. Linked with the C implementation (roguelike.o). */
+int main()
+{
+    unsigned int seed = time(0);
+    rl::ManualExecutor executor;
+
+    /* automata task generates the same map as rl_mapgen_automata */
+    RL_Map map = rl_map_create(WIDTH, HEIGHT);
+    RL_Map c_map = rl_map_create(WIDTH, HEIGHT);
+    srand(seed);
+    rl::Task<RL_Status> generate = rl::generate_automata(executor, map, RL_MAPGEN_AUTOMATA_DEFAULTS, {}, 256);
+    int slices = run(executor, generate);
+    assert(generate.done() && generate.result() == RL_OK);
+    srand(seed);
+    rl_mapgen_automata(c_map, RL_MAPGEN_AUTOMATA_DEFAULTS);
+    assert(memcmp(map.tiles, c_map.tiles, WIDTH * HEIGHT) == 0);
+    printf("Generated map in %d slices\n", slices);
+
+    /* cancelling stops the task at the next slice */
+    std::stop_source stop;
+    rl::Task<RL_Status> cancelled = rl::generate_automata(executor, c_map, RL_MAPGEN_AUTOMATA_DEFAULTS, stop.get_token(), 16);
+    cancelled.start();
+    executor.run_one();
+    stop.request_stop();
+    executor.run();
+    assert(cancelled.done() && cancelled.result() == RL_ErrorCancelled);
+
+    /* destroying suspended tasks frees their library memory (check with -fsanitize=address) */
+    {
+        unsigned int x, y;
+        rl_rng_map_passable(map, &x, &y);
+        rl::Task<RL_Path*> suspended_search = rl::search(executor, map, rl_point(x, y), rl_point(WIDTH - x, HEIGHT - y), {}, 1);
+        rl::Task<RL_Status> suspended_generate = rl::generate_automata(executor, c_map, RL_MAPGEN_AUTOMATA_DEFAULTS, {}, 16);
+        suspended_search.start();
+        suspended_generate.start();
+        assert(!suspended_search.done() && !suspended_generate.done());
+        executor.clear(); /* the tasks are destroyed while scheduled, so they must never be resumed */
+    }
+
+    /* score task matches rl_graph_score */
+    unsigned int sx, sy, ex, ey;
+    rl_rng_map_passable(map, &sx, &sy);
+    rl_rng_map_passable(map, &ex, &ey);
+    RL_Graph graph = rl_graph_create(WIDTH, HEIGHT, NULL);
+    RL_Graph c_graph = rl_graph_create(WIDTH, HEIGHT, NULL);
+    rl::Task<RL_Status> score = rl::score(executor, graph, map, rl_point(sx, sy), nullptr, {}, 64);
+    slices = run(executor, score);
+    assert(score.done() && score.result() == RL_OK);
+    rl_graph_score(c_graph, map, rl_point(sx, sy), NULL);
+    for (size_t i = 0; i < graph.length; ++i) {
+        assert(std::fabs(graph.nodes[i].score - c_graph.nodes[i].score) < 0.01f);
+    }
+    printf("Scored graph in %d slices\n", slices);
+
+    /* a stopped token cancels before the first slice */
+    rl::Task<RL_Status> stopped = rl::score(executor, graph, map, rl_point(ex, ey), nullptr, stop.get_token(), 64);
+    stopped.start();
+    assert(stopped.done() && stopped.result() == RL_ErrorCancelled && executor.empty());
+    for (size_t i = 0; i < graph.length; ++i) {
+        assert(graph.nodes[i].score == c_graph.nodes[i].score); /* untouched */
+    }
+
+    /* search task can be awaited from another coroutine */
+    rl::Task<int> path = find_path(executor, map, rl_point(sx, sy), rl_point(ex, ey));
+    slices = run(executor, path);
+    assert(path.done() && path.result() >= 0);
+    printf("Path length %d in %d slices\n", path.result(), slices);
+
+    /* FOV batch matches rl_fov_calculate */
+    std::vector<RL_FOV> fovs;
+    std::vector<RL_Point> origins;
+    for (int i = 0; i < FOV_COUNT; ++i) {
+        unsigned int x, y;
+        rl_rng_map_passable(map, &x, &y);
+        fovs.push_back(rl_fov_create(WIDTH, HEIGHT));
+        origins.push_back(rl_point(x, y));
+    }
+    rl::Task<RL_Status> fov = rl::fov_batch(executor, map, std::span<RL_FOV>(fovs), std::span<const RL_Point>(origins), 8, {}, 8);
+    slices = run(executor, fov);
+    assert(fov.done() && fov.result() == RL_OK);
+    RL_FOV c_fov = rl_fov_create(WIDTH, HEIGHT);
+    for (int i = 0; i < FOV_COUNT; ++i) {
+        rl_fov_calculate(c_fov, map, origins[i].x, origins[i].y, 8);
+        for (unsigned int y = 0; y < HEIGHT; ++y) {
+            for (unsigned int x = 0; x < WIDTH; ++x) {
+                assert(rl_fov_is_visible(fovs[i], x, y) == rl_fov_is_visible(c_fov, x, y));
+            }
+        }
+        rl_fov_destroy(fovs[i]);
+    }
+    printf("Calculated %d FOVs in %d slices\n", FOV_COUNT, slices);
+
+    /* zero budgets are clamped to 1 instead of never progressing (or dividing by zero) */
+    RL_FOV zero_fovs[] = { c_fov, c_fov };
+    rl::Task<RL_Status> zero_fov = rl::fov_batch(executor, map, std::span<RL_FOV>(zero_fovs), std::span<const RL_Point>(origins.data(), 2), 8, {}, 0);
+    rl::Task<RL_Status> zero_score = rl::score(executor, graph, map, rl_point(sx, sy), nullptr, {}, 0);
+    run(executor, zero_fov);
+    run(executor, zero_score);
+    assert(zero_fov.result() == RL_OK && zero_score.result() == RL_OK);
+
+    rl_fov_destroy(c_fov);
+    rl_graph_destroy(graph);
+    rl_graph_destroy(c_graph);
+    rl_map_destroy(map);
+    rl_map_destroy(c_map);
+
+    printf("Done\n");
+
+    return 0;
+}
@@ -0,0 +1,89 @@
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+
+#include "../roguelike.hpp"
+
+#define WIDTH 80
+#define HEIGHT 30
+
+/* Compares the C++ template layer with the C API on the same map. Linked with the C implementation (roguelike.o). */
+int main()
+{
+    srand(time(0));
+
+    rl::Map map(WIDTH, HEIGHT);
+    if (!map || rl_mapgen_bsp(map, RL_MAPGEN_BSP_DEFAULTS) != RL_OK) {
+        fprintf(stderr, "Error during mapgen\n");
+        return 1;
+    }
+    unsigned int sx, sy, ex, ey;
+    rl_rng_map_passable(map, &sx, &sy);
+    rl_rng_map_passable(map, &ex, &ey);
+
+    /* dijkstra with the default cost matches rl_graph_score */
+    rl::Graph graph(WIDTH, HEIGHT);
+    rl::Graph c_graph(WIDTH, HEIGHT);
+    rl::dijkstra<rl::Ordinal>(graph, rl_point(sx, sy), rl::PassableCost(map));
+    rl_graph_score(c_graph, map, rl_point(sx, sy), NULL);
+    for (unsigned int y = 0; y < HEIGHT; ++y) {
+        for (unsigned int x = 0; x < WIDTH; ++x) {
+            assert(graph.is_scored(x, y) == c_graph.is_scored(x, y));
+            assert(!graph.is_scored(x, y) || std::fabs(graph.score(x, y) - c_graph.score(x, y)) < 0.01f);
+        }
+    }
+
+    /* the C API can walk the graph scored in C++ */
+    RL_Path *path = rl_path_create_from_graph(graph, map, rl_point(ex, ey));
+    assert(path != NULL);
+    int c_length = 0;
+    while ((path = rl_path_walk(path))) c_length++;
+
+    /* A* finds a path as short as Dijkstra */
+    std::vector<RL_Point> astar_path = rl::astar<rl::Ordinal>(graph, rl_point(sx, sy), rl_point(ex, ey), rl::PassableCost(map));
+    assert(!astar_path.empty());
+    assert(astar_path.front().x == sx && astar_path.front().y == sy);
+    assert(astar_path.back().x == ex && astar_path.back().y == ey);
+    assert(std::fabs(graph.score(ex, ey) - c_graph.score(ex, ey)) < 0.01f);
+    printf("Path length: %d (C), %zu (A*)\n", c_length, astar_path.size() - 1);
+
+    /* lambdas are inlined - only walk on room tiles with cardinal movement */
+    rl::dijkstra<rl::Cardinal>(graph, rl_point(sx, sy), [&map](unsigned int, unsigned int, unsigned int x, unsigned int y) {
+        return map(x, y) == RL_TileRoom ? 1.0f : rl::unreachable;
+    });
+    unsigned int room_tiles = 0;
+    for (unsigned int y = 0; y < HEIGHT; ++y) {
+        for (unsigned int x = 0; x < WIDTH; ++x) {
+            if (graph.is_scored(x, y)) {
+                assert(map(x, y) == RL_TileRoom || (x == sx && y == sy));
+                room_tiles++;
+            }
+        }
+    }
+    printf("Room tiles reachable from start: %u\n", room_tiles);
+
+    /* templated FOV matches rl_fov_calculate */
+    rl::FOV fov(WIDTH, HEIGHT);
+    rl::FOV c_fov(WIDTH, HEIGHT);
+    for (int radius = -1; radius < 12; radius += 4) {
+        RL_Status status = rl::fov(fov, map, sx, sy, radius);
+        assert(status == rl_fov_calculate(c_fov, map, sx, sy, radius));
+        for (unsigned int y = 0; y < HEIGHT; ++y) {
+            for (unsigned int x = 0; x < WIDTH; ++x) {
+                assert(fov.visible(x, y) == c_fov.visible(x, y));
+                assert(fov.seen(x, y) == c_fov.seen(x, y));
+            }
+        }
+    }
+
+    /* wrappers are movable & release the C structs */
+    rl::BSP bsp(WIDTH, HEIGHT);
+    rl::BSP moved = std::move(bsp);
+    assert(!bsp && moved);
+    rl_bsp_split(moved, WIDTH / 2, RL_SplitHorizontally);
+    assert(rl_bsp_leaf_count(moved) == 2);
+
+    printf("Done\n");
+
+    return 0;
+}
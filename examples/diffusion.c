@@ -0,0 +1,133 @@
+#define RL_IMPLEMENTATION
+#include "../roguelike.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <time.h>
+
+#define WIDTH 80
+#define HEIGHT 30
+#define STEPS 50
+#define BENCH_SIZE 500
+#define BENCH_SOURCES 300
+
+/* per tile loop - what the stencil replaces */
+static void naive_step(const RL_Map map, float *values, float *out, float rate, float decay, bool diagonal)
+{
+    for (unsigned int y = 0; y < map.height; ++y) {
+        for (unsigned int x = 0; x < map.width; ++x) {
+            float v = values[x + y*map.width], sum = 0;
+            int open = 0;
+            out[x + y*map.width] = 0;
+            if (!rl_map_is_passable(map, x, y)) continue;
+            for (int dy = -1; dy <= 1; ++dy) {
+                for (int dx = -1; dx <= 1; ++dx) {
+                    if ((dx == 0 && dy == 0) || (!diagonal && dx && dy)) continue;
+                    if (!rl_map_is_passable(map, x + dx, y + dy)) continue;
+                    sum += values[x + dx + (y + dy)*map.width];
+                    open++;
+                }
+            }
+            out[x + y*map.width] = decay * (v + rate / (diagonal ? 8 : 4) * (sum - open * v));
+        }
+    }
+    memcpy(values, out, sizeof(*values) * map.width * map.height);
+}
+
+static float total(const RL_Diffusion *diffusion)
+{
+    float sum = 0;
+    for (unsigned int y = 0; y < diffusion->height; ++y) {
+        for (unsigned int x = 0; x < diffusion->width; ++x) {
+            sum += rl_diffusion_value(diffusion, x, y);
+        }
+    }
+
+    return sum;
+}
+
+int main(int argc, char **argv)
+{
+    static float values[WIDTH * HEIGHT], out[WIDTH * HEIGHT];
+    unsigned long seed = time(0);
+    if (argc > 1) {
+        seed = atol(argv[1]);
+    }
+    printf("Seed: %lu\n", seed);
+    srand(seed);
+    RL_Map map = rl_map_create(WIDTH, HEIGHT);
+    if (rl_mapgen_automata(map, RL_MAPGEN_AUTOMATA_DEFAULTS) != RL_OK) {
+        fprintf(stderr, "Error during mapgen\n");
+        return 1;
+    }
+
+    /* stencil matches the per tile loop, with 4 & 8 neighbors */
+    for (int diagonal = 0; diagonal <= 1; ++diagonal) {
+        RL_Diffusion *diffusion = rl_diffusion_create(map);
+        assert(diffusion != NULL);
+        memset(values, 0, sizeof(values));
+        for (int step = 0; step < STEPS; ++step) {
+            unsigned int x, y;
+            rl_rng_map_passable(map, &x, &y);
+            rl_diffusion_add(diffusion, x, y, 100);
+            values[x + y*WIDTH] += 100;
+            assert(rl_diffusion_step(diffusion, 0.8f, 0.97f, diagonal, NULL) == RL_OK);
+            naive_step(map, values, out, 0.8f, 0.97f, diagonal);
+        }
+        for (unsigned int y = 0; y < HEIGHT; ++y) {
+            for (unsigned int x = 0; x < WIDTH; ++x) {
+                assert(fabsf(rl_diffusion_value(diffusion, x, y) - values[x + y*WIDTH]) < 0.01f);
+                if (!rl_map_is_passable(map, x, y)) assert(rl_diffusion_value(diffusion, x, y) == 0);
+            }
+        }
+
+        /* nothing is lost without decay */
+        float before = total(diffusion);
+        rl_diffusion_step(diffusion, 1, 1, diagonal, NULL);
+        assert(fabsf(total(diffusion) - before) < before * 0.001f);
+        rl_diffusion_destroy(diffusion);
+    }
+    printf("Stencil matched per tile diffusion\n");
+
+    /* a closed door blocks the scent until opened, the region of interest leaves the rest of the field as is */
+    RL_Map rooms = rl_map_create(21, 5);
+    for (unsigned int y = 1; y < 4; ++y) {
+        for (unsigned int x = 1; x < 20; ++x) {
+            if (x != 10) rooms.tiles[x + y*rooms.width] = RL_TileRoom;
+        }
+    }
+    RL_Diffusion *diffusion = rl_diffusion_create(rooms);
+    for (int step = 0; step < 20; ++step) {
+        rl_diffusion_add(diffusion, 2, 2, 10);
+        rl_diffusion_step(diffusion, 1, 1, true, NULL);
+    }
+    assert(rl_diffusion_value(diffusion, 9, 2) > 0 && rl_diffusion_value(diffusion, 11, 2) == 0);
+    rl_diffusion_set_passable(diffusion, 10, 2, true);
+    RL_Rect right = { 10, 0, 11, 5 };
+    float left_value = rl_diffusion_value(diffusion, 5, 2);
+    for (int step = 0; step < 20; ++step) {
+        rl_diffusion_step(diffusion, 1, 1, true, &right);
+    }
+    assert(rl_diffusion_value(diffusion, 11, 2) > 0 && rl_diffusion_value(diffusion, 5, 2) == left_value);
+    rl_diffusion_destroy(diffusion);
+    rl_map_destroy(rooms);
+
+    /* many sources on a large map */
+    rl_map_destroy(map);
+    map = rl_map_create(BENCH_SIZE, BENCH_SIZE);
+    memset(map.tiles, RL_TileRoom, BENCH_SIZE * BENCH_SIZE);
+    diffusion = rl_diffusion_create(map);
+    for (int step = 0; step < 10; ++step) {
+        for (int i = 0; i < BENCH_SOURCES; ++i) {
+            rl_diffusion_add(diffusion, rand() % BENCH_SIZE, rand() % BENCH_SIZE, 10);
+        }
+        rl_diffusion_step(diffusion, 0.5f, 0.95f, true, NULL);
+    }
+    printf("Stepped a %dx%d field with %d sources\n", BENCH_SIZE, BENCH_SIZE, BENCH_SOURCES);
+    rl_diffusion_destroy(diffusion);
+    rl_map_destroy(map);
+
+    printf("Done\n");
+
+    return 0;
+}
@@ -0,0 +1,122 @@
+#define RL_IMPLEMENTATION
+#include "../roguelike.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <time.h>
+
+#define WIDTH 80
+#define HEIGHT 30
+#define FOV_RADIUS 6
+#define MAX_STEPS 5000
+
+static RL_FOV fov;
+
+/* naive autoexplore - neighbors limited to the tiles seen so far */
+static size_t known_neighbors(void *context, RL_Point point, RL_GraphNode **neighbors)
+{
+    size_t count = rl_graph_neighbors_ordinal_passable(context, point, neighbors), known = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (fov.visibility[(size_t) neighbors[i]->point.x + (size_t) neighbors[i]->point.y*WIDTH] != RL_TileCannotSee) {
+            neighbors[known++] = neighbors[i];
+        }
+    }
+
+    return known;
+}
+
+static bool is_known(unsigned int x, unsigned int y)
+{
+    return rl_fov_is_visible(fov, x, y) || rl_fov_is_seen(fov, x, y);
+}
+
+/* naive autoexplore - scan every tile for the frontier & return the distance to the nearest one */
+static float naive_distance(RL_Map map, RL_Graph graph, RL_Point player, size_t *frontier_length)
+{
+    float nearest = FLT_MAX;
+    *frontier_length = 0;
+    rl_graph_score(graph, map, player, NULL);
+    for (unsigned int y = 0; y < HEIGHT; ++y) {
+        for (unsigned int x = 0; x < WIDTH; ++x) {
+            bool frontier = false;
+            if (!is_known(x, y) || !rl_map_is_passable(map, x, y)) continue;
+            for (int dy = -1; dy <= 1; ++dy) {
+                for (int dx = -1; dx <= 1; ++dx) {
+                    if (rl_map_in_bounds(map, x + dx, y + dy) && !is_known(x + dx, y + dy) && rl_map_is_passable(map, x + dx, y + dy)) {
+                        frontier = true;
+                    }
+                }
+            }
+            if (frontier) {
+                (*frontier_length)++;
+                if (graph.nodes[x + y*WIDTH].score < nearest) nearest = graph.nodes[x + y*WIDTH].score;
+            }
+        }
+    }
+
+    return nearest;
+}
+
+int main(int argc, char **argv)
+{
+    unsigned long seed = time(0);
+    if (argc > 1) {
+        seed = atol(argv[1]);
+    }
+    printf("Seed: %lu\n", seed);
+    srand(seed);
+    RL_Map map = rl_map_create(WIDTH, HEIGHT);
+    if (rl_mapgen_automata(map, RL_MAPGEN_AUTOMATA_DEFAULTS) != RL_OK) {
+        fprintf(stderr, "Error during mapgen\n");
+        return 1;
+    }
+    fov = rl_fov_create(WIDTH, HEIGHT);
+    RL_Explore *explore = rl_explore_create(map, fov, NULL, NULL);
+    assert(explore != NULL);
+    RL_Graph graph = rl_graph_create(WIDTH, HEIGHT, known_neighbors);
+    unsigned int x, y;
+    rl_rng_map_passable(map, &x, &y);
+    RL_Point start = rl_point(x, y), player = start;
+
+    /* walk to the nearest frontier until the map is explored, checking against the naive version each step */
+    int steps;
+    for (steps = 0; steps < MAX_STEPS; ++steps) {
+        size_t frontier_length;
+        RL_Point next;
+        rl_fov_calculate(fov, map, player.x, player.y, FOV_RADIUS);
+        assert(rl_explore_update(explore, player.x, player.y, FOV_RADIUS) == RL_OK);
+        RL_Status status = rl_explore_next(explore, player, &next);
+        float distance = naive_distance(map, graph, player, &frontier_length);
+        assert(explore->frontier_length == frontier_length);
+        if (status == RL_ErrorNotFound) {
+            assert(distance == FLT_MAX);
+            break;
+        }
+        assert(status == RL_OK);
+        if (distance > 0) {
+            assert(fabs(explore->graph.nodes[(size_t) player.x + (size_t) player.y*WIDTH].score - distance) < 0.01);
+        }
+        assert(rl_distance_chebyshev(player, next) == 1 && rl_map_is_passable(map, next.x, next.y));
+        player = next;
+    }
+    printf("Explored in %d steps\n", steps);
+    assert(steps < MAX_STEPS);
+
+    /* every tile reachable from the start has been seen */
+    RL_Graph reachable = rl_graph_create_scored(map, start, NULL, NULL);
+    for (unsigned int ty = 0; ty < HEIGHT; ++ty) {
+        for (unsigned int tx = 0; tx < WIDTH; ++tx) {
+            if (reachable.nodes[tx + ty*WIDTH].score < FLT_MAX) assert(is_known(tx, ty));
+        }
+    }
+    rl_graph_destroy(reachable);
+
+    rl_graph_destroy(graph);
+    rl_explore_destroy(explore);
+    rl_fov_destroy(fov);
+    rl_map_destroy(map);
+
+    printf("Done\n");
+
+    return 0;
+}
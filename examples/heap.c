@@ -54,6 +54,36 @@ int main(void)
 
     rl_heap_destroy(q);
 
+    printf("Done\n\n");
+
+    /* bulk insert & heapify - ensure order is preserved with many items */
+    TestNode bulk_nodes[1000];
+    void *bulk_items[1000];
+    for (int i = 0; i < 1000; ++i) {
+        bulk_nodes[i].priority = rand() % 500;
+        bulk_nodes[i].name = "Bulk";
+        bulk_items[i] = &bulk_nodes[i];
+    }
+    q = rl_heap_create(1, &test_cmp);
+    rl_heap_insert(q, &node0);
+    rl_heap_insert_bulk(q, bulk_items, 1000);
+    rl_heap_insert_bulk(q, bulk_items, 10);
+    assert(rl_heap_length(q) == 1011);
+    /* change priorities in place then rebuild */
+    for (int i = 0; i < 1000; ++i) {
+        bulk_nodes[i].priority = 999 - bulk_nodes[i].priority;
+    }
+    rl_heap_heapify(q);
+    int prev = -1, count = 0;
+    while ((d = (TestNode*) rl_heap_pop(q))) {
+        assert(d->priority >= prev);
+        prev = d->priority;
+        count++;
+    }
+    assert(count == 1011);
+
+    rl_heap_destroy(q);
+
     printf("Done\n");
 
     return 0;
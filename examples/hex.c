@@ -36,13 +36,13 @@ bool mapgen(void)
     RL_Status status;
     switch (mapgen_type) {
         case AUTOMATA:
-            status = rl_mapgen_automata(map, RL_MAPGEN_AUTOMATA_DEFAULTS);
+            status = rl_mapgen_automata_hex(map, RL_MAPGEN_AUTOMATA_HEX_DEFAULTS);
             break;
         case BSP:
-            status = rl_mapgen_bsp(map, RL_MAPGEN_BSP_DEFAULTS);
+            status = rl_mapgen_bsp_hex(map, RL_MAPGEN_BSP_DEFAULTS);
             break;
         case MAZE:
-            status = rl_mapgen_maze(map);
+            status = rl_mapgen_maze_hex(map);
             break;
     }
 
@@ -53,7 +53,7 @@ bool mapgen(void)
 
     // generate a random starting tile for player
     int player_x = 0, player_y = 0;
-    while (!rl_map_tile_is(map, player_x, player_y, RL_TileRoom)) {
+    while (!rl_map_is_passable(map, player_x, player_y)) {
         player_x = rl_rng_generate(0, WIDTH - 1);
         player_y = rl_rng_generate(0, HEIGHT - 1);
     }
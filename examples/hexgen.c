@@ -0,0 +1,147 @@
+#define RL_IMPLEMENTATION
+#include "../roguelike.h"
+
+#include <stdio.h>
+#include <time.h>
+
+#define WIDTH 120
+#define HEIGHT 80
+#define RUNS 20
+
+/* count of passable tiles reached by hex floodfill from the first passable tile */
+static size_t hex_reachable(RL_Map map, size_t *passable)
+{
+    static size_t stack[WIDTH * HEIGHT];
+    static bool seen[WIDTH * HEIGHT];
+    size_t stack_len = 0, reached = 0;
+    memset(seen, 0, sizeof(seen));
+    *passable = 0;
+    for (size_t i = 0; i < (size_t) WIDTH * HEIGHT; ++i) {
+        if (!rl_map_is_passable(map, i % WIDTH, i / WIDTH)) continue;
+        if ((*passable)++ == 0) {
+            seen[i] = true;
+            stack[stack_len++] = i;
+        }
+    }
+    while (stack_len) {
+        size_t i = stack[--stack_len];
+        unsigned int x = i % WIDTH, y = i / WIDTH;
+        const int (*offsets)[2] = rl_hex_neighbor_offsets(x, y);
+        reached++;
+        for (int d = 0; d < 6; ++d) {
+            unsigned int nx = x + offsets[d][0], ny = y + offsets[d][1];
+            if (!rl_map_is_passable(map, nx, ny) || seen[nx + ny * WIDTH]) continue;
+            seen[nx + ny * WIDTH] = true;
+            stack[stack_len++] = nx + ny * WIDTH;
+        }
+    }
+
+    return reached;
+}
+
+/* count of hex edges between passable tiles */
+static size_t hex_edges(RL_Map map)
+{
+    size_t edges = 0;
+    for (unsigned int y = 0; y < HEIGHT; ++y) {
+        for (unsigned int x = 0; x < WIDTH; ++x) {
+            const int (*offsets)[2] = rl_hex_neighbor_offsets(x, y);
+            if (!rl_map_is_passable(map, x, y)) continue;
+            for (int d = 0; d < 6; ++d) {
+                edges += rl_map_is_passable(map, x + offsets[d][0], y + offsets[d][1]);
+            }
+        }
+    }
+
+    return edges / 2;
+}
+
+static void print_map(RL_Map map)
+{
+    for (unsigned int y = 0; y < 20; ++y) {
+#if RL_HEX_FLAT_TOP != 1 && RL_HEX_ODD_OFFSET == 1
+        if (y & 1) printf(" ");
+#elif RL_HEX_FLAT_TOP != 1
+        if (!(y & 1)) printf(" ");
+#endif
+        for (unsigned int x = 0; x < 40; ++x) {
+            printf("%c ", rl_map_is_passable(map, x, y) ? '.' : '#');
+        }
+        printf("\n");
+    }
+}
+
+int main(void)
+{
+    srand(time(0));
+    RL_Map map = rl_map_create(WIDTH, HEIGHT);
+
+    /* the offset tables match the axial neighbors */
+    const int directions[6][2] = { {1, 0}, {1, -1}, {0, -1}, {-1, 0}, {-1, 1}, {0, 1} };
+    for (unsigned int y = 2; y < 6; ++y) {
+        for (unsigned int x = 2; x < 6; ++x) {
+            const int (*offsets)[2] = rl_hex_neighbor_offsets(x, y);
+            RL_Point axial = rl_point_axial(x, y);
+            for (int d = 0; d < 6; ++d) {
+                RL_Point neighbor = axial;
+                bool found = false;
+                neighbor.x += directions[d][0];
+                neighbor.y += directions[d][1];
+                neighbor = rl_axial_to_offset(neighbor);
+                for (int o = 0; o < 6; ++o) {
+                    found |= x + offsets[o][0] == neighbor.x && y + offsets[o][1] == neighbor.y;
+                }
+                assert(found);
+            }
+        }
+    }
+
+    /* the generated maps are hex connected */
+    clock_t hex_time = 0, square_time = 0;
+    for (int run = 0; run < RUNS; ++run) {
+        size_t passable, unculled;
+        unsigned int seed = rand();
+        RL_MapgenConfigAutomata config = RL_MAPGEN_AUTOMATA_HEX_DEFAULTS;
+        srand(seed);
+        clock_t start = clock();
+        assert(rl_mapgen_automata_hex(map, config) == RL_OK);
+        hex_time += clock() - start;
+        assert(hex_reachable(map, &passable) == passable && passable > 0);
+
+        /* the caves joined by corridors are all kept by the cull */
+        config.cull_unconnected = false;
+        srand(seed);
+        assert(rl_mapgen_automata_hex(map, config) == RL_OK);
+        assert(hex_reachable(map, &unculled) == unculled && unculled == passable);
+
+        /* the BSP tree connection joins every room, random connections might leave a few rooms joined to each other */
+        RL_MapgenConfigBSP bsp_config = RL_MAPGEN_BSP_DEFAULTS;
+        assert(rl_mapgen_bsp_hex(map, bsp_config) == RL_OK);
+        assert(hex_reachable(map, &passable) > 0);
+        bsp_config.draw_corridors = RL_ConnectBSP;
+        assert(rl_mapgen_bsp_hex(map, bsp_config) == RL_OK);
+        assert(hex_reachable(map, &passable) == passable && passable > 0);
+
+        /* the maze is a tree - connected without loops */
+        assert(rl_mapgen_maze_hex(map) == RL_OK);
+        assert(hex_reachable(map, &passable) == passable && passable > 1);
+        assert(hex_edges(map) == passable - 1);
+        for (unsigned int x = 0; x < WIDTH; ++x) {
+            assert(!rl_map_is_passable(map, x, 0) && !rl_map_is_passable(map, x, HEIGHT - 1));
+        }
+
+        start = clock();
+        assert(rl_mapgen_automata(map, RL_MAPGEN_AUTOMATA_DEFAULTS) == RL_OK);
+        square_time += clock() - start;
+    }
+    print_map(map);
+    assert(rl_mapgen_maze_hex(map) == RL_OK);
+    print_map(map);
+    printf("automata hex %.2fms, square %.2fms per map\n",
+           1000.0 * hex_time / CLOCKS_PER_SEC / RUNS, 1000.0 * square_time / CLOCKS_PER_SEC / RUNS);
+
+    rl_map_destroy(map);
+    printf("Success\n");
+
+    return 0;
+}
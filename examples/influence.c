@@ -0,0 +1,130 @@
+#define RL_IMPLEMENTATION
+#include "../roguelike.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <time.h>
+
+#define WIDTH 80
+#define HEIGHT 30
+#define SOURCE_COUNT 40
+#define TURNS 200
+
+/* recomputes the influence of every source from scratch */
+static void recompute(RL_Influence *influence, RL_InfluenceSource *sources, int count)
+{
+    rl_influence_clear(influence);
+    for (int i = 0; i < count; ++i) {
+        assert(rl_influence_add(influence, &sources[i]) == RL_OK);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    RL_InfluenceSource sources[SOURCE_COUNT];
+    unsigned long seed = time(0);
+    if (argc > 1) {
+        seed = atol(argv[1]);
+    }
+    printf("Seed: %lu\n", seed);
+    srand(seed);
+
+    RL_Map map = rl_map_create(WIDTH, HEIGHT);
+    if (rl_mapgen_automata(map, RL_MAPGEN_AUTOMATA_DEFAULTS) != RL_OK) {
+        fprintf(stderr, "Error during mapgen\n");
+        return 1;
+    }
+
+    /* a single source matches the Dijkstra scores within its radius */
+    unsigned int x, y;
+    rl_rng_map_passable(map, &x, &y);
+    RL_InfluenceSource single = { .x = x, .y = y, .strength = 10, .radius = 12, .falloff = RL_FalloffLinear };
+    RL_Influence *influence = rl_influence_create(map, NULL, NULL);
+    assert(influence != NULL);
+    assert(rl_influence_add(influence, &single) == RL_OK);
+    RL_Graph graph = rl_graph_create_scored(map, rl_point(x, y), NULL, NULL);
+    for (unsigned int ty = 0; ty < HEIGHT; ++ty) {
+        for (unsigned int tx = 0; tx < WIDTH; ++tx) {
+            float score = graph.nodes[tx + ty*WIDTH].score;
+            float expected = score <= single.radius ? single.strength * (1 - score / (single.radius + 1)) : 0;
+            assert(fabsf(rl_influence_value(influence, tx, ty) - expected) < 0.001f);
+        }
+    }
+    rl_graph_destroy(graph);
+    assert(rl_influence_remove(influence, single) == RL_OK);
+    for (unsigned int ty = 0; ty < HEIGHT; ++ty) {
+        for (unsigned int tx = 0; tx < WIDTH; ++tx) {
+            assert(fabsf(rl_influence_value(influence, tx, ty)) < 0.001f);
+        }
+    }
+    printf("Single source matched Dijkstra scores\n");
+
+    /* incrementally moving sources matches recomputing the map */
+    RL_Influence *full = rl_influence_create(map, NULL, NULL);
+    assert(full != NULL);
+    for (int i = 0; i < SOURCE_COUNT; ++i) {
+        rl_rng_map_passable(map, &x, &y);
+        sources[i] = (RL_InfluenceSource) { .x = x, .y = y, .strength = (float) (rand() % 20) - 10, .radius = 3 + rand() % 10, .falloff = (RL_Falloff) (i % 3) };
+        assert(rl_influence_add(influence, &sources[i]) == RL_OK);
+    }
+    for (int turn = 0; turn < TURNS; ++turn) {
+        for (int i = 0; i < SOURCE_COUNT; i += 4) { /* a quarter of the sources move each turn */
+            RL_InfluenceSource *s = &sources[(i + turn) % SOURCE_COUNT];
+            RL_Point to = rl_point(s->x + rand() % 3 - 1, s->y + rand() % 3 - 1);
+            if (rl_map_is_passable(map, to.x, to.y)) {
+                assert(rl_influence_move(influence, s, to.x, to.y) == RL_OK);
+            }
+        }
+    }
+    recompute(full, sources, SOURCE_COUNT);
+    for (unsigned int ty = 0; ty < HEIGHT; ++ty) {
+        for (unsigned int tx = 0; tx < WIDTH; ++tx) {
+            assert(fabsf(rl_influence_value(influence, tx, ty) - rl_influence_value(full, tx, ty)) < 0.01f);
+        }
+    }
+    printf("Incremental matched full recompute after %d turns\n", TURNS);
+    rl_influence_destroy(influence);
+    rl_influence_destroy(full);
+    rl_map_destroy(map);
+
+    /* walls block influence - a source on one side of a wall doesn't reach the other side */
+    map = rl_map_create(11, 5);
+    for (unsigned int ty = 1; ty < 4; ++ty) {
+        for (unsigned int tx = 1; tx < 10; ++tx) {
+            if (tx != 5) map.tiles[tx + ty*map.width] = RL_TileRoom;
+        }
+    }
+    influence = rl_influence_create(map, NULL, NULL);
+    RL_InfluenceSource wall = { .x = 3, .y = 2, .strength = 1, .radius = 20, .falloff = RL_FalloffConstant };
+    assert(rl_influence_add(influence, &wall) == RL_OK);
+    assert(rl_influence_value(influence, 4, 2) == 1);
+    assert(rl_influence_value(influence, 6, 2) == 0);
+
+    /* decay fades the map */
+    rl_influence_decay(influence, 0.5f);
+    assert(rl_influence_value(influence, 4, 2) == 0.5f);
+
+    /* sources added before & after decaying are removed exactly */
+    RL_InfluenceSource fresh = { .x = 7, .y = 2, .strength = 2, .radius = 20, .falloff = RL_FalloffConstant };
+    assert(rl_influence_add(influence, &fresh) == RL_OK);
+    for (int i = 0; i < 40; ++i) { /* folds the scale into the values along the way */
+        rl_influence_decay(influence, 0.8f);
+    }
+    assert(rl_influence_move(influence, &wall, 2, 2) == RL_OK);
+    assert(rl_influence_remove(influence, fresh) == RL_OK);
+    assert(fabsf(rl_influence_value(influence, 8, 2)) < 0.0001f);
+    assert(fabsf(rl_influence_value(influence, 4, 2) - 1.0f) < 0.0001f);
+    assert(rl_influence_remove(influence, wall) == RL_OK);
+    for (unsigned int ty = 0; ty < map.height; ++ty) {
+        for (unsigned int tx = 0; tx < map.width; ++tx) {
+            assert(fabsf(rl_influence_value(influence, tx, ty)) < 0.0001f);
+        }
+    }
+    printf("Walls blocked influence\n");
+    rl_influence_destroy(influence);
+    rl_map_destroy(map);
+
+    printf("Done\n");
+
+    return 0;
+}
@@ -0,0 +1,60 @@
+#define RL_IMPLEMENTATION
+#include "../roguelike.h"
+
+#include <stdio.h>
+#include <time.h>
+
+#define WIDTH 80
+#define HEIGHT 40
+#define RADIUS 10
+
+int main(int argc, char **argv)
+{
+    static RL_Point targets[WIDTH * HEIGHT];
+    static bool visible[WIDTH * HEIGHT];
+    unsigned long seed = time(0);
+    if (argc > 1) {
+        seed = atol(argv[1]);
+    }
+    printf("Seed: %lu\n", seed);
+    srand(seed);
+    RL_Map map = rl_map_create(WIDTH, HEIGHT);
+    if (rl_mapgen_automata(map, RL_MAPGEN_AUTOMATA_DEFAULTS) != RL_OK) {
+        fprintf(stderr, "Error during mapgen\n");
+        return 1;
+    }
+    size_t count = 0;
+    for (unsigned int y = 0; y < HEIGHT; ++y) {
+        for (unsigned int x = 0; x < WIDTH; ++x) {
+            targets[count++] = rl_point(x, y);
+        }
+    }
+
+    /* queries match the FOV for every tile, from a few origins */
+    RL_FOV fov = rl_fov_create(WIDTH, HEIGHT);
+    for (int i = 0; i < 20; ++i) {
+        unsigned int x, y;
+        int radius = i % 2 ? RADIUS : -1;
+        rl_rng_map_passable(map, &x, &y);
+        memset(fov.visibility, RL_TileCannotSee, WIDTH * HEIGHT);
+        rl_fov_calculate(fov, map, x, y, radius);
+        assert(rl_fov_can_see_many(map, x, y, radius, targets, count, visible) == RL_OK);
+        for (size_t t = 0; t < count; ++t) {
+            bool expected = rl_fov_is_visible(fov, targets[t].x, targets[t].y);
+            assert(visible[t] == expected);
+            assert(rl_fov_can_see(map, x, y, targets[t].x, targets[t].y, radius) == expected);
+        }
+    }
+    rl_fov_destroy(fov);
+    printf("Queries matched the FOV\n");
+
+    /* out of bounds targets are never visible */
+    targets[0] = rl_point(WIDTH, 0);
+    assert(rl_fov_can_see_many(map, 0, 0, RADIUS, targets, 1, visible) == RL_OK && !visible[0]);
+    assert(!rl_fov_can_see(map, 0, 0, WIDTH, 0, RADIUS));
+    rl_map_destroy(map);
+
+    printf("Done\n");
+
+    return 0;
+}
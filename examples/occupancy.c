@@ -0,0 +1,122 @@
+#define RL_IMPLEMENTATION
+#include "../roguelike.h"
+
+#include <stdio.h>
+#include <time.h>
+
+#define WIDTH 80
+#define HEIGHT 30
+#define ENTITY_COUNT 200
+
+typedef struct {
+    unsigned int x, y;
+    bool alive;
+} Entity;
+
+/* walks the path, checking whether it passes through an occupied tile before the end */
+static int path_length(RL_Path *path, const RL_Occupancy *occupancy, bool *through_occupied)
+{
+    int length = 0;
+    *through_occupied = false;
+    while ((path = rl_path_walk(path))) {
+        length++;
+        if (path->next && rl_occupancy_count(occupancy, path->point.x, path->point.y) > 0) {
+            *through_occupied = true;
+        }
+    }
+
+    return length;
+}
+
+int main(int argc, char **argv)
+{
+    static Entity entities[ENTITY_COUNT];
+    unsigned long seed = time(0);
+    if (argc > 1) {
+        seed = atol(argv[1]);
+    }
+    printf("Seed: %lu\n", seed);
+    srand(seed);
+
+    /* index matches the entity array under random inserts, moves & removes */
+    RL_Map map = rl_map_create(WIDTH, HEIGHT);
+    RL_Occupancy occupancy = rl_occupancy_create(WIDTH, HEIGHT, 16); /* grows to fit the ids */
+    if (rl_mapgen_automata(map, RL_MAPGEN_AUTOMATA_DEFAULTS) != RL_OK) {
+        fprintf(stderr, "Error during mapgen\n");
+        return 1;
+    }
+    for (int op = 0; op < 100000; ++op) {
+        int id = rand() % ENTITY_COUNT;
+        Entity *e = &entities[id];
+        unsigned int x, y;
+        rl_rng_map_passable(map, &x, &y);
+        if (!e->alive) {
+            assert(rl_occupancy_insert(&occupancy, id, x, y));
+            e->alive = true;
+        } else if (rand() % 4 == 0) {
+            rl_occupancy_remove(&occupancy, id);
+            e->alive = false;
+            continue;
+        } else {
+            assert(!rl_occupancy_insert(&occupancy, id, x, y));
+            assert(rl_occupancy_move(&occupancy, id, x, y));
+        }
+        e->x = x;
+        e->y = y;
+    }
+    for (unsigned int y = 0; y < HEIGHT; ++y) {
+        for (unsigned int x = 0; x < WIDTH; ++x) {
+            unsigned int count = 0, expected = 0;
+            for (int id = rl_occupancy_first(&occupancy, x, y); id >= 0; id = rl_occupancy_next(&occupancy, id)) {
+                assert(entities[id].alive && entities[id].x == x && entities[id].y == y);
+                count++;
+            }
+            for (int id = 0; id < ENTITY_COUNT; ++id) {
+                if (entities[id].alive && entities[id].x == x && entities[id].y == y) expected++;
+            }
+            assert(count == expected && rl_occupancy_count(&occupancy, x, y) == count);
+        }
+    }
+    printf("Index matched %d entities\n", ENTITY_COUNT);
+    rl_map_destroy(map);
+    rl_occupancy_destroy(occupancy);
+
+    /* a monster blocking a 1 wide corridor between two rooms */
+    map = rl_map_create(21, 5);
+    occupancy = rl_occupancy_create(21, 5, 4);
+    for (unsigned int y = 1; y < 4; ++y) {
+        for (unsigned int x = 1; x < 20; ++x) {
+            if (x < 6 || x > 14 || y == 2) map.tiles[x + y*map.width] = RL_TileRoom;
+        }
+    }
+    enum { PLAYER, MONSTER, TARGET };
+    rl_occupancy_insert(&occupancy, PLAYER, 2, 2);
+    rl_occupancy_insert(&occupancy, MONSTER, 10, 2);
+    rl_occupancy_insert(&occupancy, TARGET, 18, 2);
+    bool through_occupied;
+
+    /* blocked - no path, only the start is returned */
+    RL_Path *path = rl_path_create_occupancy(map, &occupancy, rl_point(2, 2), rl_point(18, 2), PLAYER, FLT_MAX);
+    assert(path != NULL && path->next == NULL);
+    rl_path_destroy(path);
+
+    /* costly - walks through the monster */
+    path = rl_path_create_occupancy(map, &occupancy, rl_point(2, 2), rl_point(18, 2), PLAYER, 10);
+    int length = path_length(path, &occupancy, &through_occupied);
+    printf("Path through the monster: %d\n", length);
+    assert(length == 16 && through_occupied);
+
+    /* moved out of the corridor - the blocked path reaches the (occupied) target */
+    rl_occupancy_move(&occupancy, MONSTER, 16, 2);
+    path = rl_path_create_occupancy(map, &occupancy, rl_point(2, 2), rl_point(18, 2), PLAYER, FLT_MAX);
+    length = path_length(path, &occupancy, &through_occupied);
+    printf("Path around the monster: %d\n", length);
+    assert(length == 16 && !through_occupied);
+
+    rl_occupancy_destroy(occupancy);
+    rl_map_destroy(map);
+
+    printf("Done\n");
+
+    return 0;
+}
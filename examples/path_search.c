@@ -0,0 +1,82 @@
+#define RL_IMPLEMENTATION
+#include "../roguelike.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <time.h>
+
+#define WIDTH 80
+#define HEIGHT 30
+#define EXPANSIONS_PER_FRAME 64
+
+/* Finds a path a few nodes at a time (e.g. once per frame), following the partial path while the search runs. */
+int main(int argc, char **argv)
+{
+    unsigned long seed = time(0);
+    if (argc > 1) {
+        seed = atol(argv[1]);
+    }
+    printf("Seed: %ld\n", seed);
+    srand(seed);
+
+    RL_Map map = rl_map_create(WIDTH, HEIGHT);
+    if (rl_mapgen_bsp(map, RL_MAPGEN_BSP_DEFAULTS) != RL_OK) {
+        fprintf(stderr, "Error during mapgen\n");
+        return 1;
+    }
+    unsigned int sx, sy, ex, ey;
+    rl_rng_map_passable(map, &sx, &sy);
+    do {
+        rl_rng_map_passable(map, &ex, &ey);
+    } while (sx == ex && sy == ey);
+
+    RL_PathSearch *search = rl_path_search_create(map, rl_point(sx, sy), rl_point(ex, ey), NULL, NULL, NULL);
+    assert(search != NULL);
+    int frames = 0;
+    while (!rl_path_search_step(search, EXPANSIONS_PER_FRAME)) {
+        /* partial path starts at start & heads toward the end */
+        RL_Path *path = rl_path_search_path(search);
+        assert(path != NULL);
+        assert(path->point.x == sx && path->point.y == sy);
+        rl_path_destroy(path);
+        frames++;
+    }
+    assert(search->found);
+    printf("Found path in %d frames (%zu nodes expanded)\n", frames + 1, search->expansions);
+
+    /* full path goes from start to end & costs the same as Dijkstra */
+    RL_Path *path = rl_path_search_path(search);
+    RL_Point last = path->point;
+    int length = 0;
+    assert(path->point.x == sx && path->point.y == sy);
+    while ((path = rl_path_walk(path))) {
+        assert(fabs(path->point.x - last.x) <= 1 && fabs(path->point.y - last.y) <= 1);
+        assert(rl_map_is_passable(map, path->point.x, path->point.y));
+        last = path->point;
+        length++;
+    }
+    assert(last.x == ex && last.y == ey);
+    RL_Graph graph = rl_graph_create_scored(map, rl_point(ex, ey), NULL, NULL);
+    float dijkstra_score = rl_graph_node(graph, rl_point(sx, sy))->score;
+    float astar_score = rl_graph_node(search->graph, rl_point(ex, ey))->score;
+    printf("Path length: %d, score %.1f (Dijkstra %.1f, %zu nodes)\n", length, astar_score, dijkstra_score, graph.length);
+    assert(fabs(astar_score - dijkstra_score) < 0.01);
+    rl_graph_destroy(graph);
+    rl_path_search_destroy(search);
+
+    /* unreachable end */
+    map.tiles[0] = RL_TileRoom;
+    search = rl_path_search_create(map, rl_point(sx, sy), rl_point(0, 0), NULL, NULL, NULL);
+    while (!rl_path_search_step(search, EXPANSIONS_PER_FRAME)) {}
+    assert(!search->found);
+    path = rl_path_search_path(search);
+    assert(path != NULL);
+    rl_path_destroy(path);
+    rl_path_search_destroy(search);
+
+    rl_map_destroy(map);
+
+    printf("Done\n");
+
+    return 0;
+}
@@ -0,0 +1,117 @@
+#define RL_IMPLEMENTATION
+#include "../roguelike.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <time.h>
+
+#define WIDTH 80
+#define HEIGHT 40
+#define SPREAD 10
+
+static int compare_floats(const void *a, const void *b)
+{
+    float fa = *(const float*) a, fb = *(const float*) b;
+    return (fa > fb) - (fa < fb);
+}
+
+static bool even_column(const RL_Map map, void *context, unsigned int x, unsigned int y)
+{
+    (void) map; (void) context; (void) y;
+    return x % 2 == 0;
+}
+
+int main(int argc, char **argv)
+{
+    static float sorted[WIDTH * HEIGHT];
+    static float nearest[WIDTH * HEIGHT];
+    RL_Point points[SPREAD];
+    unsigned long seed = time(0);
+    if (argc > 1) {
+        seed = atol(argv[1]);
+    }
+    printf("Seed: %lu\n", seed);
+    srand(seed);
+    RL_Map map = rl_map_create(WIDTH, HEIGHT);
+    if (rl_mapgen_automata(map, RL_MAPGEN_AUTOMATA_DEFAULTS) != RL_OK) {
+        fprintf(stderr, "Error during mapgen\n");
+        return 1;
+    }
+    unsigned int x, y;
+    rl_rng_map_passable(map, &x, &y);
+    RL_Point start = rl_point(x, y);
+    RL_Graph graph = rl_graph_create_scored(map, start, NULL, NULL);
+    size_t count = 0;
+    for (size_t i = 0; i < graph.length; ++i) {
+        if (graph.nodes[i].score > 0 && graph.nodes[i].score < FLT_MAX) sorted[count++] = graph.nodes[i].score;
+    }
+    qsort(sorted, count, sizeof(*sorted), compare_floats);
+
+    /* picked tiles are ranked within the percentiles */
+    for (int i = 0; i < 100; ++i) {
+        assert(rl_rng_map_percentile(map, start, 0.9f, 1.0f, NULL, NULL, &x, &y) == RL_OK);
+        float distance = graph.nodes[x + y*WIDTH].score;
+        assert(distance >= sorted[(size_t) ((count - 1) * 0.9f)] && distance <= sorted[count - 1]);
+        assert(rl_rng_map_percentile(map, start, 0.25f, 0.5f, NULL, NULL, &x, &y) == RL_OK);
+        distance = graph.nodes[x + y*WIDTH].score;
+        assert(distance >= sorted[(size_t) ((count - 1) * 0.25f)] && distance <= sorted[(size_t) ((count - 1) * 0.5f)]);
+    }
+    assert(rl_rng_map_percentile(map, start, 1, 1, NULL, NULL, &x, &y) == RL_OK);
+    printf("Farthest tile from the start: %.1f\n", graph.nodes[x + y*WIDTH].score);
+    assert(fabsf(graph.nodes[x + y*WIDTH].score - sorted[count - 1]) < 0.01f);
+    assert(rl_rng_map_percentile(map, start, 0, 0, NULL, NULL, &x, &y) == RL_OK);
+    assert(fabsf(graph.nodes[x + y*WIDTH].score - sorted[0]) < 0.01f);
+
+    /* each spread point is the farthest matching tile from the start & the previous points */
+    size_t placed = rl_rng_map_spread(map, start, NULL, even_column, points, SPREAD);
+    assert(placed == SPREAD);
+    for (size_t i = 0; i < graph.length; ++i) {
+        nearest[i] = graph.nodes[i].score;
+    }
+    for (size_t p = 0; p < placed; ++p) {
+        float farthest = 0;
+        for (unsigned int ty = 0; ty < HEIGHT; ++ty) {
+            for (unsigned int tx = 0; tx < WIDTH; tx += 2) {
+                float score = nearest[tx + ty*WIDTH];
+                if (score < FLT_MAX && score > farthest) farthest = score;
+            }
+        }
+        size_t index = points[p].x + points[p].y*WIDTH;
+        printf("Point %zu at %.0f, %.0f: %.1f from the nearest\n", p, points[p].x, points[p].y, nearest[index]);
+        assert((unsigned int) points[p].x % 2 == 0 && fabsf(nearest[index] - farthest) < 0.01f);
+        RL_Graph point_graph = rl_graph_create_scored(map, points[p], NULL, NULL);
+        for (size_t i = 0; i < graph.length; ++i) {
+            if (point_graph.nodes[i].score < nearest[i]) nearest[i] = point_graph.nodes[i].score;
+        }
+        rl_graph_destroy(point_graph);
+    }
+    rl_graph_destroy(graph);
+    rl_map_destroy(map);
+
+    /* ties are picked at random - both ends of a corridor are the farthest from its middle */
+    map = rl_map_create(21, 3);
+    for (unsigned int tx = 0; tx < 21; ++tx) {
+        map.tiles[tx + 21] = RL_TileCorridor;
+    }
+    bool left = false, right = false;
+    for (int i = 0; i < 100; ++i) {
+        assert(rl_rng_map_spread(map, rl_point(10, 1), NULL, NULL, points, 1) == 1);
+        assert(points[0].y == 1 && (points[0].x == 0 || points[0].x == 20));
+        left |= points[0].x == 0;
+        right |= points[0].x == 20;
+    }
+    assert(left && right);
+    rl_map_destroy(map);
+
+    /* a large open map */
+    map = rl_map_create(500, 500);
+    memset(map.tiles, RL_TileRoom, 500 * 500);
+    assert(rl_rng_map_percentile(map, rl_point(0, 0), 0.9f, 1, NULL, NULL, &x, &y) == RL_OK);
+    assert(rl_rng_map_spread(map, rl_point(0, 0), NULL, NULL, points, SPREAD) == SPREAD);
+    printf("Spread %d points on 500x500\n", SPREAD);
+    rl_map_destroy(map);
+
+    printf("Done\n");
+
+    return 0;
+}
@@ -0,0 +1,83 @@
+#define RL_IMPLEMENTATION
+#include "../roguelike.h"
+
+#include <stdio.h>
+#include <time.h>
+
+#define WIDTH 80
+#define HEIGHT 30
+#define EDITS 5000
+#define QUERIES 100000
+
+int main(int argc, char **argv)
+{
+    unsigned long seed = time(0);
+    if (argc > 1) {
+        seed = atol(argv[1]);
+    }
+    printf("Seed: %lu\n", seed);
+    srand(seed);
+    RL_Map map = rl_map_create(WIDTH, HEIGHT);
+    RL_MapgenConfigAutomata config = RL_MAPGEN_AUTOMATA_DEFAULTS;
+    config.cull_unconnected = false;
+    if (rl_mapgen_automata(map, config) != RL_OK) {
+        fprintf(stderr, "Error during mapgen\n");
+        return 1;
+    }
+    RL_Reachability *reach = rl_reachability_create(map);
+    RL_FloodFill *fill = rl_floodfill_create(WIDTH, HEIGHT);
+    assert(reach != NULL && fill != NULL);
+
+    /* labels match a flood fill under random digging & filling */
+    for (int edit = 0; edit < EDITS; ++edit) {
+        unsigned int x = rand() % WIDTH, y = rand() % HEIGHT;
+        map.tiles[x + y*WIDTH] = rl_map_is_passable(map, x, y) ? RL_TileRock : RL_TileRoom;
+        assert(rl_reachability_update(reach, x, y) == RL_OK);
+        if (edit % 10) continue;
+        rl_rng_map_passable(map, &x, &y);
+        assert(rl_floodfill(fill, map, x, y, true, NULL, NULL, NULL) == RL_OK);
+        for (unsigned int ty = 0; ty < HEIGHT; ++ty) {
+            for (unsigned int tx = 0; tx < WIDTH; ++tx) {
+                assert(rl_reachability_connected(reach, x, y, tx, ty) == rl_floodfill_is_filled(fill, tx, ty));
+            }
+        }
+    }
+    printf("Labels matched flood fills after %d edits\n", EDITS);
+
+    /* a wall splitting a corridor, then digging through again */
+    RL_Map corridor = rl_map_create(10, 3);
+    for (unsigned int x = 0; x < 10; ++x) corridor.tiles[x + 10] = RL_TileCorridor;
+    RL_Reachability *r = rl_reachability_create(corridor);
+    assert(rl_reachability_connected(r, 0, 1, 9, 1));
+    corridor.tiles[5 + 10] = RL_TileRock;
+    rl_reachability_update(r, 5, 1);
+    assert(!rl_reachability_connected(r, 0, 1, 9, 1) && rl_reachability_connected(r, 0, 1, 4, 1));
+    assert(!rl_reachability_connected(r, 5, 1, 5, 1));
+    corridor.tiles[5] = RL_TileCorridor;
+    rl_reachability_update(r, 5, 0);
+    assert(rl_reachability_connected(r, 0, 1, 9, 1));
+    rl_reachability_destroy(r);
+    rl_map_destroy(corridor);
+
+    /* hopeless path queries are rejected without a search */
+    static RL_Point points[1000];
+    for (int i = 0; i < 1000; ++i) {
+        unsigned int x, y;
+        rl_rng_map_passable(map, &x, &y);
+        points[i] = rl_point(x, y);
+    }
+    int rejected = 0;
+    for (int q = 0; q < QUERIES; ++q) {
+        RL_Point a = points[rand() % 1000], b = points[rand() % 1000];
+        if (!rl_reachability_connected(reach, a.x, a.y, b.x, b.y)) rejected++;
+    }
+    printf("%d queries (%d unreachable)\n", QUERIES, rejected);
+
+    rl_floodfill_destroy(fill);
+    rl_reachability_destroy(reach);
+    rl_map_destroy(map);
+
+    printf("Done\n");
+
+    return 0;
+}
@@ -0,0 +1,81 @@
+#define _POSIX_C_SOURCE 199309L /* clock_gettime for RL_CLOCK_US - clock() sums the time of every OpenMP thread */
+#define RL_IMPLEMENTATION
+#include "../roguelike.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <time.h>
+
+#define WIDTH 160
+#define HEIGHT 100
+
+int main(void)
+{
+    srand(time(0));
+    RL_Map map = rl_map_create(WIDTH, HEIGHT);
+    RL_BSP *bsp = rl_bsp_create(WIDTH, HEIGHT);
+    if (rl_mapgen_bsp_ex(map, bsp, RL_MAPGEN_BSP_DEFAULTS) != RL_OK) {
+        fprintf(stderr, "Error during mapgen\n");
+        return 1;
+    }
+
+    double start = RL_CLOCK_US();
+    RL_RoomTable rooms = rl_room_table_create_bsp(map, bsp);
+    double table_ms = (RL_CLOCK_US() - start) / 1000;
+    assert(rooms.distances != NULL);
+    int count = (int) rooms.room_count;
+    printf("Room table for %d rooms in %.3f ms\n", count, table_ms);
+
+    /* distances match a Dijkstra graph seeded from the exits of each room */
+    RL_Graph graph = rl_graph_create_from_map(map, NULL);
+    RL_GraphContext context = rl_graph_context(graph, map);
+    start = RL_CLOCK_US();
+    for (int a = 0; a < count; ++a) {
+        rl_graph_reset(graph);
+        for (unsigned int y = 0; y < HEIGHT; ++y) {
+            for (unsigned int x = 0; x < WIDTH; ++x) {
+                bool exit = false;
+                if (rl_room_table_room(rooms, x, y) != a) continue;
+                for (int dy = -1; dy <= 1; ++dy) {
+                    for (int dx = -1; dx <= 1; ++dx) {
+                        if (rl_map_is_passable(map, x + dx, y + dy) && rl_room_table_room(rooms, x + dx, y + dy) != a) exit = true;
+                    }
+                }
+                if (exit) graph.nodes[x + y*WIDTH].score = 0;
+            }
+        }
+        rl_graph_score_seeded(graph, &context, NULL);
+        for (int b = 0; b < count; ++b) {
+            float expected = a == b ? 0 : FLT_MAX;
+            for (size_t i = 0; i < graph.length && a != b; ++i) {
+                if (rooms.rooms[i] == b && graph.nodes[i].score < expected) expected = graph.nodes[i].score;
+            }
+            float distance = rl_room_table_distance(rooms, a, b);
+            assert(expected == FLT_MAX ? distance == FLT_MAX : fabsf(distance - expected) < 0.01f);
+
+            /* following the next rooms reaches the destination, getting closer each hop */
+            int room = a, hops = 0;
+            if (distance == FLT_MAX) {
+                assert(rl_room_table_next(rooms, a, b) == -1);
+                continue;
+            }
+            while (room != b) {
+                int next = rl_room_table_next(rooms, room, b);
+                assert(next >= 0 && next != room && ++hops <= count);
+                assert(rl_room_table_distance(rooms, next, b) < rl_room_table_distance(rooms, room, b));
+                room = next;
+            }
+        }
+    }
+    printf("Matched %d Dijkstra sweeps (%.3f ms)\n", count, (RL_CLOCK_US() - start) / 1000);
+    assert(rl_room_table_room(rooms, WIDTH, 0) == -1);
+
+    rl_graph_destroy(graph);
+    rl_room_table_destroy(rooms);
+    rl_bsp_destroy(bsp);
+    rl_map_destroy(map);
+
+    printf("Done\n");
+
+    return 0;
+}
@@ -0,0 +1,111 @@
+#define RL_IMPLEMENTATION
+#include "../roguelike.h"
+
+#include <stdio.h>
+#include <time.h>
+
+#define WIDTH 200
+#define HEIGHT 100
+#define FILLS 100
+
+typedef struct {
+    size_t count;
+    unsigned int min_x, min_y, max_x, max_y;
+} FillStats;
+
+static void count_tile(unsigned int x, unsigned int y, void *context)
+{
+    FillStats *stats = (FillStats*) context;
+    stats->count++;
+    if (x < stats->min_x) stats->min_x = x;
+    if (y < stats->min_y) stats->min_y = y;
+    if (x > stats->max_x) stats->max_x = x;
+    if (y > stats->max_y) stats->max_y = y;
+}
+
+static bool is_floor(const RL_Map map, void *context, unsigned int x, unsigned int y)
+{
+    RL_UNUSED(context);
+    return rl_map_is_passable(map, x, y);
+}
+
+static bool is_wall(const RL_Map map, void *context, unsigned int x, unsigned int y)
+{
+    RL_UNUSED(context);
+    return !rl_map_is_passable(map, x, y);
+}
+
+int main(int argc, char **argv)
+{
+    unsigned long seed = time(0);
+    if (argc > 1) {
+        seed = atol(argv[1]);
+    }
+    printf("Seed: %lu\n", seed);
+    srand(seed);
+    RL_Map map = rl_map_create(WIDTH, HEIGHT);
+    RL_MapgenConfigAutomata config = RL_MAPGEN_AUTOMATA_DEFAULTS;
+    config.cull_unconnected = false;
+    if (rl_mapgen_automata(map, config) != RL_OK) {
+        fprintf(stderr, "Error during mapgen\n");
+        return 1;
+    }
+    RL_FloodFill *fill = rl_floodfill_create(WIDTH, HEIGHT);
+    assert(fill != NULL);
+
+    /* filled tiles match the reachable tiles of a Dijkstra graph, with 8 & 4 way neighbors */
+    size_t filled = 0;
+    for (int i = 0; i < FILLS; ++i) {
+        bool diagonal = i % 2 == 0;
+        unsigned int x, y;
+        FillStats stats = { 0, WIDTH, HEIGHT, 0, 0 };
+        rl_rng_map_passable(map, &x, &y);
+        assert(rl_floodfill(fill, map, x, y, diagonal, &stats, NULL, count_tile) == RL_OK);
+        RL_Graph graph = rl_graph_create_scored(map, rl_point(x, y), NULL,
+                                                diagonal ? rl_graph_neighbors_ordinal_passable : rl_graph_neighbors_cardinal_passable);
+        size_t reachable = 0;
+        for (unsigned int ty = 0; ty < HEIGHT; ++ty) {
+            for (unsigned int tx = 0; tx < WIDTH; ++tx) {
+                bool is_reachable = graph.nodes[tx + ty*WIDTH].score < FLT_MAX;
+                assert(rl_floodfill_is_filled(fill, tx, ty) == is_reachable);
+                reachable += is_reachable;
+            }
+        }
+        assert(fill->count == reachable && stats.count == reachable);
+        assert(fill->bounds.x == stats.min_x && fill->bounds.y == stats.min_y);
+        assert(fill->bounds.width == stats.max_x - stats.min_x + 1 && fill->bounds.height == stats.max_y - stats.min_y + 1);
+        filled += fill->count;
+        rl_graph_destroy(graph);
+
+        /* the callback path fills the same tiles as the passable fast path */
+        assert(rl_floodfill(fill, map, x, y, diagonal, NULL, is_floor, NULL) == RL_OK && fill->count == reachable);
+    }
+    printf("Filled %zu tiles matching Dijkstra graphs\n", filled);
+
+    /* custom predicate - the walls connected to the border */
+    assert(rl_floodfill(fill, map, 0, 0, false, NULL, is_wall, NULL) == RL_OK);
+    assert(fill->bounds.x == 0 && fill->bounds.y == 0 && fill->bounds.width == WIDTH && fill->bounds.height == HEIGHT);
+    for (unsigned int x = 0; x < WIDTH; ++x) {
+        assert(rl_floodfill_is_filled(fill, x, 0) && rl_floodfill_is_filled(fill, x, HEIGHT - 1));
+    }
+
+    /* nothing filled when the start doesn't match */
+    assert(rl_floodfill(fill, map, 0, 0, true, NULL, NULL, NULL) == RL_OK);
+    assert(fill->count == 0 && !rl_floodfill_is_filled(fill, 0, 0) && !rl_floodfill_is_filled(fill, WIDTH - 1, 0));
+
+    /* open map */
+    rl_floodfill_destroy(fill);
+    rl_map_destroy(map);
+    map = rl_map_create(2000, 2000);
+    memset(map.tiles, RL_TileRoom, 2000 * 2000);
+    fill = rl_floodfill_create(2000, 2000);
+    assert(rl_floodfill(fill, map, 1000, 1000, true, NULL, NULL, NULL) == RL_OK);
+    assert(fill->count == 2000 * 2000);
+    printf("Filled %zu open tiles\n", fill->count);
+    rl_floodfill_destroy(fill);
+    rl_map_destroy(map);
+
+    printf("Done\n");
+
+    return 0;
+}
@@ -0,0 +1,144 @@
+#define RL_IMPLEMENTATION
+#include "../roguelike.h"
+
+#include <stdio.h>
+#include <time.h>
+
+#define ACTOR_COUNT 256
+#define OPERATIONS 100000
+#define BENCH_ACTORS 50000
+#define BENCH_TURNS 1000000
+
+typedef struct {
+    int id;
+    unsigned int speed;
+    int turns;
+    RL_SchedulerHandle handles[2]; /* handle in the heap only & wheel schedulers */
+    bool scheduled;
+    unsigned long time;     /* reference scheduler - time & sequence of the next turn */
+    unsigned long sequence;
+} Actor;
+
+/* reference scheduler - linear search for the earliest actor */
+static Actor *reference_next(Actor *actors, int count)
+{
+    Actor *next = NULL;
+    for (int i = 0; i < count; ++i) {
+        Actor *a = &actors[i];
+        if (!a->scheduled) continue;
+        if (next == NULL || a->time < next->time || (a->time == next->time && a->sequence < next->sequence)) {
+            next = a;
+        }
+    }
+
+    return next;
+}
+
+int main(int argc, char **argv)
+{
+    static Actor actors[ACTOR_COUNT];
+    RL_Scheduler *schedulers[2];
+    unsigned long now = 0, sequence = 0;
+    unsigned long seed = time(0);
+    if (argc > 1) {
+        seed = atol(argv[1]);
+    }
+    printf("Seed: %lu\n", seed);
+    srand(seed);
+
+    /* heap only & timing wheel schedulers match the reference order under random inserts, reschedules & removes */
+    schedulers[0] = rl_scheduler_create(1, 0);
+    schedulers[1] = rl_scheduler_create(16, 64);
+    assert(schedulers[0] && schedulers[1]);
+    for (int i = 0; i < ACTOR_COUNT; ++i) {
+        actors[i].id = i;
+    }
+    for (int op = 0; op < OPERATIONS; ++op) {
+        Actor *a = &actors[rand() % ACTOR_COUNT];
+        unsigned long delay = rand() % 4 == 0 ? (unsigned long) (rand() % 300) : (unsigned long) (rand() % 8);
+        switch (rand() % 4) {
+            case 0: /* insert or remove */
+                if (a->scheduled) {
+                    for (int s = 0; s < 2; ++s) {
+                        assert(rl_scheduler_remove(schedulers[s], a->handles[s]) == a);
+                    }
+                    a->scheduled = false;
+                } else {
+                    for (int s = 0; s < 2; ++s) {
+                        a->handles[s] = rl_scheduler_insert(schedulers[s], a, delay);
+                        assert(a->handles[s] != RL_SCHEDULER_INVALID);
+                    }
+                    a->scheduled = true;
+                    a->time = now + delay;
+                    a->sequence = sequence++;
+                }
+                break;
+            case 1: /* reschedule */
+                if (a->scheduled) {
+                    for (int s = 0; s < 2; ++s) {
+                        assert(rl_scheduler_reschedule(schedulers[s], a->handles[s], delay));
+                    }
+                    a->time = now + delay;
+                    a->sequence = sequence++;
+                }
+                break;
+            default: { /* next actor takes a turn */
+                Actor *expected = reference_next(actors, ACTOR_COUNT);
+                for (int s = 0; s < 2; ++s) {
+                    RL_SchedulerHandle h = rl_scheduler_next(schedulers[s]);
+                    if (expected == NULL) {
+                        assert(h == RL_SCHEDULER_INVALID);
+                    } else {
+                        assert(rl_scheduler_actor(schedulers[s], h) == expected);
+                        assert(schedulers[s]->now == expected->time);
+                        assert(rl_scheduler_reschedule(schedulers[s], h, delay));
+                    }
+                }
+                if (expected) {
+                    now = expected->time;
+                    expected->time = now + delay;
+                    expected->sequence = sequence++;
+                }
+                break;
+            }
+        }
+        assert(rl_scheduler_length(schedulers[0]) == rl_scheduler_length(schedulers[1]));
+    }
+    printf("Schedulers matched the reference after %d operations (%d actors scheduled)\n", OPERATIONS, rl_scheduler_length(schedulers[0]));
+    rl_scheduler_destroy(schedulers[0]);
+    rl_scheduler_destroy(schedulers[1]);
+
+    /* energy - an actor with double the speed acts twice as often */
+    RL_Scheduler *s = rl_scheduler_create(2, 64);
+    Actor slow = { .id = 0, .speed = 10 }, fast = { .id = 1, .speed = 20 };
+    rl_scheduler_insert(s, &slow, 0);
+    rl_scheduler_insert(s, &fast, 0);
+    for (int turn = 0; turn < 300; ++turn) {
+        RL_SchedulerHandle h = rl_scheduler_next(s);
+        Actor *a = rl_scheduler_actor(s, h);
+        a->turns++;
+        rl_scheduler_reschedule(s, h, rl_scheduler_delay(100, a->speed));
+    }
+    printf("Turns taken: slow %d, fast %d\n", slow.turns, fast.turns);
+    assert(fast.turns == slow.turns * 2);
+    rl_scheduler_destroy(s);
+
+    /* many actors with small delays */
+    static Actor many[BENCH_ACTORS];
+    s = rl_scheduler_create(BENCH_ACTORS, 256);
+    for (int i = 0; i < BENCH_ACTORS; ++i) {
+        many[i].speed = 5 + rand() % 20;
+        rl_scheduler_insert(s, &many[i], rand() % 20);
+    }
+    for (int turn = 0; turn < BENCH_TURNS; ++turn) {
+        RL_SchedulerHandle h = rl_scheduler_next(s);
+        Actor *a = rl_scheduler_actor(s, h);
+        rl_scheduler_reschedule(s, h, rl_scheduler_delay(100, a->speed));
+    }
+    printf("%d turns with %d actors\n", BENCH_TURNS, BENCH_ACTORS);
+    rl_scheduler_destroy(s);
+
+    printf("Done\n");
+
+    return 0;
+}
@@ -0,0 +1,78 @@
+#define RL_STATS 1
+#define RL_IMPLEMENTATION
+#include "../roguelike.h"
+
+#include <stdio.h>
+#include <time.h>
+
+#define WIDTH 80
+#define HEIGHT 30
+
+void print_stats(const char *name, RL_Stats stats)
+{
+    printf("%s:\n", name);
+    printf("  dijkstra expansions: %lu\n", stats.dijkstra_expansions);
+    printf("  heap pushes/pops:    %lu/%lu\n", stats.heap_pushes, stats.heap_pops);
+    printf("  fov cells visited:   %lu\n", stats.fov_cells_visited);
+    printf("  max recursion depth: %lu\n", stats.max_recursion_depth);
+    printf("  rng draws:           %lu\n", stats.rng_draws);
+    printf("  allocations (bytes): %lu (%lu)\n", stats.allocations, stats.bytes_allocated);
+}
+
+int main(int argc, char **argv)
+{
+    unsigned long seed = time(0);
+    if (argc > 1) {
+        seed = atol(argv[1]);
+    }
+    printf("Seed: %lu\n", seed);
+    srand(seed);
+
+    RL_Map map = rl_map_create(WIDTH, HEIGHT);
+    RL_Stats stats;
+
+    rl_stats_reset();
+    if (rl_mapgen_bsp(map, RL_MAPGEN_BSP_DEFAULTS) != RL_OK) {
+        fprintf(stderr, "Error during mapgen\n");
+        return 1;
+    }
+    stats = rl_stats_snapshot();
+    print_stats("rl_mapgen_bsp", stats);
+    assert(stats.rng_draws > 0);
+    assert(stats.allocations > 0);
+    assert(stats.max_recursion_depth > 0);
+    assert(stats.recursion_depth == 0);
+
+    unsigned int x, y;
+    rl_rng_map_passable(map, &x, &y);
+
+    rl_stats_reset();
+    RL_Graph graph = rl_graph_create_from_map(map, NULL);
+    rl_graph_score(graph, map, rl_point(x, y), NULL);
+    stats = rl_stats_snapshot();
+    print_stats("rl_graph_score", stats);
+    assert(stats.dijkstra_expansions > 0);
+    assert(stats.heap_pushes > 0);
+    assert(stats.heap_pops == stats.heap_pushes); /* the whole queue gets drained */
+    rl_graph_destroy(graph);
+
+    rl_stats_reset();
+    RL_FOV fov = rl_fov_create(WIDTH, HEIGHT);
+    rl_fov_calculate(fov, map, x, y, 16);
+    stats = rl_stats_snapshot();
+    print_stats("rl_fov_calculate", stats);
+    assert(stats.fov_cells_visited > 0);
+    assert(stats.max_recursion_depth > 0);
+    assert(stats.recursion_depth == 0);
+    rl_fov_destroy(fov);
+
+    rl_stats_reset();
+    stats = rl_stats_snapshot();
+    assert(stats.allocations == 0 && stats.rng_draws == 0);
+
+    rl_map_destroy(map);
+
+    printf("Done\n");
+
+    return 0;
+}
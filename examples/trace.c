@@ -0,0 +1,61 @@
+#define RL_TRACE 1
+#define RL_IMPLEMENTATION
+#include "../roguelike.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define WIDTH 80
+#define HEIGHT 30
+
+/* Records a BSP mapgen, a path & FOV calculation as a Chrome trace. Pass a filename to save the trace (open it in
+ * chrome://tracing or https://ui.perfetto.dev). */
+int main(int argc, char **argv)
+{
+    srand(time(0));
+
+    FILE *f = argc > 1 ? fopen(argv[1], "w+") : tmpfile();
+    if (f == NULL) {
+        fprintf(stderr, "Error opening trace file\n");
+        return 1;
+    }
+
+    RL_Map map = rl_map_create(WIDTH, HEIGHT);
+    RL_FOV fov = rl_fov_create(WIDTH, HEIGHT);
+    if (!rl_trace_start(f)) {
+        fprintf(stderr, "Error starting trace\n");
+        return 1;
+    }
+    if (rl_mapgen_bsp(map, RL_MAPGEN_BSP_DEFAULTS) != RL_OK) {
+        fprintf(stderr, "Error during mapgen\n");
+        return 1;
+    }
+    unsigned int sx, sy, ex, ey;
+    rl_rng_map_passable(map, &sx, &sy);
+    rl_rng_map_passable(map, &ex, &ey);
+    rl_path_destroy(rl_path_create(map, rl_point(sx, sy), rl_point(ex, ey), NULL, NULL));
+    rl_fov_calculate(fov, map, sx, sy, 8);
+    rl_trace_stop();
+
+    /* check every begin event has an end event */
+    char line[256];
+    int begin = 0, end = 0, corridors = 0;
+    rewind(f);
+    while (fgets(line, sizeof(line), f)) {
+        if (strstr(line, "\"ph\":\"B\"")) begin++;
+        if (strstr(line, "\"ph\":\"E\"")) end++;
+        if (strstr(line, "\"rl_mapgen_connect_corridor\"")) corridors++;
+    }
+    printf("Trace events: %d begin, %d end, %d corridor digs\n", begin, end, corridors / 2);
+    assert(begin > 0 && begin == end);
+    assert(corridors > 0);
+
+    fclose(f);
+    rl_fov_destroy(fov);
+    rl_map_destroy(map);
+
+    printf("Done\n");
+
+    return 0;
+}
@@ -0,0 +1,70 @@
+#define RL_IMPLEMENTATION
+#include "../roguelike.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <time.h>
+
+#define ENTRIES 64
+#define SAMPLES 1000000
+
+/* xorshift generator with the state as context */
+static unsigned int xorshift(void *context, unsigned int min, unsigned int max)
+{
+    unsigned int *state = (unsigned int*) context;
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return min + *state % (max - min + 1);
+}
+
+int main(int argc, char **argv)
+{
+    static size_t samples[SAMPLES];
+    float weights[ENTRIES], total = 0;
+    size_t counts[ENTRIES] = {0};
+    unsigned long seed = time(0);
+    if (argc > 1) {
+        seed = atol(argv[1]);
+    }
+    printf("Seed: %lu\n", seed);
+    srand(seed);
+    for (int i = 0; i < ENTRIES; ++i) {
+        weights[i] = i % 7 == 0 ? 0 : (float) (rand() % 1000) / 10;
+        total += weights[i];
+    }
+
+    /* sampled frequencies match the weights */
+    RL_WeightedTable table = rl_weighted_table_create(weights, ENTRIES);
+    assert(table.thresholds != NULL);
+    assert(rl_weighted_table_sample_many(table, samples, SAMPLES, NULL, NULL) == RL_OK);
+    for (int i = 0; i < SAMPLES; ++i) {
+        assert(samples[i] < ENTRIES);
+        counts[samples[i]]++;
+    }
+    for (int i = 0; i < ENTRIES; ++i) {
+        double expected = weights[i] / total * SAMPLES;
+        if (weights[i] == 0) assert(counts[i] == 0);
+        assert(fabs(counts[i] - expected) < 6 * sqrt(expected) + 1); /* within 6 standard deviations */
+    }
+    printf("%d samples of %d entries matched the weights\n", SAMPLES, ENTRIES);
+
+    /* the same RNG state draws the same samples */
+    unsigned int state_a = 12345, state_b = 12345;
+    for (int i = 0; i < 1000; ++i) {
+        assert(rl_weighted_table_sample_with(table, xorshift, &state_a) == rl_weighted_table_sample_with(table, xorshift, &state_b));
+    }
+    rl_weighted_table_destroy(table);
+
+    /* a single positive weight is always drawn */
+    float single[] = { 0, -1, 5, 0 };
+    table = rl_weighted_table_create(single, 4);
+    for (int i = 0; i < 1000; ++i) {
+        assert(rl_weighted_table_sample(table) == 2);
+    }
+    rl_weighted_table_destroy(table);
+
+    printf("Done\n");
+
+    return 0;
+}
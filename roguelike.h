@@ -33,6 +33,18 @@
  * called by the library - it is only used in rl_heap_insert and all heaps used
  * internally are never resized.
  *
+ * To choose the allocator at runtime (e.g. a per-level arena or a tracking
+ * allocator), pass an RL_Allocator to the "rl_*_create_ex" variants. Passing
+ * NULL uses the RL_MALLOC & RL_FREE macros. A simple bump arena (rl_arena) and
+ * a fixed-size block pool (rl_pool) are provided:
+ *
+ *  RL_Arena arena = rl_arena_create(1024*1024);
+ *  RL_Allocator allocator = rl_arena_allocator(&arena);
+ *  RL_Graph graph = rl_graph_create_ex(map.width, map.height, NULL, &allocator);
+ *  ....
+ *  rl_arena_reset(&arena); // "frees" everything allocated from the arena at once
+ *  rl_arena_destroy(arena);
+ *
  * Make sure to define RL_IMPLEMENTATION once and only once before including
  * "roguelike.h" to compile the library.
  *
@@ -68,6 +80,19 @@
  *  while ((r = rl_heap_pop(eq))) { ... }
  *  rl_heap_destroy(q);
  *
+ * For turn order there is an actor scheduler (rl_scheduler) - each actor is
+ * rescheduled after it acts, with a delay based on its speed:
+ *
+ *  RL_Scheduler *s = rl_scheduler_create(64, 64);
+ *  RL_SchedulerHandle h = rl_scheduler_insert(s, &player, 0);
+ *  ....
+ *  while ((h = rl_scheduler_next(s)) != RL_SCHEDULER_INVALID) {
+ *    Actor *actor = rl_scheduler_actor(s, h);
+ *    unsigned int cost = act(actor);
+ *    rl_scheduler_reschedule(s, h, rl_scheduler_delay(cost, actor->speed));
+ *  }
+ *  rl_scheduler_destroy(s);
+ *
  * There is also a set of FOV functions - these functions use a simple
  * shadowcasting algorithm to implement FOV. Create the RL_FOV struct with
  * rl_fov_create (making sure to free it with rl_fov_destroy), and each time
@@ -117,10 +142,12 @@
  * Preprocessor definitions (define these before including roguelike.h to customize internals):
  *
  *  RL_IMPLEMENTATION                 Define this to compile the library - should only be defined once in one file
+ *  RL_HEAP_ARITY                     Amount of children for each node in the rl_heap (defaults to 4).
+ *  RL_HEAP_ALIGNMENT                 Alignment in bytes of the children of the rl_heap root, should be the size of a cache line (defaults to 64).
  *  RL_MAX_NEIGHBOR_COUNT             Maximum neighbor count for Dijkstra graphs (defaults to 8). Used in the rl_graph_* functions so we avoid malloc'ing every time we need to look up neighbors.
  *  RL_GRAPH_POINT_STRUCT             Point struct used in rl_graph_* functions. Set to either RL_Point3d or RL_Point2d. You can ignore this unless you want to support 3d pathfinding.
- *  RL_HEX_FLAT_TOP                   For hex grid pathfinding - set to 1 if you use flat top hexes, otherwise 0 for pointy top hexes.
- *  RL_HEX_ODD_OFFSET                 For hex grid pathfinding - set to 1 if you offset every *odd* row, otherwise set to 0 if you offset every *even* row.
+ *  RL_HEX_FLAT_TOP                   For hex grid pathfinding & mapgen - set to 1 if you use flat top hexes, otherwise 0 for pointy top hexes.
+ *  RL_HEX_ODD_OFFSET                 For hex grid pathfinding & mapgen - set to 1 if you offset every *odd* row, otherwise set to 0 if you offset every *even* row.
  *  RL_FOV_SYMMETRIC                  Set this to 0 to disable symmetric FOV (defaults to 1)
  *  RL_MAX_RECURSION                  Maximum recursion (defaults to 100). This is used in FOV to limit recursion when fov_radius is large or -1 (unlimited).
  *  RL_MAPGEN_BSP_RANDOMISE_ROOM_LOC  Set this to 0 to disable randomizing room locations within bsp (used in rl_mapgen_bsp - defaults to 1)
@@ -135,6 +162,14 @@
  *  RL_WALL_F                         Set this to your default is_wall function (defaults to rl_map_is_wall).
  *  RL_FOV_DISTANCE_F                 Set this to your default FOV distance function (defaults to rl_distance_euclidian).
  *  RL_RNG_F                          Set this to your default RNG generation function (defaults to rl_rng_generate). Parameters are expected to be inclusive.
+ *  RL_WEIGHTED_TABLE_RESOLUTION      Resolution of the probabilities in RL_WeightedTable (defaults to 32767) - must stay below the max of RL_RNG_F.
+ *  RL_CLOCK_US                       Macro function returning the current time in microseconds, used for time budgets (defaults to a monotonic clock - QueryPerformanceCounter or clock_gettime(CLOCK_MONOTONIC), falling back to "clock" where neither is available). With strict -std=c89/c99 on POSIX, define _POSIX_C_SOURCE to 199309L or greater before including the header to get clock_gettime - otherwise budgets are measured in processor time, summed over all threads.
+ *  RL_STATS                          Set this to 1 to count work done by the library (Dijkstra expansions, heap operations, allocations, etc.), see rl_stats_snapshot (defaults to 0).
+ *  RL_THREAD_LOCAL                   Storage class used for the RL_STATS counters (defaults to the compiler's thread local storage if available).
+ *  RL_TRACE                          Set this to 1 to record the major library operations in the Chrome trace event format, see rl_trace_start (defaults to 0). The recorder is global - only trace from one thread at a time unless you're using OpenMP.
+ *  RL_TRACE_BEGIN                    Macro function called with the name of an operation when it starts - define this (along with RL_TRACE_END) to forward the events to your own profiler.
+ *  RL_TRACE_END                      Macro function called with the name of an operation when it finishes.
+ *  RL_TRACE_CLOCK                    Macro function returning the current time in microseconds for the RL_TRACE recorder (defaults to RL_CLOCK_US).
  *  RL_ASSERT                         Define this to override the assert function used by the library (defaults to "assert")
  *  RL_MALLOC                         Define this to override the malloc function used by the library (defaults to "malloc")
  *  RL_CALLOC                         Define this to override the calloc function used by the library (defaults to "calloc")
@@ -192,6 +227,22 @@ typedef struct RL_Map {
     RL_Byte *tiles; /* a sequential array of RL_Tiles, stride for each row equals the map width. */
 } RL_Map;
 
+/* Rectangular area of a map (e.g. a room). */
+typedef struct {
+    unsigned int x;
+    unsigned int y;
+    unsigned int width;
+    unsigned int height;
+} RL_Rect;
+
+/* Runtime allocator passed to the rl_*_create_ex functions. Pass NULL in place of an allocator to use RL_MALLOC &
+ * RL_FREE. Note that the allocator is referenced (not copied) so it must outlive the memory allocated with it. */
+typedef struct RL_Allocator {
+    void *(*alloc_f)(void *user, size_t size); /* returns NULL when out of memory */
+    void (*free_f)(void *user, void *ptr);     /* can be NULL if memory is released all at once (e.g. an arena) */
+    void *user;                                /* passed to alloc_f & free_f */
+} RL_Allocator;
+
 /* BSP tree */
 typedef struct RL_BSP {
     unsigned int width;
@@ -201,6 +252,7 @@ typedef struct RL_BSP {
     struct RL_BSP *parent;
     struct RL_BSP *left;  /* left child */
     struct RL_BSP *right; /* right child */
+    const RL_Allocator *allocator; /* allocator for this node - children created with rl_bsp_split inherit it */
 } RL_BSP;
 
 /* BSP split direction */
@@ -216,7 +268,8 @@ typedef enum {
     RL_ErrorInvalidParameter,
     RL_ErrorMapgenInvalidConfig,
     RL_ErrorNotFound,
-    RL_ErrorRecursion
+    RL_ErrorRecursion,
+    RL_ErrorCancelled /* work was cancelled before it finished (e.g. by the tasks in roguelike_coro.hpp) */
 } RL_Status;
 
 /**
@@ -234,6 +287,13 @@ RL_Map rl_map_create(unsigned int width, unsigned int height);
 /* Frees the map & internal memory. */
 void rl_map_destroy(RL_Map map);
 
+/* Same as rl_map_create but allocates the tiles with the passed allocator. The allocator isn't stored in the map (the
+ * map struct is written as-is by rl_file_save_map), so make sure to free the map with rl_map_destroy_ex. */
+RL_Map rl_map_create_ex(unsigned int width, unsigned int height, const RL_Allocator *allocator);
+
+/* Frees a map created with rl_map_create_ex. */
+void rl_map_destroy_ex(RL_Map map, const RL_Allocator *allocator);
+
 /* Enum representing the type of corridor connection algorithm to connect the BSP graph of rooms with.
  * RL_ConnectRandomly is the default and results in the most interesting & aesthetic maps. */
 typedef enum {
@@ -331,6 +391,55 @@ RL_Status rl_mapgen_automata_generate_rooms(RL_Map map, unsigned int offset_x, u
                                             unsigned int chance_cell_initialized, unsigned int birth_threshold, unsigned int survival_threshold,
                                             unsigned int max_iterations, bool fill_border);
 
+/* Stages of the resumable automata generator, in order. */
+typedef enum {
+    RL_MapgenAutomataInitialize = 0, /* randomly fill the map with rock */
+    RL_MapgenAutomataIterate,        /* cellular automata iterations */
+    RL_MapgenAutomataBorder,         /* fill the border with rock */
+    RL_MapgenAutomataConnectStart,   /* floodfill from the first passable tile */
+    RL_MapgenAutomataConnect,        /* dig corridors to unconnected caves */
+    RL_MapgenAutomataCullScan,       /* floodfill each cave to find the largest */
+    RL_MapgenAutomataCull,           /* fill the unconnected caves with rock */
+    RL_MapgenAutomataDone
+} RL_MapgenAutomataStage;
+
+/* Resumable automata generator - generates the same map as rl_mapgen_automata but can be spread across multiple
+ * frames:
+ *
+ *   RL_MapgenAutomata gen;
+ *   rl_mapgen_automata_begin(&gen, map, RL_MAPGEN_AUTOMATA_DEFAULTS);
+ *   ....
+ *   if (rl_mapgen_automata_step_us(&gen, 2000)) { // once per frame, returns true when finished
+ *     if (gen.status != RL_OK) printf("Error occurred during mapgen!\n");
+ *   }
+ *
+ * The map must not be modified until generation is finished. */
+typedef struct RL_MapgenAutomata {
+    RL_Map map;
+    RL_MapgenConfigAutomata config;
+    RL_MapgenAutomataStage stage;
+    RL_Status status;          /* RL_OK unless generation failed (check this when finished) */
+    unsigned int iteration;    /* cellular automata iterations completed */
+    unsigned int x, y;         /* position within the current stage */
+    struct RL_GraphNode *floodfill; /* connected area (connect stage) or largest area found so far (cull stage) */
+    size_t floodfill_size;     /* tiles in the largest area found so far */
+    RL_Byte *visited;          /* tiles floodfilled in the cull stage */
+} RL_MapgenAutomata;
+
+/* Starts a resumable automata generator. Nothing is generated until rl_mapgen_automata_step is called. */
+RL_Status rl_mapgen_automata_begin(RL_MapgenAutomata *gen, RL_Map map, RL_MapgenConfigAutomata config);
+
+/* Advances generation by roughly work_budget units of work (a unit is a tile in the automata stages or a Dijkstra node
+ * when connecting & culling caves - each corridor or floodfill is done at once so a step may overshoot the budget).
+ * Returns true when generation is finished - generation state is freed automatically at this point. */
+bool rl_mapgen_automata_step(RL_MapgenAutomata *gen, unsigned long work_budget);
+
+/* Same as above but advances generation until roughly budget_us microseconds have passed (see RL_CLOCK_US). */
+bool rl_mapgen_automata_step_us(RL_MapgenAutomata *gen, unsigned long budget_us);
+
+/* Frees the generator state - only needed if generation is abandoned before it is finished. */
+void rl_mapgen_automata_end(RL_MapgenAutomata *gen);
+
 /* Generate map with a random maze (via simplistic BFS). Tiles are carved with RL_TileCorridor. Fully connected. */
 RL_Status rl_mapgen_maze(RL_Map map);
 
@@ -352,6 +461,47 @@ RL_Status rl_mapgen_connect_unconnected_rooms(RL_Map map, bool draw_doors);
 /* Cull/remove unconnected rooms - keeps the largest room and fills the rest with rock.  */
 RL_Status rl_mapgen_cull_unconnected_rooms(RL_Map map);
 
+/* Hex map generation - same as the generators above for hex maps, using the 6 hex neighbors of each tile instead of
+ * the 8 (or 4) square neighbors. Tiles are stored in offset coordinates like any other RL_Map (convert with
+ * rl_point_axial for hex pathfinding) & the neighbors are looked up in an offset table for the parity of the row (or
+ * column with RL_HEX_FLAT_TOP), see RL_HEX_ODD_OFFSET. These don't require RL_ENABLE_PATHFINDING. */
+
+/* Provide some defaults for hex automata mapgen - the thresholds are out of 6 neighbors. */
+#define RL_MAPGEN_AUTOMATA_HEX_DEFAULTS RL_CLITERAL(RL_MapgenConfigAutomata) { \
+    /*.chance_cell_initialized =*/  45, \
+    /*.birth_threshold =*/          4, \
+    /*.survival_threshold =*/       3, \
+    /*.max_iterations =*/           3, \
+    /*.draw_corridors = */          true, \
+    /*.cull_unconnected =*/         true, \
+    /*.fill_border =*/              true \
+}
+
+/* Generate a hex map with cellular automata, counting the 6 hex neighbors. Unconnected caves are connected with
+ * rl_mapgen_connect_corridor_hex & culled by hex floodfill. */
+RL_Status rl_mapgen_automata_hex(RL_Map map, RL_MapgenConfigAutomata config);
+
+/* Generate a hex map with a random maze (growing tree) - a tile is only carved if it touches a single passage, so the
+ * maze is fully connected without loops. Tiles are carved with RL_TileCorridor. */
+RL_Status rl_mapgen_maze_hex(RL_Map map);
+
+/* Same as above within the region of the map. */
+RL_Status rl_mapgen_maze_hex_ex(RL_Map map, unsigned int x, unsigned int y, unsigned int width, unsigned int height);
+
+/* Generate a hex map with the recursive BSP split algorithm, connecting the rooms with rl_mapgen_connect_corridor_hex.
+ * Use RL_ConnectBSP to guarantee every room is connected - with RL_ConnectRandomly a few rooms might only connect to
+ * each other (crossing corridors don't always join on a hex grid). */
+RL_Status rl_mapgen_bsp_hex(RL_Map map, RL_MapgenConfigBSP config);
+
+/* Same as above function but preserves the BSP tree that contains the rooms */
+RL_Status rl_mapgen_bsp_hex_ex(RL_Map map, RL_BSP *bsp, RL_MapgenConfigBSP config);
+
+/* Same as rl_mapgen_connect_corridors, connecting with rl_mapgen_connect_corridor_hex. */
+RL_Status rl_mapgen_connect_corridors_hex(RL_Map map, RL_BSP *root, bool draw_doors, RL_MapgenCorridorConnection connection_algorithm);
+
+/* Connect map point to another map point via a straight corridor of hex steps. */
+RL_Status rl_mapgen_connect_corridor_hex(RL_Map map, unsigned int from_x, unsigned int from_y, unsigned int to_x, unsigned int to_y, bool draw_doors);
+
 /**
  * Generic map helper functions.
  */
@@ -399,15 +549,53 @@ bool rl_map_is_room_wall(const RL_Map map, unsigned int x, unsigned int y);
 /* A wall that is touching a room tile (e.g. to display it lit). */
 RL_Byte rl_map_room_wall(const RL_Map map, unsigned int x, unsigned int y);
 
+/* Per tile flags set by rl_map_analyze - bitmasked together (e.g. to place doors, traps & guards). */
+typedef enum {
+    RL_AnalysisArticulation = 1,      /* removing the tile disconnects the passable tiles */
+    RL_AnalysisBridge       = 1 << 1, /* one end of a bridge - a step that is the only connection between two areas */
+    RL_AnalysisNarrow       = 1 << 2, /* on the middle line of a passage with clearance <= max_clearance */
+    RL_AnalysisChokepoint   = 1 << 3  /* narrow tile next to a wider area - e.g. the mouth of a corridor */
+} RL_AnalysisFlag;
+
+/* Connectivity analysis of the passable tiles of a map (8 way movement, see RL_PASSABLE_F). */
+typedef struct {
+    unsigned int width;
+    unsigned int height;
+    RL_Byte *flags;     /* bitmask of RL_AnalysisFlag for each tile, stride for each row = the map width */
+    RL_Byte *clearance; /* distance transform - steps to the nearest impassable tile or map edge (0 for impassable, max 255) */
+    const RL_Allocator *allocator; /* allocator for the tiles & the scratch memory of rl_map_analyze (NULL for RL_MALLOC & RL_FREE) */
+} RL_MapAnalysis;
+
+/* Allocates the analysis for a map of this size. Make sure to call rl_map_analysis_destroy to clear memory. */
+RL_MapAnalysis rl_map_analysis_create(unsigned int width, unsigned int height);
+
+/* Same as above but allocates the analysis with the passed allocator. */
+RL_MapAnalysis rl_map_analysis_create_ex(unsigned int width, unsigned int height, const RL_Allocator *allocator);
+
+/* Frees the analysis & internal memory. */
+void rl_map_analysis_destroy(RL_MapAnalysis analysis);
+
+/* Finds the articulation points & bridges of the passable tiles (iterative Tarjan - no recursion limit) along with the
+ * narrow passages & chokepoints from the distance transform. A max_clearance of 1 flags passages 1 or 2 tiles wide, 2
+ * flags up to 4 tiles wide, etc. */
+RL_Status rl_map_analyze(RL_MapAnalysis analysis, const RL_Map map, unsigned int max_clearance);
+
+/* Returns the RL_AnalysisFlag bitmask for the tile (0 if out of bounds). */
+RL_Byte rl_map_analysis_flags(const RL_MapAnalysis analysis, unsigned int x, unsigned int y);
+
 /**
  * Simple priority queue implementation
  */
 
+/* The heap is a d-ary heap (see RL_HEAP_ARITY) - the item array is aligned so that each group of siblings fits within
+ * one cache line (with 4 children & 8 byte pointers a group is 32 bytes, two groups to a 64 byte line). */
 typedef struct {
     void **heap;
     int cap;
     int len;
     int (*comparison_f)(const void *heap_item_a, const void *heap_item_b);
+    void *memory; /* raw allocation backing the heap array (heap is aligned within this memory) */
+    const RL_Allocator *allocator; /* NULL for RL_MALLOC & RL_FREE */
 } RL_Heap;
 
 /* Allocates memory for the heap. Make sure to call rl_heap_destroy after you are done.
@@ -418,6 +606,9 @@ typedef struct {
  *  but order will be undefined. */
 RL_Heap *rl_heap_create(int capacity, int (*comparison_f)(const void *heap_item_a, const void *heap_item_b));
 
+/* Same as above but allocates the heap with the passed allocator. */
+RL_Heap *rl_heap_create_ex(int capacity, int (*comparison_f)(const void *heap_item_a, const void *heap_item_b), const RL_Allocator *allocator);
+
 /* Frees the heap & internal memory. */
 void rl_heap_destroy(RL_Heap *h);
 
@@ -433,6 +624,190 @@ void *rl_heap_pop(RL_Heap *h);
 /* Peek at the first item in the queue. This does not remove the item from the queue. */
 void *rl_heap_peek(RL_Heap *h);
 
+/* Insert an array of items into the heap. When the amount of items is large compared to the current length of the heap
+ * the heap is rebuilt in O(n) rather than inserting each item individually. This will resize the heap if necessary.
+ * Useful for seeding a queue with multiple sources. */
+bool rl_heap_insert_bulk(RL_Heap *h, void **items, int count);
+
+/* Restore the heap ordering in O(n). Call this after changing the priority of many items already in the heap. */
+void rl_heap_heapify(RL_Heap *h);
+
+/**
+ * Actor scheduler - a turn queue ordered by the time each actor acts next
+ */
+
+/* Handle to a scheduled actor. Handles stay valid until the actor is removed (they are reused afterwards). */
+typedef int RL_SchedulerHandle;
+
+#define RL_SCHEDULER_INVALID ((RL_SchedulerHandle) -1)
+
+typedef struct {
+    void *actor;
+    unsigned long time;     /* time the actor acts next */
+    unsigned long sequence; /* actors scheduled for the same time act in the order they were (re)scheduled */
+    int index;              /* position in the overflow heap, -1 if in the timing wheel, -2 if unused */
+    int prev;               /* previous actor in the wheel bucket */
+    int next;               /* next actor in the wheel bucket (or in the free list if unused) */
+} RL_SchedulerEntry;
+
+/* Actors are kept in a d-ary heap (see RL_HEAP_ARITY) indexed by handle, so they can be rescheduled or removed in
+ * O(log n). With a timing wheel, actors scheduled less than wheel_size ticks ahead go in a FIFO bucket for their time
+ * instead (O(1) insert, reschedule & remove), only longer delays go in the heap. */
+typedef struct {
+    RL_SchedulerEntry *entries; /* indexed by handle */
+    RL_SchedulerHandle *heap;   /* overflow heap ordered by time then sequence */
+    RL_SchedulerHandle *wheel;  /* first & last handle of each wheel bucket (wheel_size * 2) */
+    int cap;                    /* capacity of entries & heap */
+    int entries_len;            /* amount of entries used so far (scheduled or in the free list) */
+    int heap_len;
+    int wheel_len;              /* amount of actors in the wheel */
+    int len;                    /* amount of scheduled actors */
+    int free_list;              /* first unused entry */
+    unsigned int wheel_size;    /* amount of wheel buckets (0 for no wheel) */
+    unsigned long now;          /* time of the current actor (see rl_scheduler_next) */
+    unsigned long sequence;
+    const RL_Allocator *allocator; /* NULL for RL_MALLOC & RL_FREE */
+} RL_Scheduler;
+
+/* Allocates the scheduler. Make sure to call rl_scheduler_destroy after you are done.
+ *
+ * capacity - initial capacity for the amount of actors (grows as needed)
+ * wheel_size - amount of buckets in the timing wheel, must be 0 (no wheel) or a power of 2. Use a size larger than
+ *  the common action delays (e.g. 64 for actions of 1-20 ticks). */
+RL_Scheduler *rl_scheduler_create(int capacity, unsigned int wheel_size);
+
+/* Same as above but allocates the scheduler with the passed allocator. */
+RL_Scheduler *rl_scheduler_create_ex(int capacity, unsigned int wheel_size, const RL_Allocator *allocator);
+
+/* Frees the scheduler (the actors are not freed). */
+void rl_scheduler_destroy(RL_Scheduler *s);
+
+/* Return the amount of scheduled actors. */
+int rl_scheduler_length(const RL_Scheduler *s);
+
+/* Schedules the actor to act delay ticks after the current time. Returns RL_SCHEDULER_INVALID if out of memory. */
+RL_SchedulerHandle rl_scheduler_insert(RL_Scheduler *s, void *actor, unsigned long delay);
+
+/* Moves the actor to act delay ticks after the current time, behind actors already scheduled for that time. */
+bool rl_scheduler_reschedule(RL_Scheduler *s, RL_SchedulerHandle handle, unsigned long delay);
+
+/* Removes the actor from the scheduler, returning the actor. The handle is invalid afterwards. */
+void *rl_scheduler_remove(RL_Scheduler *s, RL_SchedulerHandle handle);
+
+/* Returns the handle of the next actor to act & advances the current time to when it acts, or RL_SCHEDULER_INVALID
+ * if no actors are scheduled. The actor stays in the scheduler - reschedule it with the delay of its action (or
+ * remove it), otherwise it acts again. */
+RL_SchedulerHandle rl_scheduler_next(RL_Scheduler *s);
+
+/* Return the actor for the handle. */
+void *rl_scheduler_actor(const RL_Scheduler *s, RL_SchedulerHandle handle);
+
+/* Returns the delay in ticks of an action costing cost energy for an actor gaining speed energy per tick (rounded
+ * up, at least 1 tick). E.g. an actor with speed 20 takes 5 ticks for a 100 energy action, speed 50 takes 2 ticks. */
+unsigned long rl_scheduler_delay(unsigned int cost, unsigned int speed);
+
+/**
+ * Occupancy index - which entities are on each tile
+ */
+
+typedef struct {
+    unsigned int x, y;
+    int prev; /* previous entity on the same tile (-1 if first, -2 if not inserted) */
+    int next; /* next entity on the same tile (-1 if last) */
+} RL_OccupancyEntity;
+
+/* Per tile linked lists of entity ids, so entities can be inserted, moved & removed in O(1). Entity ids are your own
+ * (e.g. the index in your entity array), the index grows to fit the largest id. Use with rl_graph_score_occupancy to
+ * path around (or through) other entities. */
+typedef struct RL_Occupancy {
+    unsigned int width, height;
+    int *heads;                   /* first entity on each tile (-1 if unoccupied) */
+    unsigned int *counts;         /* amount of entities on each tile */
+    RL_OccupancyEntity *entities; /* indexed by entity id */
+    int capacity;                 /* amount of entity ids */
+    const RL_Allocator *allocator; /* NULL for RL_MALLOC & RL_FREE */
+} RL_Occupancy;
+
+/* Creates the index for a map of width & height with room for entity ids up to capacity - 1. Make sure to call
+ * rl_occupancy_destroy to clear memory. */
+RL_Occupancy rl_occupancy_create(unsigned int width, unsigned int height, int capacity);
+
+/* Same as above but allocates the index (and grows it) with the passed allocator. */
+RL_Occupancy rl_occupancy_create_ex(unsigned int width, unsigned int height, int capacity, const RL_Allocator *allocator);
+
+/* Frees the occupancy index memory. */
+void rl_occupancy_destroy(RL_Occupancy occupancy);
+
+/* Removes all entities from the index. */
+void rl_occupancy_clear(RL_Occupancy *occupancy);
+
+/* Inserts the entity at x, y. Returns false if the entity is already inserted, x & y are out of bounds, or if out of
+ * memory. */
+bool rl_occupancy_insert(RL_Occupancy *occupancy, int id, unsigned int x, unsigned int y);
+
+/* Moves an inserted entity to x, y. Returns false if the entity isn't inserted or x & y are out of bounds. */
+bool rl_occupancy_move(RL_Occupancy *occupancy, int id, unsigned int x, unsigned int y);
+
+/* Removes the entity from the index (does nothing if it isn't inserted). */
+void rl_occupancy_remove(RL_Occupancy *occupancy, int id);
+
+/* Returns the amount of entities on the tile. */
+unsigned int rl_occupancy_count(const RL_Occupancy *occupancy, unsigned int x, unsigned int y);
+
+/* Returns the first entity on the tile, or -1 if the tile is unoccupied. */
+int rl_occupancy_first(const RL_Occupancy *occupancy, unsigned int x, unsigned int y);
+
+/* Returns the next entity on the same tile as the entity, or -1 if there are no more. */
+int rl_occupancy_next(const RL_Occupancy *occupancy, int id);
+
+/**
+ * Allocators - see RL_Allocator
+ */
+
+/* Simple bump allocator. Memory is never freed individually, instead the whole arena is reset at once (e.g. after
+ * generating a level). Allocation fails when the arena is full. */
+typedef struct RL_Arena {
+    unsigned char *memory;
+    size_t size;
+    size_t used;
+} RL_Arena;
+
+/* Allocates the arena memory with RL_MALLOC. Make sure to call rl_arena_destroy to clear memory. */
+RL_Arena rl_arena_create(size_t size);
+
+/* Frees the arena memory. */
+void rl_arena_destroy(RL_Arena arena);
+
+/* Releases everything allocated from the arena. */
+void rl_arena_reset(RL_Arena *arena);
+
+/* Returns an allocator that allocates from the arena. */
+RL_Allocator rl_arena_allocator(RL_Arena *arena);
+
+/* Pool of fixed-size blocks with a free list, useful for many small allocations of the same size (e.g. RL_BSP nodes
+ * or RL_Path nodes). Blocks are allocated in chunks with RL_MALLOC (or the pool's allocator), allocating more chunks as
+ * needed. */
+typedef struct RL_Pool {
+    size_t block_size;
+    size_t blocks_per_chunk;
+    void *free_list;  /* linked list of free blocks */
+    void *chunks;     /* linked list of allocated chunks */
+    const RL_Allocator *allocator; /* NULL for RL_MALLOC & RL_FREE */
+} RL_Pool;
+
+/* Creates a pool of blocks of block_size bytes. Allocations larger than block_size fail. Make sure to call
+ * rl_pool_destroy to clear memory. */
+RL_Pool rl_pool_create(size_t block_size, size_t blocks_per_chunk);
+
+/* Same as above but allocates the chunks with the passed allocator. */
+RL_Pool rl_pool_create_ex(size_t block_size, size_t blocks_per_chunk, const RL_Allocator *allocator);
+
+/* Frees all the chunks of the pool. */
+void rl_pool_destroy(RL_Pool pool);
+
+/* Returns an allocator that allocates from the pool. */
+RL_Allocator rl_pool_allocator(RL_Pool *pool);
+
 /**
  * BSP Manipulation
  */
@@ -440,6 +815,9 @@ void *rl_heap_peek(RL_Heap *h);
 /* Params width & height must be positive. Make sure to free with rl_bsp_destroy. */
 RL_BSP *rl_bsp_create(unsigned int width, unsigned int height);
 
+/* Same as above but allocates the BSP (and all of its children) with the passed allocator. */
+RL_BSP *rl_bsp_create_ex(unsigned int width, unsigned int height, const RL_Allocator *allocator);
+
 /* Frees the BSP root & all children */
 void rl_bsp_destroy(RL_BSP *root);
 
@@ -513,6 +891,7 @@ typedef struct RL_Graph {
     size_t length; /* length of nodes */
     RL_GraphNode *nodes; /* array of nodes - length will be the size of the map.width * map.height */
     RL_NeighborsFun neighbors; /* function to retrieve array of connected neighbors from given node */
+    const RL_Allocator *allocator; /* allocator for the nodes & scoring (NULL for RL_MALLOC & RL_FREE) */
 } RL_Graph;
 
 /* A path is a linked list of paths. You can "walk" a path using rl_path_walk which will simultaneously free the
@@ -520,6 +899,7 @@ typedef struct RL_Graph {
 typedef struct RL_Path {
     RL_Point point;
     struct RL_Path *next;
+    const RL_Allocator *allocator; /* allocator this part of the path was allocated with */
 } RL_Path;
 
 /* Useful distance functions for pathfinding. */
@@ -560,13 +940,20 @@ unsigned int rl_axial_to_map_y(RL_Point axial);
 /* Generates a line starting at from ending at to. Each path in the line will be incremented by step. */
 RL_Path *rl_line_create(RL_Point from, RL_Point to, float step);
 
+/* Same as above but allocates the path with the passed allocator. */
+RL_Path *rl_line_create_ex(RL_Point from, RL_Point to, float step, const RL_Allocator *allocator);
+
 /* Find a path between start and end via Dijkstra algorithm. Make sure to call rl_path_destroy when done with path.
  * Pass NULL to score_f to use rough approximation for euclidian.
  * Pass NULL to neighbors_f to allow diagonal paths. */
 RL_Path *rl_path_create(const RL_Map map, RL_Point start, RL_Point end, RL_ScoreFun score_f, RL_NeighborsFun neighbors_f);
 
+/* Same as above but allocates the path and the temporary Dijkstra graph (its nodes & scoring heap) with the passed
+ * allocator, so the allocator must serve map sized blocks - e.g. an arena, not an rl_pool sized for the path nodes. */
+RL_Path *rl_path_create_ex(const RL_Map map, RL_Point start, RL_Point end, RL_ScoreFun score_f, RL_NeighborsFun neighbors_f, const RL_Allocator *allocator);
+
 /* Find a path between start and end via the scored Dijkstra graph. Make sure to call rl_path_destroy when done with path (or
- * use rl_path_walk). */
+ * use rl_path_walk). The path is allocated with the graph's allocator. */
 RL_Path *rl_path_create_from_graph(const RL_Graph graph, const RL_Map map, RL_Point start);
 
 /* Convenience function to "walk" the path. This will return the next path, freeing the current path. You do not need to
@@ -576,6 +963,345 @@ RL_Path *rl_path_walk(RL_Path *path);
 /* Frees the path & all linked nodes. */
 void rl_path_destroy(RL_Path *path);
 
+/* Incremental A* search - expands at most a given amount of nodes per rl_path_search_step so long searches can be
+ * spread across frames. The open set is kept between steps, and rl_path_search_path returns the path to the expanded
+ * node closest to the end while the search is still running (so agents can start moving right away):
+ *
+ *   RL_PathSearch *search = rl_path_search_create(map, start, end, NULL, NULL, NULL);
+ *   ....
+ *   rl_path_search_step(search, 256); // once per frame, returns true when finished
+ *   RL_Path *path = rl_path_search_path(search); // partial path until search->found
+ *   ....
+ *   rl_path_search_destroy(search);
+ */
+typedef struct RL_PathSearch {
+    RL_Map map;
+    RL_Point end;
+    RL_Graph graph;               /* score of each reached node is its distance from start (FLT_MAX if not reached) */
+    size_t *parents;              /* index of the previous node on the path for each reached node */
+    RL_Heap *open;                /* open set ordered by score + heuristic */
+    RL_Pool pool;                 /* memory for the open set entries */
+    RL_Allocator pool_allocator;
+    RL_ScoreFun score_f;
+    RL_DistanceFun heuristic_f;
+    size_t start_index;
+    size_t end_index;
+    size_t best_index;            /* expanded node with the lowest heuristic (the end once found) */
+    float best_heuristic;
+    size_t expansions;            /* nodes expanded so far */
+    bool finished;                /* the end was found or the open set is exhausted */
+    bool found;                   /* a path to the end was found */
+    const RL_Allocator *allocator; /* allocator for the search & its paths (NULL for RL_MALLOC & RL_FREE) */
+} RL_PathSearch;
+
+/* Starts an incremental A* search from start to end. Nothing is expanded until rl_path_search_step is called. Returns
+ * NULL on allocation failure or if start or end are outside of the map.
+ * Pass NULL to score_f to use rough approximation for euclidian.
+ * Pass NULL to neighbors_f to allow diagonal paths.
+ * Pass NULL to heuristic_f to use rl_distance_chebyshev - the heuristic must not overestimate the score of the path. */
+RL_PathSearch *rl_path_search_create(const RL_Map map, RL_Point start, RL_Point end, RL_ScoreFun score_f, RL_NeighborsFun neighbors_f, RL_DistanceFun heuristic_f);
+
+/* Same as above but allocates the search (graph, parents & open set) and the paths of rl_path_search_path with the
+ * passed allocator. The open set entries come from an internal rl_pool whose chunks are also taken from the allocator. */
+RL_PathSearch *rl_path_search_create_ex(const RL_Map map, RL_Point start, RL_Point end, RL_ScoreFun score_f, RL_NeighborsFun neighbors_f, RL_DistanceFun heuristic_f, const RL_Allocator *allocator);
+
+/* Expands up to max_expansions nodes. Returns true when the search is finished (check search->found). */
+bool rl_path_search_step(RL_PathSearch *search, size_t max_expansions);
+
+/* Returns the path from start to end if found, otherwise the path from start to the expanded node closest to the end.
+ * Make sure to call rl_path_destroy when done with path (or use rl_path_walk). */
+RL_Path *rl_path_search_path(const RL_PathSearch *search);
+
+/* Frees the search & internal memory. */
+void rl_path_search_destroy(RL_PathSearch *search);
+
+/**
+ * Scored open sets
+ */
+
+/* Entry in the open set of the multi-source searches (cooperative pathfinding, influence maps, room table, placement &
+ * autoexplore) - a binary min heap by score, with lazy deletion. */
+typedef struct {
+    float score;
+    size_t index;
+} RL_ScoredIndex;
+
+/**
+ * Cooperative pathfinding
+ */
+
+/* distance to a goal ignoring other agents - Reverse Resumable A* from the goal toward origin */
+typedef struct {
+    RL_Point goal;
+    RL_Point origin;            /* position of the first agent that needed the heuristic (orders the search) */
+    RL_Graph graph;             /* distance to the goal, exact once closed */
+    RL_Byte *closed;            /* 1 for each tile expanded so far */
+    RL_ScoredIndex *open;
+    size_t open_len;
+    size_t open_cap;
+    unsigned int turn;          /* last plan that used the heuristic - free to reuse for another goal after that */
+} RL_CoopHeuristic;
+
+typedef struct {
+    RL_Point position;          /* position at the start of the turn */
+    RL_Point goal;
+    size_t heuristic;           /* index of the heuristic for the goal in the planner */
+    RL_Point *path;             /* planned position for each turn (path[0] is position) */
+    size_t path_length;         /* amount of planned positions - the agent stays at the last one for the window */
+} RL_CoopAgent;
+
+/* slot in the space-time hash tables - key is the tile index & time */
+typedef struct {
+    size_t key;
+    size_t value;               /* agent for reservations, node for the search */
+    unsigned int generation;    /* slot is empty unless this matches the table's generation */
+} RL_CoopSlot;
+
+/* node of the space-time search */
+typedef struct {
+    unsigned int x, y, t;
+    float score;
+    size_t parent;
+} RL_CoopNode;
+
+/* Cooperative pathfinding for groups of agents (Windowed Hierarchical Cooperative A*). Each turn the agents are
+ * planned in order - each agent's path for the next window turns is searched in space-time (including waiting in place)
+ * against the paths reserved by the agents planned before it, then reserved itself. The heuristic is the true distance
+ * to the goal ignoring other agents, scored lazily with Reverse Resumable A* - a search backwards from the goal that is
+ * resumed only until the tiles the agents look up are reached. The heuristic of each goal is shared by the agents with
+ * that goal & kept across turns until no agent has that goal, so a group chasing a moving goal scores it once a turn,
+ * only as far out as the group:
+ *
+ *   RL_Coop *coop = rl_coop_create(map, agent_count, 8, NULL);
+ *   ....
+ *   rl_coop_set_agent(coop, i, position, goal); // for each agent, each turn
+ *   rl_coop_plan(coop);
+ *   RL_Point next = rl_coop_next(coop, i); // position after this turn
+ *   ....
+ *   rl_coop_destroy(coop);
+ */
+typedef struct RL_Coop {
+    RL_Map map;
+    RL_NeighborsFun neighbors_f;
+    unsigned int window;        /* turns planned ahead */
+    RL_CoopAgent *agents;
+    size_t agent_count;
+    RL_CoopHeuristic *heuristics; /* one per goal, at most agent_count */
+    size_t heuristics_len;
+    unsigned int turn;          /* plans so far */
+    RL_CoopSlot *reservations;  /* agent reserving each tile & time */
+    size_t reservations_cap;
+    unsigned int reservations_generation;
+    RL_CoopSlot *visited;       /* search node for each tile & time */
+    size_t visited_cap;
+    unsigned int visited_generation;
+    RL_CoopNode *nodes;
+    size_t nodes_len;
+    size_t nodes_cap;
+    RL_ScoredIndex *open;       /* open set ordered by score + heuristic */
+    size_t open_len;
+    size_t open_cap;
+    const RL_Allocator *allocator; /* NULL for RL_MALLOC & RL_FREE */
+} RL_Coop;
+
+/* Creates the planner (workspace & reservation table are reused each turn). Make sure to call rl_coop_destroy when
+ * done. The map must outlive the planner.
+ * Pass NULL to neighbors_f to allow diagonal movement. */
+RL_Coop *rl_coop_create(const RL_Map map, size_t agent_count, unsigned int window, RL_NeighborsFun neighbors_f);
+
+/* Same as above but allocates the planner (and grows its workspace) with the passed allocator. */
+RL_Coop *rl_coop_create_ex(const RL_Map map, size_t agent_count, unsigned int window, RL_NeighborsFun neighbors_f, const RL_Allocator *allocator);
+
+/* Sets the agent's current position & goal for the next rl_coop_plan. */
+void rl_coop_set_agent(RL_Coop *coop, size_t agent, RL_Point position, RL_Point goal);
+
+/* Plans the paths of all agents, agents earlier in the array have priority. Agents that are boxed in by other agents
+ * wait in place (as do agents that planned to move into their tile), so no two agents end a turn on the same tile. */
+RL_Status rl_coop_plan(RL_Coop *coop);
+
+/* Returns the planned position of the agent after this turn (the current position if waiting). */
+RL_Point rl_coop_next(const RL_Coop *coop, size_t agent);
+
+/* Frees the planner & agent memory. */
+void rl_coop_destroy(RL_Coop *coop);
+
+/* How the influence of a source falls off with the walking distance from it. */
+typedef enum {
+    RL_FalloffLinear = 0,  /* strength * (1 - distance / (radius + 1)) */
+    RL_FalloffInverse,     /* strength / (1 + distance) */
+    RL_FalloffConstant     /* strength */
+} RL_Falloff;
+
+/* A source of influence (e.g. a unit's threat). Influence spreads along the neighbors of the influence map up to radius
+ * walking distance away, as scored by its score function. */
+typedef struct {
+    unsigned int x, y;
+    float strength;        /* influence on the source tile - negative for e.g. enemy threat */
+    float radius;
+    RL_Falloff falloff;
+    double decay;          /* set by rl_influence_add - the decay of the map when the source was added */
+} RL_InfluenceSource;
+
+/* Influence map - the sum of the influence of each source added to it. Sources are added & removed incrementally, only
+ * touching the tiles within their radius:
+ *
+ *   RL_Influence *threat = rl_influence_create(map, NULL, NULL);
+ *   RL_InfluenceSource source = { .x = x, .y = y, .strength = 10, .radius = 8, .falloff = RL_FalloffLinear };
+ *   rl_influence_add(threat, &source);
+ *   ....
+ *   rl_influence_move(threat, &source, new_x, new_y); // when the unit moves
+ *   float value = rl_influence_value(threat, x, y);
+ *   ....
+ *   rl_influence_destroy(threat);
+ *
+ * The map must not change between adding & removing a source (rebuild the influence map with rl_influence_clear &
+ * rl_influence_add after e.g. opening a door), otherwise removing a source won't subtract what it added. */
+typedef struct RL_Influence {
+    RL_Map map;
+    float *values;            /* influence on each tile divided by the scale */
+    float scale;              /* decay not yet applied to the values */
+    double decay;             /* product of the decay factors since the map was cleared */
+    RL_Graph graph;           /* node scores hold the distance from the source being propagated */
+    RL_ScoreFun score_f;
+    unsigned int *visited;    /* distance is set when this matches the generation */
+    unsigned int generation;
+    RL_ScoredIndex *open;     /* open set ordered by distance */
+    size_t open_len;
+    size_t open_cap;
+    const RL_Allocator *allocator; /* NULL for RL_MALLOC & RL_FREE */
+} RL_Influence;
+
+/* Creates an influence map for the map. The map must outlive the influence map. Make sure to call
+ * rl_influence_destroy when done.
+ * Pass NULL to score_f to use rough approximation for euclidian.
+ * Pass NULL to neighbors_f to allow diagonal paths. */
+RL_Influence *rl_influence_create(const RL_Map map, RL_ScoreFun score_f, RL_NeighborsFun neighbors_f);
+
+/* Same as above but allocates the influence map (and grows its open set) with the passed allocator. */
+RL_Influence *rl_influence_create_ex(const RL_Map map, RL_ScoreFun score_f, RL_NeighborsFun neighbors_f, const RL_Allocator *allocator);
+
+/* Frees the influence map. */
+void rl_influence_destroy(RL_Influence *influence);
+
+/* Resets the influence of every tile to 0. */
+void rl_influence_clear(RL_Influence *influence);
+
+/* Adds the influence of the source to the tiles within its radius & records the current decay in the source. */
+RL_Status rl_influence_add(RL_Influence *influence, RL_InfluenceSource *source);
+
+/* Subtracts what is left of the influence of a source that was added with rl_influence_add (after any decay). */
+RL_Status rl_influence_remove(RL_Influence *influence, RL_InfluenceSource source);
+
+/* Moves an added source to x, y - subtracting its old influence & adding the new, only touching the tiles within its
+ * radius of either position. */
+RL_Status rl_influence_move(RL_Influence *influence, RL_InfluenceSource *source, unsigned int x, unsigned int y);
+
+/* Multiplies the influence of every tile by factor (e.g. 0.9 each turn for a fading "last seen" map). The factor is
+ * kept in the scale of the map rather than applied to every tile, so decaying is O(1). Sources added before decaying
+ * can still be removed or moved. A factor of 0 clears the map. */
+void rl_influence_decay(RL_Influence *influence, float factor);
+
+/* Returns the influence on the tile (0 if out of bounds). */
+float rl_influence_value(const RL_Influence *influence, unsigned int x, unsigned int y);
+
+/* Area of effect kernels for explosions, breath attacks & beams. The offsets around the origin are precomputed once per
+ * max radius (sorted by euclidian distance, along with the offset one step closer to the origin), so each query is a
+ * single pass over the offsets within radius, writing the affected tiles to the caller's buffer:
+ *
+ *   RL_AoeTable aoe = rl_aoe_table_create(10);
+ *   RL_Point tiles[512];
+ *   size_t count = rl_aoe_blast(&aoe, map, rl_point(x, y), 4, tiles, 512);
+ *   for (size_t i = 0; i < count; ++i) { ... }
+ *   ....
+ *   rl_aoe_table_destroy(aoe);
+ *
+ * Blasts & cones are occluded by opaque tiles (see RL_OPAQUE_F) - a tile is hit when the tile one step closer to the
+ * origin is hit & is not opaque, so the opaque tiles on the edge of the area (e.g. walls to damage) are included. The
+ * queries take the table by non-const pointer as they write the per query state to its hit scratch, so use one table
+ * per thread. */
+typedef struct {
+    unsigned int max_radius;
+    size_t length;
+    int *offsets;         /* x, y pairs sorted by distance - the first is the origin */
+    float *distances;
+    float *angles;        /* angle of each offset in radians (atan2) */
+    size_t *parents;      /* index of the offset one step closer to the origin */
+    RL_Byte *hit;         /* scratch - whether each offset was hit by the current query */
+    const RL_Allocator *allocator; /* NULL for RL_MALLOC & RL_FREE */
+} RL_AoeTable;
+
+/* Precomputes the offsets within max_radius. Returns an empty table (offsets set to NULL) on allocation failure. Make
+ * sure to call rl_aoe_table_destroy when done. */
+RL_AoeTable rl_aoe_table_create(unsigned int max_radius);
+
+/* Same as above but allocates the table with the passed allocator. */
+RL_AoeTable rl_aoe_table_create_ex(unsigned int max_radius, const RL_Allocator *allocator);
+
+/* Frees the table. */
+void rl_aoe_table_destroy(RL_AoeTable table);
+
+/* Writes the tiles within radius (up to the table's max_radius) of center that are reached by the blast to out, up to
+ * out_cap tiles. Returns the count of tiles written. */
+size_t rl_aoe_blast(RL_AoeTable *table, const RL_Map map, RL_Point center, float radius, RL_Point *out, size_t out_cap);
+
+/* Same as above but only the tiles within half_angle (in radians) of the direction from origin towards the target. */
+size_t rl_aoe_cone(RL_AoeTable *table, const RL_Map map, RL_Point origin, RL_Point target, float radius, float half_angle, RL_Point *out, size_t out_cap);
+
+/* Writes the tiles of a beam from origin through target (not including origin) to out, up to length tiles or out_cap.
+ * The beam stops before the first opaque tile. Returns the count of tiles written. */
+size_t rl_aoe_line(const RL_Map map, RL_Point origin, RL_Point target, unsigned int length, RL_Point *out, size_t out_cap);
+
+/* Room to room distances for strategic AI (e.g. which room to flee to, where to send reinforcements). A room is the
+ * room tiles (RL_TileRoom) within its rect, e.g. the BSP leaves after rl_mapgen_bsp. The table is precomputed with a
+ * Dijkstra sweep per room seeded from all of its exits at once (room tiles next to a passable tile outside the room,
+ * e.g. a door or corridor), so each query is O(1). The sweeps are independent & run in parallel when compiled with
+ * OpenMP (e.g. -fopenmp).
+ *
+ *   RL_RoomTable rooms = rl_room_table_create_bsp(map, bsp);
+ *   int from = rl_room_table_room(rooms, monster_x, monster_y);
+ *   int to = rl_room_table_room(rooms, player_x, player_y);
+ *   if (from >= 0 && to >= 0 && rl_room_table_distance(rooms, from, to) < 50) {
+ *       int next_room = rl_room_table_next(rooms, from, to); // head for the next room on the way
+ *       ....
+ *   }
+ *   rl_room_table_destroy(rooms);
+ */
+typedef struct {
+    size_t room_count;
+    unsigned int width, height;
+    int *rooms;       /* room id for each tile, -1 for tiles outside of the rooms */
+    float *distances; /* room_count * room_count walking distances from the exits of a room to the closest tile of another (FLT_MAX if unreachable) */
+    int *next_hops;   /* room_count * room_count first room entered walking from a room to another (-1 if unreachable) */
+    const RL_Allocator *allocator; /* NULL for RL_MALLOC & RL_FREE */
+} RL_RoomTable;
+
+/* Precomputes the table for the rooms within the rects - a tile in overlapping rects belongs to the first room. Returns
+ * an empty table (distances set to NULL) on allocation failure. Make sure to free with rl_room_table_destroy. */
+RL_RoomTable rl_room_table_create(const RL_Map map, const RL_Rect *rects, size_t room_count);
+
+/* Same as above but allocates the table & the sweep scratch memory with the passed allocator. With OpenMP the sweeps
+ * allocate from the worker threads, each call is made within an omp critical section. */
+RL_RoomTable rl_room_table_create_ex(const RL_Map map, const RL_Rect *rects, size_t room_count, const RL_Allocator *allocator);
+
+/* Same as above, with a room for each BSP leaf (in rl_bsp_next_leaf order). */
+RL_RoomTable rl_room_table_create_bsp(const RL_Map map, const RL_BSP *root);
+
+/* Same as above but allocates the table, the sweep scratch memory & the leaf rects with the passed allocator. */
+RL_RoomTable rl_room_table_create_bsp_ex(const RL_Map map, const RL_BSP *root, const RL_Allocator *allocator);
+
+/* Frees the room table & internal memory. */
+void rl_room_table_destroy(RL_RoomTable table);
+
+/* Returns the room of the tile or -1 if the tile isn't in a room. */
+int rl_room_table_room(const RL_RoomTable table, unsigned int x, unsigned int y);
+
+/* Returns the walking distance between the rooms - 0 for the same room, FLT_MAX if unreachable. */
+float rl_room_table_distance(const RL_RoomTable table, int from, int to);
+
+/* Returns the next room entered walking from a room to another - the destination when no other room is on the way,
+ * from itself if both rooms are the same & -1 if unreachable. */
+int rl_room_table_next(const RL_RoomTable table, int from, int to);
+
 /* Create pre-scored Dijkstra map from supplied RL_Map
  *
  * You can use Dijkstra maps for pathfinding, simple AI, and much more. As with all Dijkstra maps, you just walk the
@@ -593,6 +1319,9 @@ void rl_path_destroy(RL_Path *path);
  */
 RL_Graph rl_graph_create_scored(const RL_Map map, RL_Point start, RL_ScoreFun score_f, RL_NeighborsFun neighbors_f);
 
+/* Same as above but allocates the graph with the passed allocator (see rl_graph_create_ex). */
+RL_Graph rl_graph_create_scored_ex(const RL_Map map, RL_Point start, RL_ScoreFun score_f, RL_NeighborsFun neighbors_f, const RL_Allocator *allocator);
+
 /* Dijkstra pathfinding algorithm. Pass NULL to neighbors_f to score each of 8 passable (diagonal) neighbors for each
  * point.
  *
@@ -602,11 +1331,18 @@ RL_Graph rl_graph_create_scored(const RL_Map map, RL_Point start, RL_ScoreFun sc
  * Make sure to destroy the resulting RL_Graph with rl_graph_destroy. */
 RL_Graph rl_graph_create_from_map(const RL_Map map, RL_NeighborsFun neighbors_f);
 
+/* Same as above but allocates the graph with the passed allocator (see rl_graph_create_ex). */
+RL_Graph rl_graph_create_from_map_ex(const RL_Map map, RL_NeighborsFun neighbors_f, const RL_Allocator *allocator);
+
 /* Lower level version of above function. Creates graph without relying on internal map data struct.
  *
  * Make sure to destroy the resulting RL_Graph with rl_graph_destroy. */
 RL_Graph rl_graph_create(unsigned int map_width, unsigned int map_height, RL_NeighborsFun neighbors_f);
 
+/* Same as above but allocates the graph with the passed allocator. The allocator is stored in the graph & used for
+ * scoring and for paths created from the graph. */
+RL_Graph rl_graph_create_ex(unsigned int map_width, unsigned int map_height, RL_NeighborsFun neighbors_f, const RL_Allocator *allocator);
+
 /* Scores the graph with the Dijkstra algorithm.
  *
  * Params:
@@ -632,6 +1368,43 @@ void rl_graph_score(RL_Graph graph, const RL_Map map, RL_Point start, RL_ScoreFu
  */
 void rl_graph_score_with_context(RL_Graph graph, void *context, RL_Point start, RL_ScoreFun score_f);
 
+/* Scores the graph with the Dijkstra algorithm from every node that already has a score (the seeds) - e.g. to score
+ * from many goals at once, or from goals with a different starting cost. Reset the graph with rl_graph_reset & set the
+ * score of each seed node before calling this. */
+void rl_graph_score_seeded(RL_Graph graph, void *context, RL_ScoreFun score_f);
+
+/* Resumable Dijkstra scoring - scores the same as rl_graph_score_seeded but can be spread across multiple frames:
+ *
+ *   RL_GraphContext context = rl_graph_context(graph, map);
+ *   RL_GraphScorer scorer;
+ *   rl_graph_reset(graph);
+ *   rl_graph_node(graph, start)->score = 0;
+ *   rl_graph_scorer_begin(&scorer, graph, &context, NULL);
+ *   ....
+ *   if (rl_graph_scorer_step(&scorer, 4096)) { // once per frame, returns true when finished
+ *     ....
+ *   }
+ *
+ * The graph & context must not be modified until scoring is finished. */
+typedef struct RL_GraphScorer {
+    RL_Graph graph;
+    void *context;
+    RL_ScoreFun score_f;
+    RL_Heap *open;       /* nodes to expand, NULL once finished */
+    size_t expansions;   /* nodes expanded so far */
+} RL_GraphScorer;
+
+/* Starts scoring from every node that already has a score (the seeds). Nothing is expanded until rl_graph_scorer_step
+ * is called. Pass NULL to score_f to use approximation for euclidian distace. */
+RL_Status rl_graph_scorer_begin(RL_GraphScorer *scorer, RL_Graph graph, void *context, RL_ScoreFun score_f);
+
+/* Expands up to max_expansions nodes. Returns true when scoring is finished - the scorer memory is freed automatically
+ * at this point. */
+bool rl_graph_scorer_step(RL_GraphScorer *scorer, size_t max_expansions);
+
+/* Frees the scorer memory - only needed if scoring is abandoned before it is finished. */
+void rl_graph_scorer_end(RL_GraphScorer *scorer);
+
 /* Converts all points in graph from x, y coordinates to axial q, r (hex) coordinates */
 void rl_graph_convert_to_axial(RL_Graph graph);
 
@@ -644,6 +1417,31 @@ typedef struct RL_GraphContext {
 /* Generates the default Dijkstra context for scoring. */
 RL_GraphContext rl_graph_context(const RL_Graph graph, const RL_Map map);
 
+/* Context for rl_graph_score_occupancy. Starts with the RL_GraphContext so it can be passed to the default neighbor
+ * functions. */
+typedef struct RL_OccupancyContext {
+    RL_GraphContext graph_context;
+    const RL_Occupancy *occupancy;
+    int mover;           /* entity that is moving - it doesn't block itself (-1 for none) */
+    float occupied_cost; /* added to the score for each other entity on a tile, FLT_MAX to treat occupied tiles as blocked */
+} RL_OccupancyContext;
+
+/* Generates the context for rl_graph_score_occupancy. */
+RL_OccupancyContext rl_occupancy_context(const RL_Graph graph, const RL_Map map, const RL_Occupancy *occupancy, int mover, float occupied_cost);
+
+/* Score function avoiding occupied tiles (pass an RL_OccupancyContext to rl_graph_score_with_context). Same as the
+ * default score function, plus occupied_cost for each entity on the neighbor. Occupied tiles are left unscored when
+ * occupied_cost is FLT_MAX, so they are never walked by rl_path_create_from_graph. */
+float rl_graph_score_occupancy(void *context, const RL_GraphNode *current, const RL_GraphNode *neighbor);
+
+/* Same as rl_path_create, but avoids tiles occupied by entities other than the mover (see RL_OccupancyContext). The
+ * end is reachable even when occupied (e.g. to attack another entity). */
+RL_Path *rl_path_create_occupancy(const RL_Map map, const RL_Occupancy *occupancy, RL_Point start, RL_Point end, int mover, float occupied_cost);
+
+/* Same as above but allocates the path and the temporary Dijkstra graph (its nodes & scoring heap) with the passed
+ * allocator. */
+RL_Path *rl_path_create_occupancy_ex(const RL_Map map, const RL_Occupancy *occupancy, RL_Point start, RL_Point end, int mover, float occupied_cost, const RL_Allocator *allocator);
+
 /* Returns a the largest connected area (of passable tiles) on the map. Make sure to destroy the graph with
  * rl_graph_destroy after you are done. */
 RL_Graph rl_graph_floodfill_largest_area(const RL_Map map);
@@ -706,6 +1504,12 @@ RL_FOV rl_fov_create(unsigned int width, unsigned int height);
 /* Frees the FOV & internal memory. */
 void rl_fov_destroy(RL_FOV fov);
 
+/* Same as rl_fov_create but allocates with the passed allocator. Make sure to free with rl_fov_destroy_ex. */
+RL_FOV rl_fov_create_ex(unsigned int width, unsigned int height, const RL_Allocator *allocator);
+
+/* Frees a FOV created with rl_fov_create_ex. */
+void rl_fov_destroy_ex(RL_FOV fov, const RL_Allocator *allocator);
+
 /* Function to determine if a tile is within the range of the FOV. Returns true if point is in range. */
 typedef bool (*RL_IsInRangeFun)(unsigned int x, unsigned int y, void *context);
 /* Function to determine if a tile is considered Opaque for FOV calculation. Make sure you do bounds checking that the
@@ -732,6 +1536,94 @@ bool rl_fov_is_visible(const RL_FOV map, unsigned int x, unsigned int y);
 /* Checks if a point has been seen within FOV. Make sure to call rl_fov_calculate first. */
 bool rl_fov_is_seen(const RL_FOV map, unsigned int x, unsigned int y);
 
+/* Line of sight without a FOV - returns true if the target would be visible after rl_fov_calculate from x, y with the
+ * same fov_radius, following the same rules (including RL_FOV_SYMMETRIC). Only the octant of the target is scanned, up
+ * to the column of the target, & nothing is allocated. */
+bool rl_fov_can_see(const RL_Map map, unsigned int x, unsigned int y, unsigned int target_x, unsigned int target_y, int fov_radius);
+
+/* Same as above for many targets from one origin (e.g. every monster against the player) - each octant holding a
+ * target is scanned once, up to the farthest target in it. Sets visible[i] for each target. */
+RL_Status rl_fov_can_see_many(const RL_Map map, unsigned int x, unsigned int y, int fov_radius, const RL_Point *targets, size_t count, bool *visible);
+
+/* Autoexplore - requires RL_ENABLE_PATHFINDING & RL_ENABLE_FOV.
+ *
+ * Tracks the frontier (known passable tiles next to unknown passable tiles) as the FOV reveals the map, and walks to the
+ * nearest frontier tile with a search from the whole frontier that stops at the player - the cost of each step is
+ * proportional to the distance to the frontier rather than the size of the map:
+ *
+ *   RL_Explore *explore = rl_explore_create(map, fov, NULL, NULL);
+ *   ....
+ *   rl_fov_calculate(fov, map, player_x, player_y, 8);
+ *   rl_explore_update(explore, player_x, player_y, 8); // same args as rl_fov_calculate
+ *   RL_Point next;
+ *   if (rl_explore_next(explore, rl_point(player_x, player_y), &next) == RL_OK) {
+ *       // move the player to next
+ *   } // else RL_ErrorNotFound - the map is fully explored
+ *   ....
+ *   rl_explore_destroy(explore);
+ */
+typedef struct RL_Explore {
+    RL_Map map;
+    RL_FOV fov;
+    RL_Byte *known;           /* tiles seen by the FOV as of the last update */
+    int *frontier_index;      /* index of each tile in the frontier array, or -1 */
+    size_t *frontier;         /* unordered set of frontier tiles */
+    size_t frontier_length;
+    RL_Graph graph;           /* node scores hold the distance to the frontier, set when visited matches the generation */
+    RL_ScoreFun score_f;
+    unsigned int *visited;
+    unsigned int generation;
+    RL_ScoredIndex *open;
+    size_t open_len;
+    size_t open_cap;
+    const RL_Allocator *allocator; /* NULL for RL_MALLOC & RL_FREE */
+} RL_Explore;
+
+/* Creates the autoexplore helper for the map & FOV (both must outlive it). Tiles already seen in the FOV are added to the
+ * frontier. Make sure to call rl_explore_destroy when done.
+ * Pass NULL to score_f to use rough approximation for euclidian.
+ * Pass NULL to neighbors_f to allow diagonal paths. */
+RL_Explore *rl_explore_create(const RL_Map map, const RL_FOV fov, RL_ScoreFun score_f, RL_NeighborsFun neighbors_f);
+
+/* Same as above but allocates the helper (and grows its open set) with the passed allocator. */
+RL_Explore *rl_explore_create_ex(const RL_Map map, const RL_FOV fov, RL_ScoreFun score_f, RL_NeighborsFun neighbors_f, const RL_Allocator *allocator);
+
+/* Frees the autoexplore helper. */
+void rl_explore_destroy(RL_Explore *explore);
+
+/* Updates the frontier with the tiles revealed by rl_fov_calculate - only the tiles within fov_radius of x, y are
+ * checked. Pass a negative fov_radius to check the whole FOV (e.g. after loading a saved FOV). */
+RL_Status rl_explore_update(RL_Explore *explore, unsigned int x, unsigned int y, int fov_radius);
+
+/* Sets next to the first step towards the nearest frontier tile (walking through known passable tiles only). Returns
+ * RL_ErrorNotFound when no frontier tile is reachable, i.e. exploration is done. */
+RL_Status rl_explore_next(RL_Explore *explore, RL_Point from, RL_Point *next);
+
+/* Approach to range - requires RL_ENABLE_PATHFINDING & RL_ENABLE_FOV.
+ *
+ * Scores the graph for ranged attackers that want to stand at range with line of sight to the target (e.g. the
+ * player), rather than next to it. The search is seeded from every passable tile the target can see within range:
+ * tiles at range (range - 1 < distance <= range, see RL_FOV_DISTANCE_F) start at 0 and each tile closer than that
+ * costs 1 more, so attackers that are too close back off. Build it once per target each turn and share it with every
+ * ranged attacker - each one steps to its lowest scored neighbor while that is lower than its own tile:
+ *
+ *   RL_Graph approach = rl_graph_create_approach(map, rl_point(player_x, player_y), 6);
+ *   RL_GraphNode *node = rl_graph_node(approach, monster_position);
+ *   RL_GraphNode *next = rl_graph_node_lowest_neighbor(approach, map, node);
+ *   if (next && next->score < node->score) monster_position = next->point;
+ *   ....
+ *   rl_graph_destroy(approach);
+ *
+ * Returns an empty graph (nodes set to NULL) on failure. Make sure to destroy the graph with rl_graph_destroy. */
+RL_Graph rl_graph_create_approach(const RL_Map map, RL_Point target, float range);
+
+/* Same as above but allocates the graph & the FOV scratch with the passed allocator. */
+RL_Graph rl_graph_create_approach_ex(const RL_Map map, RL_Point target, float range, const RL_Allocator *allocator);
+
+/* Same as above, but scores an existing graph & uses the passed FOV (both the same size as the map) so nothing is
+ * allocated - the FOV is recalculated from the target. */
+RL_Status rl_graph_score_approach(RL_Graph graph, RL_FOV fov, const RL_Map map, RL_Point target, float range);
+
 /**
  * Random number generation
  */
@@ -761,55 +1653,321 @@ RL_Status rl_rng_map_point_matching(RL_Map map, void *context, RL_MatchesFun f,
 /* Returns RL_ErrorNotFound if tile not in map */
 RL_Status rl_rng_map_room_matching(RL_Map map, RL_BSP *bsp, void *context, RL_MatchesFun f, unsigned int *x, unsigned int *y);
 
-/**
- * Saving & Loading helper functions - to use these make sure to open the file beforehand in binary mode.
+/* Placement by walking distance - requires RL_ENABLE_PATHFINDING. Both functions score a single distance field from
+ * start (8 way movement through passable tiles, see RL_PASSABLE_F) & then select from it, so there are no retry loops.
+ * Only the reachable tiles matching f are picked (pass NULL to match all of them) - start is never picked:
  *
- * The file is a FILE pointer (void* so we don't have to depend on stdio).
+ *   // the down stairs in the farthest 10% of the level from the up stairs
+ *   rl_rng_map_percentile(map, up_stairs, 0.9f, 1.0f, NULL, NULL, &x, &y);
+ *   // treasure spread away from the entrance & from each other
+ *   RL_Point treasure[8];
+ *   size_t count = rl_rng_map_spread(map, up_stairs, NULL, is_room_tile, treasure, 8);
  */
 
-bool rl_file_save_map(const RL_Map data, void *file);
-bool rl_file_load_map(RL_Map *data, void *file);
-bool rl_file_save_fov(const RL_FOV data, void *file);
-bool rl_file_load_fov(RL_FOV *data, void *file);
-#endif /* RL_ROGUELIKE_H */
+/* Returns a random tile ranked between the percentiles by distance from start (0 the closest, 1 the farthest). Returns
+ * RL_ErrorNotFound if no tile matches. */
+RL_Status rl_rng_map_percentile(RL_Map map, RL_Point start, float min_percentile, float max_percentile, void *context, RL_MatchesFun f, unsigned int *x, unsigned int *y);
 
-#ifdef RL_IMPLEMENTATION
+/* Greedily maximizes the minimum distance across the points & start (farthest point sampling) - each point is the tile
+ * farthest from start & the previous points, ties are picked at random. Each point only rescores the tiles it is closer
+ * to. Returns the count of points placed - fewer than count when the matching tiles run out (or on allocation failure). */
+size_t rl_rng_map_spread(RL_Map map, RL_Point start, void *context, RL_MatchesFun f, RL_Point *points, size_t count);
 
-#include <stdlib.h>
-#include <stdint.h>
-#include <string.h>
-#include <limits.h>
+/* RNG function with a user context (e.g. a per level generator state) - returns a number from min to max inclusive. */
+typedef unsigned int (*RL_RngFun)(void *context, unsigned int min, unsigned int max);
 
-#ifndef RL_FOV_SYMMETRIC
-#define RL_FOV_SYMMETRIC 1
-#endif
+/* Weighted random table (e.g. for loot & monster spawns) - built once with Vose's alias method, each sample takes O(1)
+ * with 2 RNG draws no matter how many entries there are:
+ *
+ *   float weights[] = { 50, 30, 15, 5 }; // e.g. chance of rat, goblin, orc, troll
+ *   RL_WeightedTable monsters = rl_weighted_table_create(weights, 4);
+ *   size_t monster = rl_weighted_table_sample(monsters);
+ *   ....
+ *   rl_weighted_table_destroy(monsters);
+ *
+ * Probabilities are kept with a resolution of 1/RL_WEIGHTED_TABLE_RESOLUTION of an entry's column. */
+typedef struct {
+    size_t length;
+    unsigned int *thresholds; /* chance out of RL_WEIGHTED_TABLE_RESOLUTION to keep each column's entry */
+    size_t *aliases;          /* entry drawn for each column otherwise */
+    const RL_Allocator *allocator; /* NULL for RL_MALLOC & RL_FREE */
+} RL_WeightedTable;
 
-#ifndef RL_MAX_RECURSION
-#define RL_MAX_RECURSION 100
-#endif
+/* Builds the table from the weights of each entry (negative weights count as 0). Returns an empty table (thresholds set
+ * to NULL) if there is no positive weight, if length is above RAND_MAX (32767 on MSVC) or on allocation failure. Make
+ * sure to call rl_weighted_table_destroy. */
+RL_WeightedTable rl_weighted_table_create(const float *weights, size_t length);
 
-/* define this to 0 to put the rooms in the middle of the BSP leaf during dungeon generation */
-#ifndef RL_MAPGEN_BSP_RANDOMISE_ROOM_LOC
-#define RL_MAPGEN_BSP_RANDOMISE_ROOM_LOC 1
-#endif
+/* Same as above but allocates the table (and the scratch memory used while building it) with the passed allocator. */
+RL_WeightedTable rl_weighted_table_create_ex(const float *weights, size_t length, const RL_Allocator *allocator);
 
-/* define to 0 to disable pathfinding */
-#ifndef RL_ENABLE_PATHFINDING
-#define RL_ENABLE_PATHFINDING 1
-#endif
+/* Frees the table. */
+void rl_weighted_table_destroy(RL_WeightedTable table);
 
-/* define to 0 to disable FOV */
-#ifndef RL_ENABLE_FOV
-#define RL_ENABLE_FOV 1
-#endif
+/* Returns the index of a random entry, using RL_RNG_F. */
+size_t rl_weighted_table_sample(const RL_WeightedTable table);
 
-/* define to 0 to disable save & load */
-#ifndef RL_ENABLE_FILE
-#define RL_ENABLE_FILE 1
-#endif
+/* Same as above but draws from rng_f with the context (RL_RNG_F when rng_f is NULL). */
+size_t rl_weighted_table_sample_with(const RL_WeightedTable table, RL_RngFun rng_f, void *context);
 
-/* convenience macro for custom passable tile logic (for mapgen & pathfinding) */
-#ifndef RL_IS_PASSABLE
+/* Draws count samples into out (RL_RNG_F when rng_f is NULL). */
+RL_Status rl_weighted_table_sample_many(const RL_WeightedTable table, size_t *out, size_t count, RL_RngFun rng_f, void *context);
+
+/**
+ * Scanline flood fill
+ *
+ * Fills the area matching a function (e.g. for lighting a room or spreading a gas cloud) one horizontal span at a time,
+ * without the Dijkstra graph of rl_graph_create_scored:
+ *
+ *   RL_FloodFill *fill = rl_floodfill_create(map.width, map.height);
+ *   rl_floodfill(fill, map, x, y, true, NULL, NULL, NULL); // fills the passable tiles reachable from x, y
+ *   if (rl_floodfill_is_filled(fill, tx, ty)) { ... }
+ *   ....
+ *   rl_floodfill_destroy(fill);
+ *
+ * The span stack & filled bitmask are reused by each fill - only the bounding box of the previous fill is cleared.
+ */
+
+/* Called for each tile as it is filled. */
+typedef void (*RL_FillFun)(unsigned int x, unsigned int y, void *context);
+
+typedef struct {
+    unsigned int width;
+    unsigned int height;
+    RL_Byte *mask;         /* bit for each filled tile (x + y*width) of the last fill */
+    unsigned int *stack;   /* x, y pairs of the spans left to fill */
+    size_t stack_len;
+    size_t stack_cap;
+    size_t count;          /* tiles filled by the last fill */
+    RL_Rect bounds;        /* bounding box of the last fill */
+    const RL_Allocator *allocator; /* NULL for RL_MALLOC & RL_FREE */
+} RL_FloodFill;
+
+/* Allocates the flood fill workspace for maps of this size. Make sure to call rl_floodfill_destroy when done. */
+RL_FloodFill *rl_floodfill_create(unsigned int width, unsigned int height);
+
+/* Same as above but allocates the workspace (and grows its stack) with the passed allocator. */
+RL_FloodFill *rl_floodfill_create_ex(unsigned int width, unsigned int height, const RL_Allocator *allocator);
+
+/* Frees the flood fill workspace. */
+void rl_floodfill_destroy(RL_FloodFill *fill);
+
+/* Fills the tiles matching matches_f (NULL for passable tiles) connected to x, y - set allow_diagonal to connect tiles
+ * diagonally, like the default pathfinding neighbors. fill_f is called for each filled tile (can be NULL), the filled
+ * tiles, count & bounds are kept in the workspace until the next fill. */
+RL_Status rl_floodfill(RL_FloodFill *fill, const RL_Map map, unsigned int x, unsigned int y, bool allow_diagonal, void *context, RL_MatchesFun matches_f, RL_FillFun fill_f);
+
+/* Checks if the tile was filled by the last fill. */
+bool rl_floodfill_is_filled(const RL_FloodFill *fill, unsigned int x, unsigned int y);
+
+/**
+ * Reachability
+ *
+ * Keeps a component label for each passable tile (8 way movement, see RL_PASSABLE_F) up to date as tiles are dug or
+ * filled, so "can A reach B?" is answered without a search - e.g. to reject a hopeless path query before it starts:
+ *
+ *   RL_Reachability *reach = rl_reachability_create(map);
+ *   ....
+ *   map.tiles[x + y*map.width] = RL_TileRock;
+ *   rl_reachability_update(reach, x, y); // after each tile change
+ *   ....
+ *   if (rl_reachability_connected(reach, ax, ay, bx, by)) path = rl_path_create(map, a, b, NULL);
+ *   ....
+ *   rl_reachability_destroy(reach);
+ *
+ * Digging merges the labels of the neighbors (union-find). Filling a tile only relabels when the neighbors around it
+ * are not connected to each other - only then the area might split.
+ */
+typedef struct {
+    RL_Map map;
+    unsigned int *labels;   /* label of each tile (0 for impassable) - tiles are connected when their labels share a root */
+    unsigned int *parents;  /* union-find of the labels */
+    unsigned int labels_len;
+    unsigned int labels_cap;
+    unsigned int *stack;    /* reused by the relabel flood */
+    const RL_Allocator *allocator; /* NULL for RL_MALLOC & RL_FREE */
+} RL_Reachability;
+
+/* Labels the passable tiles of the map (the map must outlive the reachability). Make sure to call
+ * rl_reachability_destroy when done. */
+RL_Reachability *rl_reachability_create(const RL_Map map);
+
+/* Same as above but allocates the labels with the passed allocator. */
+RL_Reachability *rl_reachability_create_ex(const RL_Map map, const RL_Allocator *allocator);
+
+/* Frees the reachability labels. */
+void rl_reachability_destroy(RL_Reachability *reach);
+
+/* Relabels the whole map - call this after changing many tiles at once, instead of rl_reachability_update for each. */
+RL_Status rl_reachability_rebuild(RL_Reachability *reach);
+
+/* Updates the labels after the tile at x, y changed (dug or filled). */
+RL_Status rl_reachability_update(RL_Reachability *reach, unsigned int x, unsigned int y);
+
+/* Returns the id of the component of the tile - 0 for impassable tiles. Ids change as the map is updated. */
+unsigned int rl_reachability_component(RL_Reachability *reach, unsigned int x, unsigned int y);
+
+/* Checks if there is a path between the passable tiles a & b. */
+bool rl_reachability_connected(RL_Reachability *reach, unsigned int ax, unsigned int ay, unsigned int bx, unsigned int by);
+
+/**
+ * Diffusion
+ *
+ * Spreads values (e.g. scent or noise) across the passable tiles each turn. The field is padded with an impassable
+ * border & the passability is kept as a float mask, so each step is a branch free stencil over the rows that compilers
+ * auto-vectorize (build with optimizations, e.g. -O3):
+ *
+ *   RL_Diffusion *scent = rl_diffusion_create(map);
+ *   ....
+ *   rl_diffusion_add(scent, player_x, player_y, 100); // each turn, for each source
+ *   rl_diffusion_step(scent, 0.5, 0.95, true, NULL);
+ *   float smell = rl_diffusion_value(scent, x, y);
+ *   ....
+ *   rl_diffusion_destroy(scent);
+ */
+typedef struct {
+    unsigned int width;
+    unsigned int height;
+    size_t stride;   /* width + 2 - row stride of the padded buffers */
+    float *values;   /* current field (padded) */
+    float *back;     /* buffer the next step is written to */
+    float *mask;     /* 1 for passable tiles, 0 otherwise */
+    float *open4;    /* count of passable cardinal neighbors */
+    float *open8;    /* count of passable neighbors including diagonals */
+    const RL_Allocator *allocator; /* NULL for RL_MALLOC & RL_FREE */
+} RL_Diffusion;
+
+/* Creates an empty field with the passable tiles of the map (see RL_PASSABLE_F). Make sure to call
+ * rl_diffusion_destroy when done. */
+RL_Diffusion *rl_diffusion_create(const RL_Map map);
+
+/* Same as above but allocates the field with the passed allocator. */
+RL_Diffusion *rl_diffusion_create_ex(const RL_Map map, const RL_Allocator *allocator);
+
+/* Frees the field. */
+void rl_diffusion_destroy(RL_Diffusion *diffusion);
+
+/* Updates the passability of a tile (e.g. after opening a door) - the value of an impassable tile is cleared. */
+void rl_diffusion_set_passable(RL_Diffusion *diffusion, unsigned int x, unsigned int y, bool passable);
+
+/* Adds amount to the value of a passable tile. */
+void rl_diffusion_add(RL_Diffusion *diffusion, unsigned int x, unsigned int y, float amount);
+
+/* Resets the field to 0. */
+void rl_diffusion_clear(RL_Diffusion *diffusion);
+
+/* Diffuses the field one step - each tile exchanges rate (0 to 1) of the difference with its 4 (or 8 with diagonal)
+ * neighbors, then is multiplied by decay. Pass bounds to only update the tiles within (e.g. around the player), or NULL
+ * for the whole map. */
+RL_Status rl_diffusion_step(RL_Diffusion *diffusion, float rate, float decay, bool diagonal, const RL_Rect *bounds);
+
+/* Returns the value of the tile (0 if out of bounds). */
+float rl_diffusion_value(const RL_Diffusion *diffusion, unsigned int x, unsigned int y);
+
+/**
+ * Statistics - enable with #define RL_STATS 1
+ *
+ * Counters for the hot paths of the library, useful to find out why a path query or level generation is slow. The
+ * counters are kept per thread (see RL_THREAD_LOCAL). When RL_STATS is disabled the counters are compiled out and
+ * rl_stats_snapshot returns zeroes.
+ */
+
+typedef struct RL_Stats {
+    unsigned long dijkstra_expansions;  /* nodes popped while scoring a Dijkstra graph */
+    unsigned long heap_pushes;
+    unsigned long heap_pops;
+    unsigned long fov_cells_visited;    /* cells checked by the shadowcasting algorithm */
+    unsigned long recursion_depth;      /* current recursion depth (FOV & BSP split) */
+    unsigned long max_recursion_depth;  /* deepest recursion since the last reset */
+    unsigned long rng_draws;            /* calls to rl_rng_generate */
+    unsigned long allocations;
+    unsigned long bytes_allocated;
+} RL_Stats;
+
+/* Returns a copy of the counters for the current thread. */
+RL_Stats rl_stats_snapshot(void);
+
+/* Resets the counters for the current thread to zero. */
+void rl_stats_reset(void);
+
+/**
+ * Tracing - enable with #define RL_TRACE 1
+ *
+ * The major operations of the library (mapgen steps, each corridor dig, Dijkstra scoring, FOV calculations, etc.) are
+ * wrapped in RL_TRACE_BEGIN & RL_TRACE_END. With RL_TRACE enabled these write events in the Chrome trace event
+ * format, which can be opened in chrome://tracing or Perfetto:
+ *
+ *  FILE *f = fopen("trace.json", "w");
+ *  rl_trace_start(f);
+ *  rl_mapgen_bsp(map, RL_MAPGEN_BSP_DEFAULTS);
+ *  rl_trace_stop();
+ *  fclose(f);
+ *
+ * The recorder is global & only safe to use from one thread at a time - the exception is OpenMP, where events are
+ * written in a critical section with the OpenMP thread number as the trace thread id. If you run the library on your
+ * own threads, only trace from one of them or define RL_TRACE_BEGIN & RL_TRACE_END to forward the events to a thread
+ * safe profiler. When RL_TRACE is disabled the hooks are compiled out and rl_trace_start returns false.
+ */
+
+/* Starts writing trace events to the file (a FILE pointer). Returns false if tracing is disabled. */
+bool rl_trace_start(void *file);
+
+/* Finishes the trace - call this before closing the file. */
+void rl_trace_stop(void);
+
+/**
+ * Saving & Loading helper functions - to use these make sure to open the file beforehand in binary mode.
+ *
+ * The file is a FILE pointer (void* so we don't have to depend on stdio).
+ */
+
+bool rl_file_save_map(const RL_Map data, void *file);
+bool rl_file_load_map(RL_Map *data, void *file);
+bool rl_file_save_fov(const RL_FOV data, void *file);
+bool rl_file_load_fov(RL_FOV *data, void *file);
+
+/* Same as above but allocates the loaded data with the passed allocator. */
+bool rl_file_load_map_ex(RL_Map *data, void *file, const RL_Allocator *allocator);
+bool rl_file_load_fov_ex(RL_FOV *data, void *file, const RL_Allocator *allocator);
+#endif /* RL_ROGUELIKE_H */
+
+#ifdef RL_IMPLEMENTATION
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <limits.h>
+
+#ifndef RL_FOV_SYMMETRIC
+#define RL_FOV_SYMMETRIC 1
+#endif
+
+#ifndef RL_MAX_RECURSION
+#define RL_MAX_RECURSION 100
+#endif
+
+/* define this to 0 to put the rooms in the middle of the BSP leaf during dungeon generation */
+#ifndef RL_MAPGEN_BSP_RANDOMISE_ROOM_LOC
+#define RL_MAPGEN_BSP_RANDOMISE_ROOM_LOC 1
+#endif
+
+/* define to 0 to disable pathfinding */
+#ifndef RL_ENABLE_PATHFINDING
+#define RL_ENABLE_PATHFINDING 1
+#endif
+
+/* define to 0 to disable FOV */
+#ifndef RL_ENABLE_FOV
+#define RL_ENABLE_FOV 1
+#endif
+
+/* define to 0 to disable save & load */
+#ifndef RL_ENABLE_FILE
+#define RL_ENABLE_FILE 1
+#endif
+
+/* convenience macro for custom passable tile logic (for mapgen & pathfinding) */
+#ifndef RL_IS_PASSABLE
 #define RL_IS_PASSABLE(t, x, y) (t == RL_TileRoom || t == RL_TileCorridor || t == RL_TileDoor || t == RL_TileDoorOpen)
 #endif
 /* convenience macro for custom opaque tile logic (for FOV) */
@@ -839,6 +1997,10 @@ bool rl_file_load_fov(RL_FOV *data, void *file);
 #ifndef RL_RNG_F
 #define RL_RNG_F rl_rng_generate
 #endif
+
+#ifndef RL_WEIGHTED_TABLE_RESOLUTION
+#define RL_WEIGHTED_TABLE_RESOLUTION 32767
+#endif
 #ifndef RL_ASSERT
 #include <assert.h>
 #define RL_ASSERT(expr)		(assert(expr));
@@ -856,6 +2018,17 @@ bool rl_file_load_fov(RL_FOV *data, void *file);
 #define RL_FREE free
 #endif
 
+/* Children per node in the heap - 4 children fit in half a cache line on 64-bit systems */
+#ifndef RL_HEAP_ARITY
+#define RL_HEAP_ARITY 4
+#endif
+
+/* Alignment of the first group of siblings in the heap (should be the cache line size) - each group then fits within
+ * one line as long as RL_HEAP_ARITY * sizeof(void*) divides it */
+#ifndef RL_HEAP_ALIGNMENT
+#define RL_HEAP_ALIGNMENT 64
+#endif
+
 /* Max neighbors for a pathfinding node. */
 #ifndef RL_MAX_NEIGHBOR_COUNT
 #define RL_MAX_NEIGHBOR_COUNT 8
@@ -863,6 +2036,233 @@ bool rl_file_load_fov(RL_FOV *data, void *file);
 
 #define RL_UNUSED(x) (void)x
 
+/* current time in microseconds, for time budgets - a monotonic wall clock so the budgets hold when other threads are
+ * busy too (clock counts the processor time of every thread) */
+#ifndef RL_CLOCK_US
+#include <time.h>
+#if defined(_WIN32)
+/* keep windows.h from defining min/max & pulling in the rest of the Windows API */
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#define RL_UNDEF_WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#define RL_UNDEF_NOMINMAX
+#endif
+#include <windows.h>
+#ifdef RL_UNDEF_WIN32_LEAN_AND_MEAN
+#undef WIN32_LEAN_AND_MEAN
+#undef RL_UNDEF_WIN32_LEAN_AND_MEAN
+#endif
+#ifdef RL_UNDEF_NOMINMAX
+#undef NOMINMAX
+#undef RL_UNDEF_NOMINMAX
+#endif
+static double rl_clock_us(void)
+{
+    static LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+    if (frequency.QuadPart == 0) QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double) counter.QuadPart * 1000000.0 / (double) frequency.QuadPart;
+}
+#elif defined(CLOCK_MONOTONIC)
+static double rl_clock_us(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double) now.tv_sec * 1000000.0 + (double) now.tv_nsec / 1000.0;
+}
+#else
+/* fallback when clock_gettime isn't declared (e.g. strict -std=c99 without _POSIX_C_SOURCE) - processor time, so the
+ * budgets run short when other threads are busy. Define _POSIX_C_SOURCE >= 199309L or RL_CLOCK_US to avoid it. */
+static double rl_clock_us(void)
+{
+    return (double) clock() * 1000000.0 / CLOCKS_PER_SEC;
+}
+#endif
+#define RL_CLOCK_US() rl_clock_us()
+#endif
+
+/* define to 1 to count work done in the hot paths of the library */
+#ifndef RL_STATS
+#define RL_STATS 0
+#endif
+
+#if RL_STATS
+#ifndef RL_THREAD_LOCAL
+#if defined(__cplusplus) && __cplusplus >= 201103L
+#define RL_THREAD_LOCAL thread_local
+#elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && !defined(__STDC_NO_THREADS__)
+#define RL_THREAD_LOCAL _Thread_local
+#elif defined(_MSC_VER)
+#define RL_THREAD_LOCAL __declspec(thread)
+#elif defined(__GNUC__)
+#define RL_THREAD_LOCAL __thread
+#else
+#define RL_THREAD_LOCAL
+#endif
+#endif
+static RL_THREAD_LOCAL RL_Stats rl_stats;
+#define RL_STATS_ADD(counter, amount) (rl_stats.counter += (amount))
+#define RL_STATS_PUSH_DEPTH() do { \
+        if (++rl_stats.recursion_depth > rl_stats.max_recursion_depth) \
+            rl_stats.max_recursion_depth = rl_stats.recursion_depth; \
+    } while (0)
+#define RL_STATS_POP_DEPTH() (rl_stats.recursion_depth--)
+#else
+#define RL_STATS_ADD(counter, amount)
+#define RL_STATS_PUSH_DEPTH()
+#define RL_STATS_POP_DEPTH()
+#endif
+
+/* define to 1 to record traces of the major library operations */
+#ifndef RL_TRACE
+#define RL_TRACE 0
+#endif
+
+#if RL_TRACE
+#include <stdio.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#ifndef RL_TRACE_CLOCK
+#define RL_TRACE_CLOCK() RL_CLOCK_US()
+#endif
+static FILE *rl_trace_file;
+static bool rl_trace_first_event;
+/* events from OpenMP threads are serialized & tagged with the OpenMP thread number */
+static void rl_trace_event(const char *name, char phase)
+{
+    int tid = 1;
+#ifdef _OPENMP
+    tid = omp_get_thread_num() + 1;
+#pragma omp critical(rl_trace)
+#endif
+    {
+        if (rl_trace_file != NULL) {
+            fprintf(rl_trace_file, "%s{\"name\":\"%s\",\"cat\":\"roguelike\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%d}",
+                    rl_trace_first_event ? "" : ",\n", name, phase, RL_TRACE_CLOCK(), tid);
+            rl_trace_first_event = false;
+        }
+    }
+}
+#ifndef RL_TRACE_BEGIN
+#define RL_TRACE_BEGIN(name) rl_trace_event(name, 'B')
+#endif
+#ifndef RL_TRACE_END
+#define RL_TRACE_END(name) rl_trace_event(name, 'E')
+#endif
+#endif
+
+/* these compile out unless RL_TRACE is enabled or they are defined by the user */
+#ifndef RL_TRACE_BEGIN
+#define RL_TRACE_BEGIN(name)
+#endif
+#ifndef RL_TRACE_END
+#define RL_TRACE_END(name)
+#endif
+
+bool rl_trace_start(void *file)
+{
+#if RL_TRACE
+    RL_ASSERT(file != NULL);
+    if (file == NULL) return false;
+    rl_trace_file = (FILE*) file;
+    rl_trace_first_event = true;
+    return fprintf(rl_trace_file, "[\n") > 0;
+#else
+    RL_UNUSED(file);
+    return false;
+#endif
+}
+
+void rl_trace_stop(void)
+{
+#if RL_TRACE
+    if (rl_trace_file == NULL) return;
+    fprintf(rl_trace_file, "\n]\n");
+    fflush(rl_trace_file);
+    rl_trace_file = NULL;
+#endif
+}
+
+RL_Stats rl_stats_snapshot(void)
+{
+#if RL_STATS
+    return rl_stats;
+#else
+    RL_Stats stats;
+    memset(&stats, 0, sizeof(stats));
+    return stats;
+#endif
+}
+
+void rl_stats_reset(void)
+{
+#if RL_STATS
+    memset(&rl_stats, 0, sizeof(rl_stats));
+#endif
+}
+
+/* alignment of blocks returned from the arena & pool allocators */
+#define RL_ALLOCATOR_ALIGNMENT 16
+
+static void *rl_malloc(const RL_Allocator *allocator, size_t size)
+{
+    RL_STATS_ADD(allocations, 1);
+    RL_STATS_ADD(bytes_allocated, size);
+    if (allocator == NULL) {
+        return RL_MALLOC(size);
+    }
+    RL_ASSERT(allocator->alloc_f != NULL);
+    return allocator->alloc_f(allocator->user, size);
+}
+
+static void *rl_calloc(const RL_Allocator *allocator, size_t count, size_t size)
+{
+    void *ptr;
+    if (allocator == NULL) {
+        RL_STATS_ADD(allocations, 1);
+        RL_STATS_ADD(bytes_allocated, count * size);
+        return RL_CALLOC(count, size);
+    }
+    RL_ASSERT(size == 0 || count <= (size_t) -1 / size); /* check for overflow */
+    ptr = rl_malloc(allocator, count * size);
+    if (ptr != NULL) {
+        memset(ptr, 0, count * size);
+    }
+    return ptr;
+}
+
+static void rl_free(const RL_Allocator *allocator, void *ptr)
+{
+    if (allocator == NULL) {
+        RL_FREE(ptr);
+    } else if (allocator->free_f != NULL) {
+        allocator->free_f(allocator->user, ptr);
+    }
+}
+
+/* grow an allocation to size bytes (custom allocators have no realloc - copy old_size bytes to a new allocation) */
+static void *rl_realloc(const RL_Allocator *allocator, void *ptr, size_t old_size, size_t size)
+{
+    void *memory;
+    if (allocator == NULL) {
+        RL_STATS_ADD(allocations, 1);
+        RL_STATS_ADD(bytes_allocated, size);
+        return RL_REALLOC(ptr, size);
+    }
+    memory = rl_malloc(allocator, size);
+    if (memory != NULL && ptr != NULL) {
+        memcpy(memory, ptr, old_size);
+        rl_free(allocator, ptr);
+    }
+
+    return memory;
+}
+
 #if RL_ENABLE_PATHFINDING
 #include <float.h>
 #include <math.h>
@@ -885,18 +2285,26 @@ const char *rl_status_str(RL_Status status)
             return "RL_ErrorNotFound";
         case RL_ErrorRecursion:
             return "RL_ErrorRecursion";
+        case RL_ErrorCancelled:
+            return "RL_ErrorCancelled";
     }
     RL_ASSERT(false && "Unreachable");
+    return "Unknown";
 }
 
 RL_Map rl_map_create(unsigned int width, unsigned int height)
+{
+    return rl_map_create_ex(width, height, NULL);
+}
+
+RL_Map rl_map_create_ex(unsigned int width, unsigned int height, const RL_Allocator *allocator)
 {
     RL_Map map = {0};
     unsigned char *memory;
     RL_ASSERT(width > 0 && height > 0);
     RL_ASSERT(width != UINT_MAX && !(width > UINT_MAX / height)); /* check for overflow */
     /* allocate all the memory we need at once */
-    memory = (unsigned char*) RL_MALLOC(sizeof(*map.tiles)*width*height);
+    memory = (unsigned char*) rl_malloc(allocator, sizeof(*map.tiles)*width*height);
     RL_ASSERT(memory != NULL);
     if (memory == NULL) return map;
     map.width = width;
@@ -908,9 +2316,14 @@ RL_Map rl_map_create(unsigned int width, unsigned int height)
 }
 
 void rl_map_destroy(RL_Map map)
+{
+    rl_map_destroy_ex(map, NULL);
+}
+
+void rl_map_destroy_ex(RL_Map map, const RL_Allocator *allocator)
 {
     if (map.tiles) {
-        RL_FREE(map.tiles);
+        rl_free(allocator, map.tiles);
     }
 }
 
@@ -1039,56 +2452,250 @@ RL_Byte rl_map_room_wall(const RL_Map map, unsigned int x, unsigned int y)
     return mask ? mask : RL_WallOther;
 }
 
-unsigned int rl_rng_generate(unsigned int min, unsigned int max)
+RL_MapAnalysis rl_map_analysis_create(unsigned int width, unsigned int height)
 {
-    int rnd;
-
-    RL_ASSERT(max >= min);
-    RL_ASSERT(max < RAND_MAX);
-    RL_ASSERT(max < UINT_MAX);
-
-    if (max < min || max >= RAND_MAX || max >= UINT_MAX)
-        return min;
-    if (min == max)
-        return min;
+    return rl_map_analysis_create_ex(width, height, NULL);
+}
 
-    rnd = rand();
-    if (rnd < 0) rnd *= -1; /* fixes issue on LLVM MOS */
+RL_MapAnalysis rl_map_analysis_create_ex(unsigned int width, unsigned int height, const RL_Allocator *allocator)
+{
+    RL_MapAnalysis analysis = {0};
+    RL_Byte *memory;
+    RL_ASSERT(width > 0 && height > 0);
+    RL_ASSERT(width != UINT_MAX && !(width > UINT_MAX / height)); /* check for overflow */
+    /* allocate all the memory we need at once */
+    memory = (RL_Byte*) rl_calloc(allocator, (size_t) width * height * 2, sizeof(*memory));
+    RL_ASSERT(memory != NULL);
+    if (memory == NULL) return analysis;
+    analysis.allocator = allocator;
+    analysis.width = width;
+    analysis.height = height;
+    analysis.flags = memory;
+    analysis.clearance = memory + (size_t) width * height;
 
-    /* produces more uniformity than using mod */
-    return min + rnd / (RAND_MAX / (max - min + 1) + 1);
+    return analysis;
 }
 
-RL_BSP *rl_bsp_create(unsigned int width, unsigned int height)
+void rl_map_analysis_destroy(RL_MapAnalysis analysis)
 {
-    RL_BSP *bsp;
+    if (analysis.flags) {
+        rl_free(analysis.allocator, analysis.flags);
+    }
+}
 
-    RL_ASSERT(width > 0 && height > 0);
-    bsp = (RL_BSP*) RL_CALLOC(1, sizeof(*bsp));
-    if (bsp == NULL) return NULL;
-    bsp->width = width;
-    bsp->height = height;
+/* 8 way neighbor of a tile, or -1 if out of bounds/impassable */
+static long rl_map_analysis_neighbor(const RL_Map map, size_t idx, int direction)
+{
+    static const int dx[8] = { 1, -1, 0, 0, 1, 1, -1, -1 };
+    static const int dy[8] = { 0, 0, 1, -1, 1, -1, 1, -1 };
+    unsigned int x = idx % map.width + dx[direction], y = idx / map.width + dy[direction];
+    if (!rl_map_in_bounds(map, x, y) || !RL_PASSABLE_F(map, x, y)) return -1;
 
-    return bsp;
+    return (long) x + (long) y * map.width;
 }
-void rl_bsp_destroy(RL_BSP* root)
+
+/* two pass chessboard distance transform */
+static void rl_map_analysis_clearance(RL_MapAnalysis analysis, const RL_Map map)
 {
-    if (root) {
-        if (root->left) {
-            rl_bsp_destroy(root->left);
-            root->left = NULL;
+    unsigned int x, y;
+    RL_Byte *d = analysis.clearance;
+    for (y = 0; y < map.height; ++y) {
+        for (x = 0; x < map.width; ++x) {
+            size_t idx = x + y*map.width;
+            unsigned int v;
+            if (!RL_PASSABLE_F(map, x, y)) {
+                d[idx] = 0;
+                continue;
+            }
+            v = 255;
+            if (x == 0 || y == 0 || x == map.width - 1) v = 1;
+            else {
+                if (d[idx - 1] + 1u < v) v = d[idx - 1] + 1;
+                if (d[idx - map.width - 1] + 1u < v) v = d[idx - map.width - 1] + 1;
+                if (d[idx - map.width] + 1u < v) v = d[idx - map.width] + 1;
+                if (d[idx - map.width + 1] + 1u < v) v = d[idx - map.width + 1] + 1;
+            }
+            d[idx] = (RL_Byte) v;
         }
-        if (root->right) {
-            rl_bsp_destroy(root->right);
-            root->right = NULL;
+    }
+    for (y = map.height; y-- > 0;) {
+        for (x = map.width; x-- > 0;) {
+            size_t idx = x + y*map.width;
+            unsigned int v = d[idx];
+            if (v == 0) continue;
+            if (x == map.width - 1 || y == map.height - 1 || x == 0) v = 1;
+            else {
+                if (d[idx + 1] + 1u < v) v = d[idx + 1] + 1;
+                if (d[idx + map.width - 1] + 1u < v) v = d[idx + map.width - 1] + 1;
+                if (d[idx + map.width] + 1u < v) v = d[idx + map.width] + 1;
+                if (d[idx + map.width + 1] + 1u < v) v = d[idx + map.width + 1] + 1;
+            }
+            d[idx] = (RL_Byte) v;
         }
-        RL_FREE(root);
     }
 }
 
-void rl_bsp_split(RL_BSP *node, unsigned int position, RL_SplitDirection direction)
-{
-    RL_BSP *left, *right;
+RL_Status rl_map_analyze(RL_MapAnalysis analysis, const RL_Map map, unsigned int max_clearance)
+{
+    size_t length, root, i;
+    unsigned int *order, *low, counter = 0;
+    long *parent;
+    RL_Byte *next; /* next neighbor direction to visit for each tile on the DFS stack */
+    RL_ASSERT(analysis.flags != NULL && map.tiles != NULL);
+    if (analysis.flags == NULL || map.tiles == NULL) return RL_ErrorNullParameter;
+    RL_ASSERT(analysis.width == map.width && analysis.height == map.height);
+    if (analysis.width != map.width || analysis.height != map.height) return RL_ErrorInvalidParameter;
+    length = (size_t) map.width * map.height;
+    order = (unsigned int*) rl_calloc(analysis.allocator, length, sizeof(*order));
+    low = (unsigned int*) rl_malloc(analysis.allocator, sizeof(*low) * length);
+    parent = (long*) rl_malloc(analysis.allocator, sizeof(*parent) * length);
+    next = (RL_Byte*) rl_malloc(analysis.allocator, sizeof(*next) * length);
+    if (order == NULL || low == NULL || parent == NULL || next == NULL) {
+        if (order) rl_free(analysis.allocator, order);
+        if (low) rl_free(analysis.allocator, low);
+        if (parent) rl_free(analysis.allocator, parent);
+        if (next) rl_free(analysis.allocator, next);
+        return RL_ErrorMemory;
+    }
+    memset(analysis.flags, 0, length);
+    RL_TRACE_BEGIN("rl_map_analyze");
+
+    /* iterative Tarjan - the DFS stack is threaded through the parent array */
+    for (root = 0; root < length; ++root) {
+        long current;
+        unsigned int root_children = 0;
+        if (order[root] || !RL_PASSABLE_F(map, root % map.width, root / map.width)) continue;
+        order[root] = low[root] = ++counter;
+        parent[root] = -1;
+        next[root] = 0;
+        current = (long) root;
+        while (current >= 0) {
+            if (next[current] < 8) {
+                long n = rl_map_analysis_neighbor(map, current, next[current]++);
+                if (n < 0 || n == parent[current]) continue;
+                if (order[n]) {
+                    if (order[n] < low[current]) low[current] = order[n];
+                    continue;
+                }
+                order[n] = low[n] = ++counter;
+                parent[n] = current;
+                next[n] = 0;
+                if ((size_t) current == root) root_children++;
+                current = n;
+            } else {
+                long p = parent[current];
+                if (p >= 0) {
+                    if (low[current] < low[p]) low[p] = low[current];
+                    if (low[current] > order[p]) {
+                        analysis.flags[p] |= RL_AnalysisBridge;
+                        analysis.flags[current] |= RL_AnalysisBridge;
+                    }
+                    if ((size_t) p != root && low[current] >= order[p]) {
+                        analysis.flags[p] |= RL_AnalysisArticulation;
+                    }
+                }
+                current = p;
+            }
+        }
+        if (root_children > 1) analysis.flags[root] |= RL_AnalysisArticulation;
+    }
+
+    /* narrow passages - the middle line (no neighbor further from the walls) of passages with a low clearance */
+    rl_map_analysis_clearance(analysis, map);
+    for (i = 0; i < length; ++i) {
+        int direction;
+        bool ridge = true;
+        if (analysis.clearance[i] == 0 || analysis.clearance[i] > max_clearance) continue;
+        for (direction = 0; direction < 8; ++direction) {
+            long n = rl_map_analysis_neighbor(map, i, direction);
+            if (n >= 0 && analysis.clearance[n] > analysis.clearance[i]) ridge = false;
+        }
+        if (ridge) analysis.flags[i] |= RL_AnalysisNarrow;
+    }
+    for (i = 0; i < length; ++i) {
+        int direction;
+        if (!(analysis.flags[i] & RL_AnalysisNarrow)) continue;
+        for (direction = 0; direction < 8; ++direction) {
+            long n = rl_map_analysis_neighbor(map, i, direction);
+            if (n >= 0 && !(analysis.flags[n] & RL_AnalysisNarrow) && analysis.clearance[n] >= analysis.clearance[i]) {
+                analysis.flags[i] |= RL_AnalysisChokepoint;
+            }
+        }
+    }
+    RL_TRACE_END("rl_map_analyze");
+
+    rl_free(analysis.allocator, order);
+    rl_free(analysis.allocator, low);
+    rl_free(analysis.allocator, parent);
+    rl_free(analysis.allocator, next);
+
+    return RL_OK;
+}
+
+RL_Byte rl_map_analysis_flags(const RL_MapAnalysis analysis, unsigned int x, unsigned int y)
+{
+    if (analysis.flags == NULL || !RL_IN_BOUNDS(analysis, x, y)) return 0;
+
+    return analysis.flags[x + y*analysis.width];
+}
+
+unsigned int rl_rng_generate(unsigned int min, unsigned int max)
+{
+    int rnd;
+
+    RL_STATS_ADD(rng_draws, 1);
+    RL_ASSERT(max >= min);
+    RL_ASSERT(max < RAND_MAX);
+    RL_ASSERT(max < UINT_MAX);
+
+    if (max < min || max >= RAND_MAX || max >= UINT_MAX)
+        return min;
+    if (min == max)
+        return min;
+
+    rnd = rand();
+    if (rnd < 0) rnd *= -1; /* fixes issue on LLVM MOS */
+
+    /* produces more uniformity than using mod */
+    return min + rnd / (RAND_MAX / (max - min + 1) + 1);
+}
+
+RL_BSP *rl_bsp_create(unsigned int width, unsigned int height)
+{
+    return rl_bsp_create_ex(width, height, NULL);
+}
+
+RL_BSP *rl_bsp_create_ex(unsigned int width, unsigned int height, const RL_Allocator *allocator)
+{
+    RL_BSP *bsp;
+
+    RL_ASSERT(width > 0 && height > 0);
+    bsp = (RL_BSP*) rl_calloc(allocator, 1, sizeof(*bsp));
+    if (bsp == NULL) return NULL;
+    bsp->width = width;
+    bsp->height = height;
+    bsp->allocator = allocator;
+
+    return bsp;
+}
+void rl_bsp_destroy(RL_BSP* root)
+{
+    if (root) {
+        if (root->left) {
+            rl_bsp_destroy(root->left);
+            root->left = NULL;
+        }
+        if (root->right) {
+            rl_bsp_destroy(root->right);
+            root->right = NULL;
+        }
+        rl_free(root->allocator, root);
+    }
+}
+
+void rl_bsp_split(RL_BSP *node, unsigned int position, RL_SplitDirection direction)
+{
+    RL_BSP *left, *right;
 
     /* can't split something already split */
     RL_ASSERT(node->left == NULL && node->right == NULL);
@@ -1101,12 +2708,12 @@ void rl_bsp_split(RL_BSP *node, unsigned int position, RL_SplitDirection directi
     if (direction == RL_SplitHorizontally && position >= node->width)
         return;
 
-    left = (RL_BSP*) RL_CALLOC(1, sizeof(RL_BSP));
+    left = (RL_BSP*) rl_calloc(node->allocator, 1, sizeof(RL_BSP));
     if (left == NULL)
         return;
-    right = (RL_BSP*) RL_CALLOC(1, sizeof(RL_BSP));
+    right = (RL_BSP*) rl_calloc(node->allocator, 1, sizeof(RL_BSP));
     if (right == NULL) {
-        RL_FREE(left);
+        rl_free(node->allocator, left);
         return;
     }
 
@@ -1131,6 +2738,7 @@ void rl_bsp_split(RL_BSP *node, unsigned int position, RL_SplitDirection directi
     }
 
     left->parent = right->parent = node;
+    left->allocator = right->allocator = node->allocator;
     node->left = left;
     node->right = right;
 }
@@ -1188,18 +2796,22 @@ RL_Status rl_mapgen_bsp_recursive_split(RL_BSP *root, unsigned int min_width, un
     if (left == NULL || right == NULL)
         return RL_ErrorMemory;
 
+    RL_STATS_PUSH_DEPTH();
     ret = rl_mapgen_bsp_recursive_split(left, min_width, min_height, max_splits - 1);
+    RL_STATS_POP_DEPTH();
     if (ret != RL_OK) {
-        RL_FREE(left);
-        RL_FREE(right);
+        rl_bsp_destroy(left);
+        rl_bsp_destroy(right);
         root->left = root->right = NULL;
         return ret;
     }
 
+    RL_STATS_PUSH_DEPTH();
     ret = rl_mapgen_bsp_recursive_split(right, min_width, min_height, max_splits - 1);
+    RL_STATS_POP_DEPTH();
     if (ret != RL_OK) {
-        RL_FREE(left);
-        RL_FREE(right);
+        rl_bsp_destroy(left);
+        rl_bsp_destroy(right);
         root->left = root->right = NULL;
         return ret;
     }
@@ -1402,13 +3014,16 @@ RL_Status rl_mapgen_bsp(RL_Map map, RL_MapgenConfigBSP config)
 {
     RL_Status ret;
     RL_BSP *root = rl_bsp_create(map.width, map.height);
+    RL_TRACE_BEGIN("rl_mapgen_bsp");
     ret = rl_mapgen_bsp_ex(map, root, config);
+    RL_TRACE_END("rl_mapgen_bsp");
     rl_bsp_destroy(root);
 
     return ret;
 }
 
-RL_Status rl_mapgen_bsp_ex(RL_Map map, RL_BSP *root, RL_MapgenConfigBSP config)
+/* splits the BSP & generates the rooms, before the corridors are connected */
+static RL_Status rl_mapgen_bsp_rooms(RL_Map map, RL_BSP *root, RL_MapgenConfigBSP config)
 {
     RL_Status ret;
     RL_ASSERT(map.tiles != NULL);
@@ -1424,11 +3039,24 @@ RL_Status rl_mapgen_bsp_ex(RL_Map map, RL_BSP *root, RL_MapgenConfigBSP config)
     RL_ASSERT(config.room_max_width <= map.width && config.room_max_height <= map.height);
     RL_ASSERT(config.max_splits > 0);
 
+    RL_TRACE_BEGIN("rl_mapgen_bsp_recursive_split");
     ret = rl_mapgen_bsp_recursive_split(root, config.room_max_width + config.room_padding*2, config.room_max_height + config.room_padding*2, config.max_splits);
+    RL_TRACE_END("rl_mapgen_bsp_recursive_split");
     if (ret != RL_OK) return ret;
+    RL_TRACE_BEGIN("rl_mapgen_bsp_generate_rooms");
     ret = rl_mapgen_bsp_generate_rooms(root, map, config.room_min_width, config.room_max_width, config.room_min_height, config.room_max_height, config.room_padding);
+    RL_TRACE_END("rl_mapgen_bsp_generate_rooms");
+
+    return ret;
+}
+
+RL_Status rl_mapgen_bsp_ex(RL_Map map, RL_BSP *root, RL_MapgenConfigBSP config)
+{
+    RL_Status ret = rl_mapgen_bsp_rooms(map, root, config);
     if (ret != RL_OK) return ret;
+    RL_TRACE_BEGIN("rl_mapgen_connect_corridors");
     ret = rl_mapgen_connect_corridors(map, root, config.draw_doors, config.draw_corridors);
+    RL_TRACE_END("rl_mapgen_connect_corridors");
     if (ret != RL_OK) return ret;
 
     /* if (config.use_secret_passages) { */
@@ -1529,33 +3157,267 @@ static inline float rl_mapgen_corridor_scorer(void *context, const RL_GraphNode
 
 RL_Status rl_mapgen_automata(RL_Map map, RL_MapgenConfigAutomata config)
 {
-    RL_Status status;
-    status = rl_mapgen_automata_generate_rooms(map, 0, 0, map.width, map.height,
-                                               config.chance_cell_initialized,
-                                               config.birth_threshold,
-                                               config.survival_threshold,
-                                               config.max_iterations,
-                                               config.fill_border);
+    RL_MapgenAutomata gen;
+    RL_Status status = rl_mapgen_automata_begin(&gen, map, config);
     if (status != RL_OK) return status;
+    RL_TRACE_BEGIN("rl_mapgen_automata");
+    while (!rl_mapgen_automata_step(&gen, ULONG_MAX)) {}
+    RL_TRACE_END("rl_mapgen_automata");
+
+    return gen.status;
+}
+
+/* cellular automata rules for a single tile */
+static void rl_mapgen_automata_update_tile(RL_Map map, unsigned int x, unsigned int y, unsigned int birth_threshold, unsigned int survival_threshold)
+{
+    unsigned int alive_neighbors = rl_mapgen_automata_alive_neighbors(map, x, y);
+    if (!rl_mapgen_automata_is_alive(map, x, y) && alive_neighbors >= birth_threshold) {
+        /* cell isn't alive but has enough alive neighbors to be born */
+        map.tiles[x + y*map.width] = RL_TileRock;
+    } else if (rl_mapgen_automata_is_alive(map, x, y) && alive_neighbors >= survival_threshold) {
+        /* cell is alive and has enough alive neighbors to survive */
+    } else {
+        /* cell dies */
+        map.tiles[x + y*map.width] = RL_TileRoom;
+    }
+}
+
+RL_Status rl_mapgen_automata_begin(RL_MapgenAutomata *gen, RL_Map map, RL_MapgenConfigAutomata config)
+{
+    RL_ASSERT(gen != NULL);
+    if (gen == NULL) return RL_ErrorNullParameter;
+    memset(gen, 0, sizeof(*gen));
+    gen->stage = RL_MapgenAutomataDone;
+    RL_ASSERT(map.tiles != NULL && map.width > 0 && map.height > 0);
+    if (map.tiles == NULL) return gen->status = RL_ErrorNullParameter;
+    RL_ASSERT(config.chance_cell_initialized <= 100);
+#if !RL_ENABLE_PATHFINDING
+    if (config.draw_corridors || config.cull_unconnected) return gen->status = RL_ErrorMapgenInvalidConfig;
+#endif
+    gen->map = map;
+    gen->config = config;
+    gen->stage = RL_MapgenAutomataInitialize;
+    gen->status = RL_OK;
+
+    return RL_OK;
+}
+
+/* moves to the next tile in the current stage, returns true when every tile has been visited */
+static bool rl_mapgen_automata_next_tile(RL_MapgenAutomata *gen)
+{
+    if (++gen->y < gen->map.height) return false;
+    gen->y = 0;
+    if (++gen->x < gen->map.width) return false;
+    gen->x = 0;
+    return true;
+}
 
-    if (config.draw_corridors) {
 #if RL_ENABLE_PATHFINDING
-        status = rl_mapgen_connect_unconnected_rooms(map, false);
-        if (status != RL_OK) return status;
-#else
-        return RL_ErrorMapgenInvalidConfig;
+/* the floodfill graph - the generator only stores the nodes since RL_Graph is declared after it */
+static RL_Graph rl_mapgen_automata_floodfill(const RL_MapgenAutomata *gen)
+{
+    RL_Graph graph = {0};
+    graph.length = (size_t) gen->map.width * gen->map.height;
+    graph.nodes = gen->floodfill;
+    graph.neighbors = rl_graph_neighbors_ordinal_passable;
+    return graph;
+}
+
+static void rl_mapgen_automata_fail(RL_MapgenAutomata *gen, RL_Status status)
+{
+    gen->status = status;
+    gen->stage = RL_MapgenAutomataDone;
+}
 #endif
-    }
-    if (config.cull_unconnected) {
+
+bool rl_mapgen_automata_step(RL_MapgenAutomata *gen, unsigned long work_budget)
+{
+    RL_Map map;
+    unsigned long work = 0;
+    size_t length;
+    RL_ASSERT(gen != NULL);
+    if (gen == NULL) return true;
+    map = gen->map;
+    length = (size_t) map.width * map.height;
+    RL_UNUSED(length); /* unused without pathfinding */
+    while (gen->stage != RL_MapgenAutomataDone && work < work_budget) {
+        unsigned int x = gen->x, y = gen->y;
+        switch (gen->stage) {
+            case RL_MapgenAutomataInitialize:
+                if (gen->config.chance_cell_initialized == 0) {
+                    gen->stage = RL_MapgenAutomataIterate;
+                    break;
+                }
+                map.tiles[x + y*map.width] = RL_RNG_F(1, 100) <= gen->config.chance_cell_initialized ? RL_TileRock : RL_TileRoom;
+                work++;
+                if (rl_mapgen_automata_next_tile(gen)) gen->stage = RL_MapgenAutomataIterate;
+                break;
+            case RL_MapgenAutomataIterate:
+                if (gen->iteration >= gen->config.max_iterations) {
+                    gen->stage = RL_MapgenAutomataBorder;
+                    break;
+                }
+                rl_mapgen_automata_update_tile(map, x, y, gen->config.birth_threshold, gen->config.survival_threshold);
+                work++;
+                if (rl_mapgen_automata_next_tile(gen)) gen->iteration++;
+                break;
+            case RL_MapgenAutomataBorder:
+                if (gen->config.fill_border) {
+                    for (y=0; y<map.height; ++y) map.tiles[y*map.width] = map.tiles[map.width - 1 + y*map.width] = RL_TileRock;
+                    for (x=0; x<map.width; ++x) map.tiles[x] = map.tiles[x + (map.height - 1)*map.width] = RL_TileRock;
+                    work += 2 * (map.width + map.height);
+                }
+                gen->stage = gen->config.draw_corridors ? RL_MapgenAutomataConnectStart : RL_MapgenAutomataCullScan;
+                break;
 #if RL_ENABLE_PATHFINDING
-        status = rl_mapgen_cull_unconnected_rooms(map);
-        if (status != RL_OK) return status;
+            case RL_MapgenAutomataConnectStart:
+                /* floodfill from the first passable tile */
+                work++;
+                if (RL_PASSABLE_F(map, x, y)) {
+                    gen->floodfill = rl_graph_create_from_map(map, NULL).nodes;
+                    if (gen->floodfill == NULL) {
+                        rl_mapgen_automata_fail(gen, RL_ErrorMemory);
+                        break;
+                    }
+                    rl_graph_score(rl_mapgen_automata_floodfill(gen), map, rl_point(x, y), NULL);
+                    work += length;
+                    gen->x = gen->y = 0;
+                    gen->stage = RL_MapgenAutomataConnect;
+                } else if (rl_mapgen_automata_next_tile(gen)) {
+                    gen->stage = RL_MapgenAutomataCullScan; /* no passable tiles */
+                }
+                break;
+            case RL_MapgenAutomataConnect:
+                work++;
+                if (RL_PASSABLE_F(map, x, y) && gen->floodfill[x + y*map.width].score == FLT_MAX) {
+                    /* found a tile to connect to floodfill - dig from the first tile in the floodfill */
+                    RL_Point dig_start = rl_point(0, 0);
+                    RL_Status status;
+                    size_t i;
+                    for (i=0; i<length; ++i) {
+                        RL_GraphNode *n = &gen->floodfill[i];
+                        if (n->score < FLT_MAX && RL_PASSABLE_F(map, n->point.x, n->point.y)) {
+                            dig_start = n->point;
+                            break;
+                        }
+                    }
+                    RL_ASSERT(RL_PASSABLE_F(map, dig_start.x, dig_start.y));
+                    status = rl_mapgen_connect_corridor(map, dig_start.x, dig_start.y, x, y, false);
+                    if (status != RL_OK) {
+                        rl_mapgen_automata_fail(gen, status);
+                        break;
+                    }
+                    /* update floodfill with newly connected cave */
+                    rl_graph_score(rl_mapgen_automata_floodfill(gen), map, dig_start, NULL);
+                    work += 3 * length;
+                }
+                if (rl_mapgen_automata_next_tile(gen)) {
+                    rl_graph_destroy(rl_mapgen_automata_floodfill(gen));
+                    gen->floodfill = NULL;
+                    gen->stage = RL_MapgenAutomataCullScan;
+                }
+                break;
+            case RL_MapgenAutomataCullScan:
+                if (!gen->config.cull_unconnected) {
+                    gen->stage = RL_MapgenAutomataDone;
+                    break;
+                }
+                if (gen->visited == NULL) {
+                    gen->visited = (RL_Byte*) rl_calloc(NULL, length, sizeof(*gen->visited));
+                    if (gen->visited == NULL) {
+                        rl_mapgen_automata_fail(gen, RL_ErrorMemory);
+                        break;
+                    }
+                }
+                work++;
+                if (RL_PASSABLE_F(map, x, y) && !gen->visited[x + y*map.width]) {
+                    /* floodfill this cave, keeping it if it is the largest so far */
+                    RL_Graph test = rl_graph_create_scored(map, rl_point(x, y), NULL, NULL);
+                    size_t i, test_size = 0;
+                    if (test.nodes == NULL) {
+                        rl_mapgen_automata_fail(gen, RL_ErrorMemory);
+                        break;
+                    }
+                    for (i=0; i<length; ++i) {
+                        if (test.nodes[i].score != FLT_MAX) {
+                            gen->visited[i] = 1;
+                            test_size++;
+                        }
+                    }
+                    if (test_size > gen->floodfill_size) {
+                        if (gen->floodfill) rl_graph_destroy(rl_mapgen_automata_floodfill(gen));
+                        gen->floodfill = test.nodes;
+                        gen->floodfill_size = test_size;
+                    } else {
+                        rl_graph_destroy(test);
+                    }
+                    work += 2 * length;
+                }
+                if (rl_mapgen_automata_next_tile(gen)) {
+                    rl_free(NULL, gen->visited);
+                    gen->visited = NULL;
+                    if (gen->floodfill == NULL) {
+                        rl_mapgen_automata_fail(gen, RL_ErrorMemory); /* same as rl_mapgen_cull_unconnected_rooms */
+                        break;
+                    }
+                    gen->stage = RL_MapgenAutomataCull;
+                }
+                break;
+            case RL_MapgenAutomataCull:
+                if (gen->floodfill[x + y*map.width].score == FLT_MAX) {
+                    map.tiles[x + y*map.width] = RL_TileRock;
+                }
+                work++;
+                if (rl_mapgen_automata_next_tile(gen)) gen->stage = RL_MapgenAutomataDone;
+                break;
 #else
-        return RL_ErrorMapgenInvalidConfig;
+            case RL_MapgenAutomataConnectStart:
+            case RL_MapgenAutomataConnect:
+            case RL_MapgenAutomataCullScan:
+            case RL_MapgenAutomataCull:
+                gen->stage = RL_MapgenAutomataDone;
+                break;
 #endif
+            case RL_MapgenAutomataDone:
+                break;
+        }
+    }
+    if (gen->stage == RL_MapgenAutomataDone) {
+        rl_mapgen_automata_end(gen);
+        return true;
     }
 
-    return RL_OK;
+    return false;
+}
+
+bool rl_mapgen_automata_step_us(RL_MapgenAutomata *gen, unsigned long budget_us)
+{
+    double start = RL_CLOCK_US();
+    RL_ASSERT(gen != NULL);
+    if (gen == NULL) return true;
+    /* step a column at a time until the budget is used (the automata stages visit x in the outer loop) */
+    while (!rl_mapgen_automata_step(gen, gen->map.height)) {
+        if (RL_CLOCK_US() - start >= budget_us) return false;
+    }
+
+    return true;
+}
+
+void rl_mapgen_automata_end(RL_MapgenAutomata *gen)
+{
+    RL_ASSERT(gen != NULL);
+    if (gen == NULL) return;
+#if RL_ENABLE_PATHFINDING
+    if (gen->floodfill) {
+        rl_graph_destroy(rl_mapgen_automata_floodfill(gen));
+        gen->floodfill = NULL;
+    }
+#endif
+    if (gen->visited) {
+        rl_free(NULL, gen->visited);
+        gen->visited = NULL;
+    }
+    gen->stage = RL_MapgenAutomataDone;
 }
 
 RL_Status rl_mapgen_automata_generate_rooms(RL_Map map,
@@ -1600,16 +3462,7 @@ RL_Status rl_mapgen_automata_generate_rooms(RL_Map map,
     for (i=max_iterations; i>0; i--) {
         for (x=offset_x; x<offset_x + width; ++x) {
             for (y=offset_y; y<offset_y + height; ++y) {
-                unsigned int alive_neighbors = rl_mapgen_automata_alive_neighbors(map, x, y);
-                if (!rl_mapgen_automata_is_alive(map, x, y) && alive_neighbors >= birth_threshold) {
-                    /* cell isn't alive but has enough alive neighbors to be born */
-                    map.tiles[x + y*map.width] = RL_TileRock;
-                } else if (rl_mapgen_automata_is_alive(map, x, y) && alive_neighbors >= survival_threshold) {
-                    /* cell is alive and has enough alive neighbors to survive */
-                } else {
-                    /* cell dies */
-                    map.tiles[x + y*map.width] = RL_TileRoom;
-                }
+                rl_mapgen_automata_update_tile(map, x, y, birth_threshold, survival_threshold);
             }
         }
     }
@@ -1661,11 +3514,16 @@ int rl_mapgen_maze_unvisited_neighbors(RL_MapPoint ps[4], const RL_Map map, int
 
 RL_Status rl_mapgen_maze(RL_Map map)
 {
+    RL_Status status;
     RL_ASSERT(map.tiles != NULL);
     if (map.tiles == NULL) return RL_ErrorNullParameter;
     RL_ASSERT(map.width > 2 && map.height > 2);
     memset(map.tiles, RL_TileRock, sizeof(*map.tiles) * map.width * map.height);
-    return rl_mapgen_maze_ex(map, 1, 1, map.width - 2, map.height - 2);
+    RL_TRACE_BEGIN("rl_mapgen_maze");
+    status = rl_mapgen_maze_ex(map, 1, 1, map.width - 2, map.height - 2);
+    RL_TRACE_END("rl_mapgen_maze");
+
+    return status;
 }
 
 RL_Status rl_mapgen_maze_ex(RL_Map map, unsigned int offset_x, unsigned int offset_y, unsigned int width, unsigned int height)
@@ -1696,7 +3554,7 @@ RL_Status rl_mapgen_maze_ex(RL_Map map, unsigned int offset_x, unsigned int offs
 
     /* allocate memory for BFS */
     heap = rl_heap_create(width * height, NULL);
-    ps = (RL_MapPoint*) RL_MALLOC(sizeof(*ps) * map.width * map.height);
+    ps = (RL_MapPoint*) rl_malloc(NULL, sizeof(*ps) * map.width * map.height);
 
     RL_ASSERT(ps && heap);
     if (ps == NULL || heap == NULL) {
@@ -1744,7 +3602,7 @@ RL_Status rl_mapgen_maze_ex(RL_Map map, unsigned int offset_x, unsigned int offs
 
     /* free memory for BFS */
     rl_heap_destroy(heap);
-    RL_FREE(ps);
+    rl_free(NULL, ps);
 
     return RL_OK;
 }
@@ -1827,7 +3685,9 @@ void rl_mapgen_connect_corridor_with_pathfinding(RL_Map map, unsigned int dig_st
 }
 #endif
 
-RL_Status rl_mapgen_connect_corridors(RL_Map map, RL_BSP *root, bool draw_doors, RL_MapgenCorridorConnection connection_algorithm)
+typedef RL_Status (*RL_ConnectCorridorFun)(RL_Map map, unsigned int from_x, unsigned int from_y, unsigned int to_x, unsigned int to_y, bool draw_doors);
+
+static RL_Status rl_mapgen_connect_corridors_with(RL_Map map, RL_BSP *root, bool draw_doors, RL_MapgenCorridorConnection connection_algorithm, RL_ConnectCorridorFun connect_f)
 {
     switch (connection_algorithm) {
         case RL_ConnectNone:
@@ -1860,6 +3720,7 @@ RL_Status rl_mapgen_connect_corridors(RL_Map map, RL_BSP *root, bool draw_doors,
                 RL_ASSERT(found_room);
                 found_room = rl_bsp_find_room(map, right, &dest_x, &dest_y);
                 RL_ASSERT(found_room);
+                RL_UNUSED(found_room); /* unused when asserts are disabled */
 #else
                 RL_UNUSED(found_room);
                 from_x = left->x + left->width / 2;
@@ -1872,11 +3733,11 @@ RL_Status rl_mapgen_connect_corridors(RL_Map map, RL_BSP *root, bool draw_doors,
                 RL_ASSERT(!(from_x == dest_x && from_y == dest_y));
 
                 /* connect corridors */
-                status = rl_mapgen_connect_corridor(map, from_x, from_y, dest_x, dest_y, draw_doors);
+                status = connect_f(map, from_x, from_y, dest_x, dest_y, draw_doors);
                 if (status != RL_OK) return status;
-                status = rl_mapgen_connect_corridors(map, node, draw_doors, connection_algorithm);
+                status = rl_mapgen_connect_corridors_with(map, node, draw_doors, connection_algorithm, connect_f);
                 if (status != RL_OK) return status;
-                status = rl_mapgen_connect_corridors(map, sibling, draw_doors, connection_algorithm);
+                status = rl_mapgen_connect_corridors_with(map, sibling, draw_doors, connection_algorithm, connect_f);
                 if (status != RL_OK) return status;
             }
             break;
@@ -1912,6 +3773,7 @@ RL_Status rl_mapgen_connect_corridors(RL_Map map, RL_BSP *root, bool draw_doors,
                     RL_ASSERT(found_room);
                     found_room = rl_bsp_find_room(map, sibling, &dest_x, &dest_y);
                     RL_ASSERT(found_room);
+                    RL_UNUSED(found_room); /* unused when asserts are disabled */
 #else
                     RL_UNUSED(found_room);
                     from_x = node->x + node->width / 2;
@@ -1924,7 +3786,7 @@ RL_Status rl_mapgen_connect_corridors(RL_Map map, RL_BSP *root, bool draw_doors,
                     RL_ASSERT(!(from_x == dest_x && from_y == dest_y));
 
                     /* connect corridors */
-                    status = rl_mapgen_connect_corridor(map, from_x, from_y, dest_x, dest_y, draw_doors);
+                    status = connect_f(map, from_x, from_y, dest_x, dest_y, draw_doors);
                     if (status != RL_OK) return status;
 
                     /* find start node for next loop iteration */
@@ -1938,6 +3800,11 @@ RL_Status rl_mapgen_connect_corridors(RL_Map map, RL_BSP *root, bool draw_doors,
     return RL_OK;
 }
 
+RL_Status rl_mapgen_connect_corridors(RL_Map map, RL_BSP *root, bool draw_doors, RL_MapgenCorridorConnection connection_algorithm)
+{
+    return rl_mapgen_connect_corridors_with(map, root, draw_doors, connection_algorithm, rl_mapgen_connect_corridor);
+}
+
 /* TODO probably want a define for enabling/disabling Dijkstra corridors - should also improve our simple algorithm */
 RL_Status rl_mapgen_connect_corridor(RL_Map map, unsigned int from_x, unsigned int from_y, unsigned int dest_x, unsigned int dest_y, bool draw_doors)
 {
@@ -1947,10 +3814,14 @@ RL_Status rl_mapgen_connect_corridor(RL_Map map, unsigned int from_x, unsigned i
 #if RL_ENABLE_PATHFINDING
     RL_Graph graph = rl_graph_create_from_map(map, NULL);
     if (graph.nodes == NULL) return RL_ErrorMemory;
+    RL_TRACE_BEGIN("rl_mapgen_connect_corridor");
     rl_mapgen_connect_corridor_with_pathfinding(map, from_x, from_y, dest_x, dest_y, draw_doors, graph);
+    RL_TRACE_END("rl_mapgen_connect_corridor");
     rl_graph_destroy(graph);
 #else
+    RL_TRACE_BEGIN("rl_mapgen_connect_corridor");
     rl_mapgen_connect_corridor_simple(map, from_x, from_y, dest_x, dest_y, draw_doors);
+    RL_TRACE_END("rl_mapgen_connect_corridor");
 #endif
 
     return RL_OK;
@@ -1980,7 +3851,7 @@ RL_Status rl_mapgen_connect_unconnected_rooms(RL_Map map, bool draw_doors)
     if (is_scored) {
         for (x=0; x < map.width; ++x) {
             for (y=0; y < map.height; ++y) {
-                if (RL_PASSABLE_F(map, x, y) && !rl_graph_is_scored(floodfill, rl_point(x, y))) {
+                if (RL_PASSABLE_F(map, x, y) && floodfill.nodes[x + y*map.width].score == FLT_MAX) {
                     /* found a node to connect to floodfill */
                     RL_Point dig_start;
 
@@ -1997,7 +3868,10 @@ RL_Status rl_mapgen_connect_unconnected_rooms(RL_Map map, bool draw_doors)
                     RL_ASSERT(RL_PASSABLE_F(map, dig_start.x, dig_start.y));
 
                     RL_Status status = rl_mapgen_connect_corridor(map, dig_start.x, dig_start.y, x, y, draw_doors);
-                    if (status != RL_OK) return status;
+                    if (status != RL_OK) {
+                        rl_graph_destroy(floodfill);
+                        return status;
+                    }
 
                     /* update floodfill with newly connected room */
                     rl_graph_score(floodfill, map, dig_start, NULL);
@@ -2021,7 +3895,7 @@ RL_Status rl_mapgen_cull_unconnected_rooms(RL_Map map)
     if (floodfill.nodes != NULL) {
         for (x=0; x < map.width; ++x) {
             for (y=0; y < map.height; ++y) {
-                if (!rl_graph_is_scored(floodfill, rl_point(x, y))) {
+                if (floodfill.nodes[x + y*map.width].score == FLT_MAX) {
                     map.tiles[x + y*map.width] = RL_TileRock;
                 }
             }
@@ -2033,111 +3907,652 @@ RL_Status rl_mapgen_cull_unconnected_rooms(RL_Map map)
 }
 #endif
 
+
 /**
- * Heap functions for pathfinding
- *
- * Ref: https://gist.github.com/skeeto/f012a207aff1753662b679917f706de6
+ * Hex map generation
  */
 
-static int rl_heap_noop_comparison_f(const void *_a, const void *_b)
+/* hex neighbor offsets in offset coordinates - [0] for the rows (or columns for flat top hexes) that aren't shifted &
+ * [1] for the shifted ones, in the same direction order for both */
+static const int rl_hex_offsets[2][6][2] = {
+#if RL_HEX_FLAT_TOP == 1
+    { {1, 0}, {1, -1}, {0, -1}, {-1, -1}, {-1, 0}, {0, 1} },
+    { {1, 1}, {1, 0}, {0, -1}, {-1, 0}, {-1, 1}, {0, 1} }
+#else
+    { {1, 0}, {0, -1}, {-1, -1}, {-1, 0}, {-1, 1}, {0, 1} },
+    { {1, 0}, {1, -1}, {0, -1}, {-1, 0}, {0, 1}, {1, 1} }
+#endif
+};
+
+/* returns the 6 neighbor offsets for the parity of the tile */
+static const int (*rl_hex_neighbor_offsets(unsigned int x, unsigned int y))[2]
 {
-    RL_UNUSED(_a);
-    RL_UNUSED(_b);
-    return 1;
+#if RL_HEX_FLAT_TOP == 1
+    unsigned int shifted = x & 1;
+#else
+    unsigned int shifted = y & 1;
+#endif
+    RL_UNUSED(x);
+    RL_UNUSED(y);
+#if RL_HEX_ODD_OFFSET != 1
+    shifted ^= 1;
+#endif
+
+    return rl_hex_offsets[shifted];
 }
 
-RL_Heap *rl_heap_create(int capacity, int (*comparison_f)(const void *heap_item_a, const void *heap_item_b))
+/* offset to axial coordinates, same as rl_point_axial */
+static void rl_hex_axial(unsigned int x, unsigned int y, int *q, int *r)
 {
-    RL_Heap *heap;
-    heap = (RL_Heap*) RL_MALLOC(sizeof(*heap));
-    RL_ASSERT(heap);
-    RL_ASSERT(capacity > 0);
-    if (heap == NULL) {
-        return NULL;
-    }
-    heap->heap = (void**) RL_MALLOC(sizeof(*heap->heap) * capacity);
-    RL_ASSERT(heap->heap);
-    if (heap->heap == NULL) {
-        RL_FREE(heap);
-        return NULL;
-    }
-
-    if (comparison_f == NULL) {
-        comparison_f = rl_heap_noop_comparison_f;
-    }
+#if RL_HEX_FLAT_TOP == 1
+#if RL_HEX_ODD_OFFSET == 1
+    int shift = ((int) x - (int) (x & 1)) / 2;
+#else
+    int shift = ((int) x + (int) (x & 1)) / 2;
+#endif
+    *q = (int) x;
+    *r = (int) y - shift;
+#else
+#if RL_HEX_ODD_OFFSET == 1
+    int shift = ((int) y - (int) (y & 1)) / 2;
+#else
+    int shift = ((int) y + (int) (y & 1)) / 2;
+#endif
+    *q = (int) x - shift;
+    *r = (int) y;
+#endif
+}
 
-    heap->cap = capacity;
-    heap->comparison_f = comparison_f;
-    heap->len = 0;
+static int rl_hex_distance(int q1, int r1, int q2, int r2)
+{
+    int dq = q1 - q2, dr = r1 - r2, ds = dq + dr;
+    if (dq < 0) dq = -dq;
+    if (dr < 0) dr = -dr;
+    if (ds < 0) ds = -ds;
 
-    return heap;
+    return (dq + dr + ds) / 2;
 }
 
-void rl_heap_destroy(RL_Heap *h)
+/* same as rl_map_is_room_wall with hex neighbors */
+static bool rl_hex_is_room_wall(const RL_Map map, unsigned int x, unsigned int y)
 {
-    if (h) {
-        if (h->heap) {
-            RL_FREE(h->heap);
-        }
-        RL_FREE(h);
+    const int (*offsets)[2] = rl_hex_neighbor_offsets(x, y);
+    int i;
+    if (!rl_map_in_bounds(map, x, y) || !RL_IS_WALL_TILE(map.tiles[x + y*map.width], x, y)) return false;
+    for (i = 0; i < 6; ++i) {
+        if (rl_map_tile_is(map, x + offsets[i][0], y + offsets[i][1], RL_TileRoom)) return true;
     }
-}
 
-int rl_heap_length(const RL_Heap *h)
-{
-    if (h == NULL) return 0;
-    return h->len;
+    return false;
 }
 
-bool rl_heap_insert(RL_Heap *h, void *item)
+static unsigned int rl_hex_automata_alive_neighbors(const RL_Map map, unsigned int x, unsigned int y)
 {
+    const int (*offsets)[2] = rl_hex_neighbor_offsets(x, y);
+    unsigned int alive = 0;
     int i;
-    RL_ASSERT(h != NULL);
-    if (h == NULL) return false;
-
-    if (h->len == h->cap) {
-        /* resize the heap */
-        void **heap_items = (void**) RL_REALLOC(h->heap, sizeof(void*) * h->cap * 2);
-        RL_ASSERT(heap_items);
-        if (heap_items == NULL) {
-            rl_heap_destroy(h);
-            return false;
-        }
-        h->heap = heap_items;
-        h->cap *= 2;
+    for (i = 0; i < 6; ++i) {
+        alive += rl_mapgen_automata_is_alive(map, x + offsets[i][0], y + offsets[i][1]);
     }
 
-    h->heap[h->len] = item;
-    for (i = h->len++; i;) {
-        void *tmp;
-        int p = (i - 1) / 2;
-        if (h->comparison_f(h->heap[p], h->heap[i])) {
-            break;
-        }
-        tmp = h->heap[p];
-        h->heap[p] = h->heap[i];
-        h->heap[i] = tmp;
-        i = p;
-    }
-    return true;
+    return alive;
 }
 
-static void rl_heap_remove(RL_Heap *h, int index)
+/* floodfills the hex connected passable tiles from start with the label, returns the count of tiles filled */
+static size_t rl_hex_label_area(RL_Map map, int *labels, size_t *stack, size_t start, int label)
 {
-    int i;
-    RL_ASSERT(h);
-    if (h == NULL) {
-        return;
+    size_t stack_len = 0, count = 0;
+    labels[start] = label;
+    stack[stack_len++] = start;
+    while (stack_len) {
+        size_t current = stack[--stack_len];
+        unsigned int x = current % map.width, y = current / map.width;
+        const int (*offsets)[2] = rl_hex_neighbor_offsets(x, y);
+        int i;
+        count++;
+        for (i = 0; i < 6; ++i) {
+            unsigned int nx = x + offsets[i][0], ny = y + offsets[i][1];
+            size_t n = nx + ny * map.width;
+            if (!rl_map_in_bounds(map, nx, ny) || labels[n] >= 0 || !RL_PASSABLE_F(map, nx, ny)) continue;
+            labels[n] = label;
+            stack[stack_len++] = n; /* each tile is only pushed once */
+        }
     }
 
-    h->heap[index] = h->heap[--h->len];
+    return count;
+}
+
+RL_Status rl_mapgen_automata_hex(RL_Map map, RL_MapgenConfigAutomata config)
+{
+    unsigned int x, y, iteration;
+    size_t length, i, previous = 0, largest_size = 0;
+    int *labels, label, largest = -1;
+    size_t *stack;
+    RL_Status status = RL_OK;
+    RL_ASSERT(map.tiles != NULL && map.width > 0 && map.height > 0);
+    if (map.tiles == NULL) return RL_ErrorNullParameter;
+    RL_ASSERT(config.chance_cell_initialized <= 100);
+    length = (size_t) map.width * map.height;
+
+    RL_TRACE_BEGIN("rl_mapgen_automata_hex");
+    if (config.chance_cell_initialized > 0) {
+        for (i = 0; i < length; ++i) {
+            map.tiles[i] = RL_RNG_F(1, 100) <= config.chance_cell_initialized ? RL_TileRock : RL_TileRoom;
+        }
+    }
+    for (iteration = 0; iteration < config.max_iterations; ++iteration) {
+        for (x = 0; x < map.width; ++x) {
+            for (y = 0; y < map.height; ++y) {
+                /* same rules as rl_mapgen_automata_update_tile out of 6 neighbors */
+                unsigned int alive_neighbors = rl_hex_automata_alive_neighbors(map, x, y);
+                bool alive = map.tiles[x + y*map.width] == RL_TileRock;
+                map.tiles[x + y*map.width] = alive_neighbors >= (alive ? config.survival_threshold : config.birth_threshold) ? RL_TileRock : RL_TileRoom;
+            }
+        }
+    }
+    if (config.fill_border) {
+        for (y=0; y<map.height; ++y) map.tiles[y*map.width] = map.tiles[map.width - 1 + y*map.width] = RL_TileRock;
+        for (x=0; x<map.width; ++x) map.tiles[x] = map.tiles[x + (map.height - 1)*map.width] = RL_TileRock;
+    }
+
+    if (config.draw_corridors || config.cull_unconnected) {
+        labels = (int*) rl_malloc(NULL, sizeof(*labels) * length);
+        stack = (size_t*) rl_malloc(NULL, sizeof(*stack) * length);
+        RL_ASSERT(labels != NULL && stack != NULL);
+        if (labels == NULL || stack == NULL) {
+            if (labels) rl_free(NULL, labels);
+            if (stack) rl_free(NULL, stack);
+            RL_TRACE_END("rl_mapgen_automata_hex");
+            return RL_ErrorMemory;
+        }
+        if (config.draw_corridors) {
+            /* dig from the previous area to each new area before labeling it, so its corridor is labeled with it */
+            for (i = 0; i < length; ++i) {
+                labels[i] = -1;
+            }
+            for (i = 0, label = 0; i < length && status == RL_OK; ++i) {
+                if (labels[i] >= 0 || !RL_PASSABLE_F(map, i % map.width, i / map.width)) continue;
+                if (label > 0) {
+                    status = rl_mapgen_connect_corridor_hex(map, previous % map.width, previous / map.width, i % map.width, i / map.width, false);
+                }
+                rl_hex_label_area(map, labels, stack, i, label++);
+                previous = i;
+            }
+        }
+        if (config.cull_unconnected && status == RL_OK) {
+            /* relabel from scratch - the corridors join areas that were labeled apart */
+            for (i = 0; i < length; ++i) {
+                labels[i] = -1;
+            }
+            for (i = 0, label = 0; i < length; ++i) {
+                size_t size;
+                if (labels[i] >= 0 || !RL_PASSABLE_F(map, i % map.width, i / map.width)) continue;
+                size = rl_hex_label_area(map, labels, stack, i, label);
+                if (size > largest_size) {
+                    largest = label;
+                    largest_size = size;
+                }
+                label++;
+            }
+            for (i = 0; i < length; ++i) {
+                if (labels[i] != largest) map.tiles[i] = RL_TileRock;
+            }
+        }
+        rl_free(NULL, labels);
+        rl_free(NULL, stack);
+    }
+    RL_TRACE_END("rl_mapgen_automata_hex");
+
+    return status;
+}
+
+RL_Status rl_mapgen_maze_hex(RL_Map map)
+{
+    RL_Status status;
+    RL_ASSERT(map.tiles != NULL);
+    if (map.tiles == NULL) return RL_ErrorNullParameter;
+    RL_ASSERT(map.width > 2 && map.height > 2);
+    memset(map.tiles, RL_TileRock, sizeof(*map.tiles) * map.width * map.height);
+    RL_TRACE_BEGIN("rl_mapgen_maze_hex");
+    status = rl_mapgen_maze_hex_ex(map, 1, 1, map.width - 2, map.height - 2);
+    RL_TRACE_END("rl_mapgen_maze_hex");
+
+    return status;
+}
+
+RL_Status rl_mapgen_maze_hex_ex(RL_Map map, unsigned int offset_x, unsigned int offset_y, unsigned int width, unsigned int height)
+{
+    unsigned int x, y;
+    size_t *stack, stack_len = 0;
+
+    RL_ASSERT(map.tiles != NULL);
+    if (map.tiles == NULL) return RL_ErrorNullParameter;
+    RL_ASSERT(width > 0 && height > 0);
+    RL_ASSERT(offset_x + width <= map.width && offset_y + height <= map.height);
+    if (width == 0 || height == 0 || offset_x + width > map.width || offset_y + height > map.height) return RL_ErrorInvalidParameter;
+
+    /* reset all tiles within range to rock */
+    for (y = offset_y; y < offset_y + height; ++y) {
+        for (x = offset_x; x < offset_x + width; ++x) {
+            map.tiles[x + y*map.width] = RL_TileRock;
+        }
+    }
+
+    /* each tile is carved & pushed at most once */
+    stack = (size_t*) rl_malloc(NULL, sizeof(*stack) * width * height);
+    RL_ASSERT(stack != NULL);
+    if (stack == NULL) return RL_ErrorMemory;
+
+    /* there are no cells & walls like rl_mapgen_maze since 2 hex steps don't line up - instead a rock tile is only carved
+     * if the tile it's carved from is its only passage, so the passages never touch & there are no loops */
+    x = RL_RNG_F(offset_x, offset_x + width - 1);
+    y = RL_RNG_F(offset_y, offset_y + height - 1);
+    map.tiles[x + y*map.width] = RL_TileCorridor;
+    stack[stack_len++] = x + y*map.width;
+    while (stack_len) {
+        size_t candidates[6];
+        const int (*offsets)[2];
+        int i, j, count = 0;
+        x = stack[stack_len - 1] % map.width;
+        y = stack[stack_len - 1] / map.width;
+        offsets = rl_hex_neighbor_offsets(x, y);
+        for (i = 0; i < 6; ++i) {
+            unsigned int nx = x + offsets[i][0], ny = y + offsets[i][1];
+            const int (*neighbor_offsets)[2];
+            int passages = 0;
+            if (nx < offset_x || nx >= offset_x + width || ny < offset_y || ny >= offset_y + height) continue;
+            if (map.tiles[nx + ny*map.width] != RL_TileRock) continue;
+            neighbor_offsets = rl_hex_neighbor_offsets(nx, ny);
+            for (j = 0; j < 6; ++j) {
+                unsigned int mx = nx + neighbor_offsets[j][0], my = ny + neighbor_offsets[j][1];
+                if (mx < offset_x || mx >= offset_x + width || my < offset_y || my >= offset_y + height) continue;
+                if (map.tiles[mx + my*map.width] != RL_TileRock) passages++;
+            }
+            if (passages == 1) candidates[count++] = nx + ny*map.width;
+        }
+        if (count == 0) {
+            stack_len--; /* dead end - backtrack */
+            continue;
+        }
+        i = RL_RNG_F(0, count - 1);
+        map.tiles[candidates[i]] = RL_TileCorridor;
+        stack[stack_len++] = candidates[i];
+    }
+    rl_free(NULL, stack);
+
+    return RL_OK;
+}
+
+RL_Status rl_mapgen_bsp_hex(RL_Map map, RL_MapgenConfigBSP config)
+{
+    RL_Status ret;
+    RL_BSP *root = rl_bsp_create(map.width, map.height);
+    RL_TRACE_BEGIN("rl_mapgen_bsp_hex");
+    ret = rl_mapgen_bsp_hex_ex(map, root, config);
+    RL_TRACE_END("rl_mapgen_bsp_hex");
+    rl_bsp_destroy(root);
+
+    return ret;
+}
+
+RL_Status rl_mapgen_bsp_hex_ex(RL_Map map, RL_BSP *root, RL_MapgenConfigBSP config)
+{
+    RL_Status ret = rl_mapgen_bsp_rooms(map, root, config);
+    if (ret != RL_OK) return ret;
+    RL_TRACE_BEGIN("rl_mapgen_connect_corridors_hex");
+    ret = rl_mapgen_connect_corridors_hex(map, root, config.draw_doors, config.draw_corridors);
+    RL_TRACE_END("rl_mapgen_connect_corridors_hex");
+
+    return ret;
+}
+
+RL_Status rl_mapgen_connect_corridors_hex(RL_Map map, RL_BSP *root, bool draw_doors, RL_MapgenCorridorConnection connection_algorithm)
+{
+    return rl_mapgen_connect_corridors_with(map, root, draw_doors, connection_algorithm, rl_mapgen_connect_corridor_hex);
+}
+
+RL_Status rl_mapgen_connect_corridor_hex(RL_Map map, unsigned int from_x, unsigned int from_y, unsigned int to_x, unsigned int to_y, bool draw_doors)
+{
+    unsigned int x = from_x, y = from_y;
+    int from_q, from_r, to_q, to_r, line_x, line_y;
+    RL_ASSERT(map.tiles != NULL);
+    if (map.tiles == NULL) return RL_ErrorNullParameter;
+    RL_ASSERT(rl_map_in_bounds(map, from_x, from_y) && rl_map_in_bounds(map, to_x, to_y));
+    if (!rl_map_in_bounds(map, from_x, from_y) || !rl_map_in_bounds(map, to_x, to_y)) return RL_ErrorInvalidParameter;
+    rl_hex_axial(from_x, from_y, &from_q, &from_r);
+    rl_hex_axial(to_x, to_y, &to_q, &to_r);
+    /* the line in pixel proportional coordinates, so the corridor stays close to the straight line on screen */
+#if RL_HEX_FLAT_TOP == 1
+    line_x = to_q - from_q;
+    line_y = 2*(to_r - from_r) + (to_q - from_q);
+#else
+    line_x = 2*(to_q - from_q) + (to_r - from_r);
+    line_y = to_r - from_r;
+#endif
+
+    while (x != to_x || y != to_y) {
+        const int (*offsets)[2] = rl_hex_neighbor_offsets(x, y);
+        unsigned int next_x = x, next_y = y;
+        long best_error = LONG_MAX;
+        int q, r, distance, i;
+        /* dig */
+        if (map.tiles[x + y*map.width] == RL_TileRock) {
+            if (draw_doors && rl_hex_is_room_wall(map, x, y))
+                map.tiles[x + y*map.width] = RL_TileDoor;
+            else
+                map.tiles[x + y*map.width] = RL_TileCorridor;
+        }
+        rl_hex_axial(x, y, &q, &r);
+        distance = rl_hex_distance(q, r, to_q, to_r);
+        /* step to the neighbor closer to the destination that's the closest to the line */
+        for (i = 0; i < 6; ++i) {
+            unsigned int nx = x + offsets[i][0], ny = y + offsets[i][1];
+            int nq, nr, px, py;
+            long error;
+            if (!rl_map_in_bounds(map, nx, ny)) continue;
+            rl_hex_axial(nx, ny, &nq, &nr);
+            if (rl_hex_distance(nq, nr, to_q, to_r) >= distance) continue;
+#if RL_HEX_FLAT_TOP == 1
+            px = nq - from_q;
+            py = 2*(nr - from_r) + (nq - from_q);
+#else
+            px = 2*(nq - from_q) + (nr - from_r);
+            py = nr - from_r;
+#endif
+            error = (long) px * line_y - (long) py * line_x;
+            if (error < 0) error = -error;
+            if (error < best_error) {
+                best_error = error;
+                next_x = nx;
+                next_y = ny;
+            }
+        }
+        RL_ASSERT(next_x != x || next_y != y); /* a hex closer to the destination is always in bounds */
+        x = next_x;
+        y = next_y;
+    }
+
+    return RL_OK;
+}
+
+/**
+ * Allocators
+ */
+
+static void *rl_arena_alloc_f(void *user, size_t size)
+{
+    RL_Arena *arena = (RL_Arena*) user;
+    size_t start;
+    RL_ASSERT(arena != NULL);
+    if (arena == NULL || arena->memory == NULL) return NULL;
+
+    start = (arena->used + RL_ALLOCATOR_ALIGNMENT - 1) & ~((size_t) RL_ALLOCATOR_ALIGNMENT - 1);
+    if (start > arena->size || size > arena->size - start) {
+        return NULL; /* arena is full */
+    }
+    arena->used = start + size;
+
+    return arena->memory + start;
+}
+
+RL_Arena rl_arena_create(size_t size)
+{
+    RL_Arena arena = {0};
+    RL_ASSERT(size > 0);
+    arena.memory = (unsigned char*) rl_malloc(NULL, size);
+    RL_ASSERT(arena.memory != NULL);
+    if (arena.memory == NULL) return arena;
+    arena.size = size;
+
+    return arena;
+}
+
+void rl_arena_destroy(RL_Arena arena)
+{
+    if (arena.memory) {
+        rl_free(NULL, arena.memory);
+    }
+}
+
+void rl_arena_reset(RL_Arena *arena)
+{
+    RL_ASSERT(arena != NULL);
+    if (arena == NULL) return;
+    arena->used = 0;
+}
+
+RL_Allocator rl_arena_allocator(RL_Arena *arena)
+{
+    RL_Allocator allocator;
+    RL_ASSERT(arena != NULL);
+    allocator.alloc_f = rl_arena_alloc_f;
+    allocator.free_f = NULL; /* memory is released with rl_arena_reset */
+    allocator.user = arena;
+
+    return allocator;
+}
+
+/* each chunk is prefixed with a pointer to the next chunk (padded to keep the blocks aligned) */
+#define RL_POOL_CHUNK_HEADER RL_ALLOCATOR_ALIGNMENT
+
+static void *rl_pool_alloc_f(void *user, size_t size)
+{
+    RL_Pool *pool = (RL_Pool*) user;
+    void *block;
+    RL_ASSERT(pool != NULL);
+    if (pool == NULL) return NULL;
+    RL_ASSERT(size <= pool->block_size);
+    if (size > pool->block_size) return NULL;
+
+    if (pool->free_list == NULL) {
+        /* allocate a new chunk & thread its blocks onto the free list */
+        size_t i;
+        unsigned char *chunk = (unsigned char*) rl_malloc(pool->allocator, RL_POOL_CHUNK_HEADER + pool->block_size * pool->blocks_per_chunk);
+        RL_ASSERT(chunk != NULL);
+        if (chunk == NULL) return NULL;
+        *(void**) chunk = pool->chunks;
+        pool->chunks = chunk;
+        for (i = pool->blocks_per_chunk; i > 0; --i) {
+            void **free_block = (void**) (chunk + RL_POOL_CHUNK_HEADER + (i - 1) * pool->block_size);
+            *free_block = pool->free_list;
+            pool->free_list = free_block;
+        }
+    }
+
+    block = pool->free_list;
+    pool->free_list = *(void**) block;
+
+    return block;
+}
+
+static void rl_pool_free_f(void *user, void *ptr)
+{
+    RL_Pool *pool = (RL_Pool*) user;
+    RL_ASSERT(pool != NULL);
+    if (pool == NULL || ptr == NULL) return;
+    *(void**) ptr = pool->free_list;
+    pool->free_list = ptr;
+}
+
+RL_Pool rl_pool_create(size_t block_size, size_t blocks_per_chunk)
+{
+    return rl_pool_create_ex(block_size, blocks_per_chunk, NULL);
+}
+
+RL_Pool rl_pool_create_ex(size_t block_size, size_t blocks_per_chunk, const RL_Allocator *allocator)
+{
+    RL_Pool pool = {0};
+    RL_ASSERT(block_size > 0 && blocks_per_chunk > 0);
+    if (block_size < sizeof(void*)) block_size = sizeof(void*);
+    pool.block_size = (block_size + RL_ALLOCATOR_ALIGNMENT - 1) & ~((size_t) RL_ALLOCATOR_ALIGNMENT - 1);
+    pool.blocks_per_chunk = blocks_per_chunk > 0 ? blocks_per_chunk : 1;
+    pool.allocator = allocator;
+
+    return pool;
+}
+
+void rl_pool_destroy(RL_Pool pool)
+{
+    void *chunk = pool.chunks;
+    while (chunk != NULL) {
+        void *next = *(void**) chunk;
+        rl_free(pool.allocator, chunk);
+        chunk = next;
+    }
+}
+
+RL_Allocator rl_pool_allocator(RL_Pool *pool)
+{
+    RL_Allocator allocator;
+    RL_ASSERT(pool != NULL);
+    allocator.alloc_f = rl_pool_alloc_f;
+    allocator.free_f = rl_pool_free_f;
+    allocator.user = pool;
+
+    return allocator;
+}
+
+/**
+ * Heap functions for pathfinding
+ *
+ * Ref: https://gist.github.com/skeeto/f012a207aff1753662b679917f706de6
+ */
+
+static int rl_heap_noop_comparison_f(const void *_a, const void *_b)
+{
+    RL_UNUSED(_a);
+    RL_UNUSED(_b);
+    return 1;
+}
+
+/* Returns the heap array within memory, offset so the first child of the root starts on an RL_HEAP_ALIGNMENT boundary.
+ * The following groups of siblings are packed after it, so each group fits within one cache line (not one line each). */
+static void **rl_heap_align(void *memory)
+{
+    uintptr_t first_child = (uintptr_t) memory + sizeof(void*);
+    first_child = (first_child + RL_HEAP_ALIGNMENT - 1) & ~((uintptr_t) RL_HEAP_ALIGNMENT - 1);
+
+    return (void**) (first_child - sizeof(void*));
+}
+
+RL_Heap *rl_heap_create(int capacity, int (*comparison_f)(const void *heap_item_a, const void *heap_item_b))
+{
+    return rl_heap_create_ex(capacity, comparison_f, NULL);
+}
+
+RL_Heap *rl_heap_create_ex(int capacity, int (*comparison_f)(const void *heap_item_a, const void *heap_item_b), const RL_Allocator *allocator)
+{
+    RL_Heap *heap;
+    heap = (RL_Heap*) rl_malloc(allocator, sizeof(*heap));
+    RL_ASSERT(heap);
+    RL_ASSERT(capacity > 0);
+    if (heap == NULL) {
+        return NULL;
+    }
+    heap->memory = rl_malloc(allocator, sizeof(*heap->heap) * capacity + RL_HEAP_ALIGNMENT);
+    RL_ASSERT(heap->memory);
+    if (heap->memory == NULL) {
+        rl_free(allocator, heap);
+        return NULL;
+    }
+    heap->heap = rl_heap_align(heap->memory);
+    heap->allocator = allocator;
+
+    if (comparison_f == NULL) {
+        comparison_f = rl_heap_noop_comparison_f;
+    }
+
+    heap->cap = capacity;
+    heap->comparison_f = comparison_f;
+    heap->len = 0;
+
+    return heap;
+}
+
+void rl_heap_destroy(RL_Heap *h)
+{
+    if (h) {
+        if (h->memory) {
+            rl_free(h->allocator, h->memory);
+        }
+        rl_free(h->allocator, h);
+    }
+}
+
+int rl_heap_length(const RL_Heap *h)
+{
+    if (h == NULL) return 0;
+    return h->len;
+}
+
+/* grow the heap to fit at least capacity items */
+static bool rl_heap_reserve(RL_Heap *h, int capacity)
+{
+    size_t offset;
+    void *memory;
+    void **heap_items;
+    int cap = h->cap;
+
+    if (capacity <= cap) return true;
+    while (cap < capacity) cap *= 2;
+
+    offset = (char*) h->heap - (char*) h->memory;
+    if (h->allocator == NULL) {
+        RL_STATS_ADD(allocations, 1);
+        RL_STATS_ADD(bytes_allocated, sizeof(void*) * cap + RL_HEAP_ALIGNMENT);
+        memory = RL_REALLOC(h->memory, sizeof(void*) * cap + RL_HEAP_ALIGNMENT);
+    } else {
+        /* custom allocators have no realloc - copy the items to a new allocation */
+        memory = rl_malloc(h->allocator, sizeof(void*) * cap + RL_HEAP_ALIGNMENT);
+        if (memory != NULL) {
+            memcpy((char*) memory + offset, h->heap, sizeof(void*) * h->len);
+            rl_free(h->allocator, h->memory);
+        }
+    }
+    RL_ASSERT(memory);
+    if (memory == NULL) {
+        return false;
+    }
+    /* realloc may have moved the memory to a different alignment - shift items back into alignment */
+    heap_items = rl_heap_align(memory);
+    if ((char*) heap_items - (char*) memory != (ptrdiff_t) offset) {
+        memmove(heap_items, (char*) memory + offset, sizeof(void*) * h->len);
+    }
+    h->memory = memory;
+    h->heap = heap_items;
+    h->cap = cap;
+
+    return true;
+}
+
+static void rl_heap_sift_up(RL_Heap *h, int index)
+{
+    int i;
+    for (i = index; i;) {
+        void *tmp;
+        int p = (i - 1) / RL_HEAP_ARITY;
+        if (h->comparison_f(h->heap[p], h->heap[i])) {
+            break;
+        }
+        tmp = h->heap[p];
+        h->heap[p] = h->heap[i];
+        h->heap[i] = tmp;
+        i = p;
+    }
+}
+
+static void rl_heap_sift_down(RL_Heap *h, int index)
+{
+    int i;
     for (i = index;;) {
-        int a = 2*i + 1;
-        int b = 2*i + 2;
-        int j = i;
+        int first = RL_HEAP_ARITY*i + 1;
+        int last = first + RL_HEAP_ARITY;
+        int c, j = i;
         void *tmp;
-        if (a < h->len && h->comparison_f(h->heap[a], h->heap[j])) j = a;
-        if (b < h->len && h->comparison_f(h->heap[b], h->heap[j])) j = b;
+        if (last > h->len) last = h->len;
+        for (c = first; c < last; ++c) {
+            if (h->comparison_f(h->heap[c], h->heap[j])) j = c;
+        }
         if (i == j) break;
         tmp = h->heap[j];
         h->heap[j] = h->heap[i];
@@ -2146,440 +4561,3031 @@ static void rl_heap_remove(RL_Heap *h, int index)
     }
 }
 
-void *rl_heap_pop(RL_Heap *h)
+bool rl_heap_insert(RL_Heap *h, void *item)
+{
+    RL_ASSERT(h != NULL);
+    if (h == NULL) return false;
+
+    if (h->len == h->cap) {
+        /* resize the heap */
+        if (!rl_heap_reserve(h, h->cap + 1)) {
+            rl_heap_destroy(h);
+            return false;
+        }
+    }
+
+    h->heap[h->len] = item;
+    rl_heap_sift_up(h, h->len++);
+    RL_STATS_ADD(heap_pushes, 1);
+    return true;
+}
+
+bool rl_heap_insert_bulk(RL_Heap *h, void **items, int count)
+{
+    int i;
+    RL_ASSERT(h != NULL);
+    if (h == NULL) return false;
+    RL_ASSERT(items != NULL || count == 0);
+    if (items == NULL || count <= 0) return true;
+
+    if (!rl_heap_reserve(h, h->len + count)) {
+        rl_heap_destroy(h);
+        return false;
+    }
+    RL_STATS_ADD(heap_pushes, count);
+
+    if (count < h->len) {
+        /* cheaper to sift up each item when the heap is already large */
+        for (i = 0; i < count; ++i) {
+            h->heap[h->len] = items[i];
+            rl_heap_sift_up(h, h->len++);
+        }
+    } else {
+        memcpy(h->heap + h->len, items, sizeof(*items) * count);
+        h->len += count;
+        rl_heap_heapify(h);
+    }
+
+    return true;
+}
+
+void rl_heap_heapify(RL_Heap *h)
+{
+    int i;
+    RL_ASSERT(h != NULL);
+    if (h == NULL || h->len < 2) return;
+
+    /* sift down each parent starting with the last one (Floyd's method) */
+    for (i = (h->len - 2) / RL_HEAP_ARITY; i >= 0; --i) {
+        rl_heap_sift_down(h, i);
+    }
+}
+
+static void rl_heap_remove(RL_Heap *h, int index)
+{
+    RL_ASSERT(h);
+    if (h == NULL) {
+        return;
+    }
+
+    h->heap[index] = h->heap[--h->len];
+    rl_heap_sift_down(h, index);
+}
+
+void *rl_heap_pop(RL_Heap *h)
+{
+    void *r;
+    if (h == NULL) {
+        return NULL;
+    }
+
+    r = NULL;
+    if (h->len) {
+        RL_ASSERT(h->heap);
+        r = h->heap[0];
+        rl_heap_remove(h, 0);
+        RL_STATS_ADD(heap_pops, 1);
+    }
+    return r;
+}
+
+void *rl_heap_peek(RL_Heap *h)
+{
+    if (h == NULL) {
+        return NULL;
+    }
+
+    RL_ASSERT(h->heap);
+    if (h->len) {
+        return h->heap[0];
+    } else {
+        return NULL;
+    }
+}
+
+/**
+ * Actor scheduler
+ */
+
+#define RL_SCHEDULER_IN_WHEEL -1
+#define RL_SCHEDULER_UNUSED -2
+
+RL_Scheduler *rl_scheduler_create(int capacity, unsigned int wheel_size)
+{
+    return rl_scheduler_create_ex(capacity, wheel_size, NULL);
+}
+
+RL_Scheduler *rl_scheduler_create_ex(int capacity, unsigned int wheel_size, const RL_Allocator *allocator)
+{
+    RL_Scheduler *s;
+    unsigned int i;
+    RL_ASSERT(capacity > 0);
+    RL_ASSERT((wheel_size & (wheel_size - 1)) == 0 && "wheel_size must be 0 or a power of 2");
+    if (capacity <= 0 || (wheel_size & (wheel_size - 1)) != 0) return NULL;
+    s = (RL_Scheduler*) rl_calloc(allocator, 1, sizeof(*s));
+    RL_ASSERT(s);
+    if (s == NULL) return NULL;
+    s->allocator = allocator;
+    s->cap = capacity;
+    s->wheel_size = wheel_size;
+    s->free_list = RL_SCHEDULER_INVALID;
+    s->entries = (RL_SchedulerEntry*) rl_malloc(allocator, sizeof(*s->entries) * capacity);
+    s->heap = (RL_SchedulerHandle*) rl_malloc(allocator, sizeof(*s->heap) * capacity);
+    if (wheel_size) {
+        s->wheel = (RL_SchedulerHandle*) rl_malloc(allocator, sizeof(*s->wheel) * wheel_size * 2);
+    }
+    RL_ASSERT(s->entries && s->heap && (s->wheel || !wheel_size));
+    if (s->entries == NULL || s->heap == NULL || (s->wheel == NULL && wheel_size)) {
+        rl_scheduler_destroy(s);
+        return NULL;
+    }
+    for (i = 0; i < wheel_size * 2; ++i) {
+        s->wheel[i] = RL_SCHEDULER_INVALID;
+    }
+
+    return s;
+}
+
+void rl_scheduler_destroy(RL_Scheduler *s)
+{
+    if (s) {
+        if (s->entries) rl_free(s->allocator, s->entries);
+        if (s->heap) rl_free(s->allocator, s->heap);
+        if (s->wheel) rl_free(s->allocator, s->wheel);
+        rl_free(s->allocator, s);
+    }
+}
+
+int rl_scheduler_length(const RL_Scheduler *s)
+{
+    if (s == NULL) return 0;
+    return s->len;
+}
+
+/* grow an array of the scheduler */
+static void *rl_scheduler_grow(RL_Scheduler *s, void *array, size_t old_size, size_t size)
+{
+    return rl_realloc(s->allocator, array, old_size, size);
+}
+
+static bool rl_scheduler_reserve(RL_Scheduler *s)
+{
+    RL_SchedulerEntry *entries;
+    RL_SchedulerHandle *heap;
+    int cap = s->cap * 2;
+    if (s->entries_len < s->cap) return true;
+
+    entries = (RL_SchedulerEntry*) rl_scheduler_grow(s, s->entries, sizeof(*entries) * s->cap, sizeof(*entries) * cap);
+    RL_ASSERT(entries);
+    if (entries == NULL) return false;
+    s->entries = entries;
+    heap = (RL_SchedulerHandle*) rl_scheduler_grow(s, s->heap, sizeof(*heap) * s->cap, sizeof(*heap) * cap);
+    RL_ASSERT(heap);
+    if (heap == NULL) return false;
+    s->heap = heap;
+    s->cap = cap;
+
+    return true;
+}
+
+/* does a act before b? */
+static bool rl_scheduler_before(const RL_Scheduler *s, RL_SchedulerHandle a, RL_SchedulerHandle b)
+{
+    const RL_SchedulerEntry *ea = &s->entries[a];
+    const RL_SchedulerEntry *eb = &s->entries[b];
+
+    return ea->time < eb->time || (ea->time == eb->time && ea->sequence < eb->sequence);
+}
+
+static void rl_scheduler_heap_set(RL_Scheduler *s, int index, RL_SchedulerHandle handle)
+{
+    s->heap[index] = handle;
+    s->entries[handle].index = index;
+}
+
+static void rl_scheduler_sift_up(RL_Scheduler *s, int index)
+{
+    RL_SchedulerHandle handle = s->heap[index];
+    while (index) {
+        int p = (index - 1) / RL_HEAP_ARITY;
+        if (!rl_scheduler_before(s, handle, s->heap[p])) break;
+        rl_scheduler_heap_set(s, index, s->heap[p]);
+        index = p;
+    }
+    rl_scheduler_heap_set(s, index, handle);
+}
+
+static void rl_scheduler_sift_down(RL_Scheduler *s, int index)
+{
+    RL_SchedulerHandle handle = s->heap[index];
+    for (;;) {
+        int first = RL_HEAP_ARITY*index + 1;
+        int last = first + RL_HEAP_ARITY;
+        int c, j = -1;
+        if (last > s->heap_len) last = s->heap_len;
+        for (c = first; c < last; ++c) {
+            if (rl_scheduler_before(s, s->heap[c], j < 0 ? handle : s->heap[j])) j = c;
+        }
+        if (j < 0) break;
+        rl_scheduler_heap_set(s, index, s->heap[j]);
+        index = j;
+    }
+    rl_scheduler_heap_set(s, index, handle);
+}
+
+/* add the entry to the wheel bucket for its time, or to the overflow heap if too far ahead */
+static void rl_scheduler_place(RL_Scheduler *s, RL_SchedulerHandle handle)
+{
+    RL_SchedulerEntry *e = &s->entries[handle];
+    if (e->time - s->now < s->wheel_size) {
+        unsigned int bucket = (unsigned int) (e->time & (s->wheel_size - 1));
+        RL_SchedulerHandle *first = &s->wheel[bucket*2];
+        RL_SchedulerHandle *last = &s->wheel[bucket*2 + 1];
+        e->index = RL_SCHEDULER_IN_WHEEL;
+        e->prev = *last;
+        e->next = RL_SCHEDULER_INVALID;
+        if (*last == RL_SCHEDULER_INVALID) {
+            *first = handle;
+        } else {
+            s->entries[*last].next = handle;
+        }
+        *last = handle;
+        s->wheel_len++;
+    } else {
+        s->heap[s->heap_len] = handle;
+        rl_scheduler_sift_up(s, s->heap_len++);
+        RL_STATS_ADD(heap_pushes, 1);
+    }
+}
+
+static void rl_scheduler_detach(RL_Scheduler *s, RL_SchedulerHandle handle)
+{
+    RL_SchedulerEntry *e = &s->entries[handle];
+    if (e->index == RL_SCHEDULER_IN_WHEEL) {
+        unsigned int bucket = (unsigned int) (e->time & (s->wheel_size - 1));
+        if (e->prev == RL_SCHEDULER_INVALID) {
+            s->wheel[bucket*2] = e->next;
+        } else {
+            s->entries[e->prev].next = e->next;
+        }
+        if (e->next == RL_SCHEDULER_INVALID) {
+            s->wheel[bucket*2 + 1] = e->prev;
+        } else {
+            s->entries[e->next].prev = e->prev;
+        }
+        s->wheel_len--;
+    } else {
+        int index = e->index;
+        RL_SchedulerHandle moved = s->heap[--s->heap_len];
+        if (index < s->heap_len) {
+            rl_scheduler_heap_set(s, index, moved);
+            rl_scheduler_sift_up(s, index);
+            rl_scheduler_sift_down(s, s->entries[moved].index);
+        }
+        RL_STATS_ADD(heap_pops, 1);
+    }
+}
+
+static bool rl_scheduler_valid(const RL_Scheduler *s, RL_SchedulerHandle handle)
+{
+    return s != NULL && handle >= 0 && handle < s->entries_len && s->entries[handle].index != RL_SCHEDULER_UNUSED;
+}
+
+RL_SchedulerHandle rl_scheduler_insert(RL_Scheduler *s, void *actor, unsigned long delay)
+{
+    RL_SchedulerHandle handle;
+    RL_SchedulerEntry *e;
+    RL_ASSERT(s != NULL);
+    if (s == NULL) return RL_SCHEDULER_INVALID;
+
+    if (s->free_list != RL_SCHEDULER_INVALID) {
+        handle = s->free_list;
+        s->free_list = s->entries[handle].next;
+    } else {
+        if (!rl_scheduler_reserve(s)) return RL_SCHEDULER_INVALID;
+        handle = s->entries_len++;
+    }
+    e = &s->entries[handle];
+    e->actor = actor;
+    e->time = s->now + delay;
+    e->sequence = s->sequence++;
+    rl_scheduler_place(s, handle);
+    s->len++;
+
+    return handle;
+}
+
+bool rl_scheduler_reschedule(RL_Scheduler *s, RL_SchedulerHandle handle, unsigned long delay)
+{
+    RL_SchedulerEntry *e;
+    RL_ASSERT(rl_scheduler_valid(s, handle));
+    if (!rl_scheduler_valid(s, handle)) return false;
+
+    e = &s->entries[handle];
+    if (e->index != RL_SCHEDULER_IN_WHEEL && delay >= s->wheel_size) {
+        /* staying in the heap - update the position in place */
+        e->time = s->now + delay;
+        e->sequence = s->sequence++;
+        rl_scheduler_sift_up(s, e->index);
+        rl_scheduler_sift_down(s, e->index);
+    } else {
+        rl_scheduler_detach(s, handle);
+        e->time = s->now + delay;
+        e->sequence = s->sequence++;
+        rl_scheduler_place(s, handle);
+    }
+
+    return true;
+}
+
+void *rl_scheduler_remove(RL_Scheduler *s, RL_SchedulerHandle handle)
+{
+    RL_SchedulerEntry *e;
+    RL_ASSERT(rl_scheduler_valid(s, handle));
+    if (!rl_scheduler_valid(s, handle)) return NULL;
+
+    e = &s->entries[handle];
+    rl_scheduler_detach(s, handle);
+    e->index = RL_SCHEDULER_UNUSED;
+    e->next = s->free_list;
+    s->free_list = handle;
+    s->len--;
+
+    return e->actor;
+}
+
+RL_SchedulerHandle rl_scheduler_next(RL_Scheduler *s)
+{
+    RL_SchedulerHandle next = RL_SCHEDULER_INVALID;
+    RL_ASSERT(s != NULL);
+    if (s == NULL) return RL_SCHEDULER_INVALID;
+
+    if (s->wheel_len) {
+        /* every actor in the wheel acts within wheel_size ticks - the first non-empty bucket is the earliest, and
+         * each bucket is in sequence order */
+        unsigned int i;
+        for (i = 0; i < s->wheel_size; ++i) {
+            unsigned int bucket = (unsigned int) ((s->now + i) & (s->wheel_size - 1));
+            if (s->wheel[bucket*2] != RL_SCHEDULER_INVALID) {
+                next = s->wheel[bucket*2];
+                break;
+            }
+        }
+        RL_ASSERT(next != RL_SCHEDULER_INVALID);
+    }
+    if (s->heap_len && (next == RL_SCHEDULER_INVALID || rl_scheduler_before(s, s->heap[0], next))) {
+        next = s->heap[0];
+    }
+    if (next != RL_SCHEDULER_INVALID) {
+        s->now = s->entries[next].time;
+    }
+
+    return next;
+}
+
+void *rl_scheduler_actor(const RL_Scheduler *s, RL_SchedulerHandle handle)
+{
+    RL_ASSERT(rl_scheduler_valid(s, handle));
+    if (!rl_scheduler_valid(s, handle)) return NULL;
+
+    return s->entries[handle].actor;
+}
+
+unsigned long rl_scheduler_delay(unsigned int cost, unsigned int speed)
+{
+    unsigned long delay;
+    RL_ASSERT(speed > 0);
+    if (speed == 0) return (unsigned long) -1;
+    delay = ((unsigned long) cost + speed - 1) / speed;
+
+    return delay ? delay : 1;
+}
+
+/**
+ * Occupancy index
+ */
+
+#define RL_OCCUPANCY_NOT_INSERTED -2
+
+RL_Occupancy rl_occupancy_create(unsigned int width, unsigned int height, int capacity)
+{
+    return rl_occupancy_create_ex(width, height, capacity, NULL);
+}
+
+RL_Occupancy rl_occupancy_create_ex(unsigned int width, unsigned int height, int capacity, const RL_Allocator *allocator)
+{
+    RL_Occupancy occupancy;
+    int i;
+    RL_ASSERT(width > 0 && height > 0 && capacity > 0);
+    memset(&occupancy, 0, sizeof(occupancy));
+    occupancy.allocator = allocator;
+    occupancy.heads = (int*) rl_malloc(allocator, sizeof(*occupancy.heads) * width * height);
+    occupancy.counts = (unsigned int*) rl_calloc(allocator, width * height, sizeof(*occupancy.counts));
+    occupancy.entities = (RL_OccupancyEntity*) rl_malloc(allocator, sizeof(*occupancy.entities) * capacity);
+    RL_ASSERT(occupancy.heads && occupancy.counts && occupancy.entities);
+    if (occupancy.heads == NULL || occupancy.counts == NULL || occupancy.entities == NULL) {
+        rl_occupancy_destroy(occupancy);
+        memset(&occupancy, 0, sizeof(occupancy));
+        return occupancy;
+    }
+    occupancy.width = width;
+    occupancy.height = height;
+    occupancy.capacity = capacity;
+    for (i = 0; i < capacity; ++i) {
+        occupancy.entities[i].prev = RL_OCCUPANCY_NOT_INSERTED;
+    }
+    for (i = 0; i < (int) (width * height); ++i) {
+        occupancy.heads[i] = -1;
+    }
+
+    return occupancy;
+}
+
+void rl_occupancy_destroy(RL_Occupancy occupancy)
+{
+    if (occupancy.heads) rl_free(occupancy.allocator, occupancy.heads);
+    if (occupancy.counts) rl_free(occupancy.allocator, occupancy.counts);
+    if (occupancy.entities) rl_free(occupancy.allocator, occupancy.entities);
+}
+
+void rl_occupancy_clear(RL_Occupancy *occupancy)
+{
+    size_t i;
+    RL_ASSERT(occupancy != NULL);
+    if (occupancy == NULL || occupancy->heads == NULL) return;
+    for (i = 0; i < (size_t) occupancy->capacity; ++i) {
+        occupancy->entities[i].prev = RL_OCCUPANCY_NOT_INSERTED;
+    }
+    for (i = 0; i < (size_t) occupancy->width * occupancy->height; ++i) {
+        occupancy->heads[i] = -1;
+    }
+    memset(occupancy->counts, 0, sizeof(*occupancy->counts) * occupancy->width * occupancy->height);
+}
+
+static bool rl_occupancy_is_inserted(const RL_Occupancy *occupancy, int id)
+{
+    return id >= 0 && id < occupancy->capacity && occupancy->entities[id].prev != RL_OCCUPANCY_NOT_INSERTED;
+}
+
+/* link the entity at the head of the tile's list */
+static void rl_occupancy_link(RL_Occupancy *occupancy, int id, unsigned int x, unsigned int y)
+{
+    RL_OccupancyEntity *e = &occupancy->entities[id];
+    size_t idx = x + (size_t) y * occupancy->width;
+    e->x = x;
+    e->y = y;
+    e->prev = -1;
+    e->next = occupancy->heads[idx];
+    if (e->next >= 0) {
+        occupancy->entities[e->next].prev = id;
+    }
+    occupancy->heads[idx] = id;
+    occupancy->counts[idx]++;
+}
+
+static void rl_occupancy_unlink(RL_Occupancy *occupancy, int id)
+{
+    RL_OccupancyEntity *e = &occupancy->entities[id];
+    size_t idx = e->x + (size_t) e->y * occupancy->width;
+    if (e->prev >= 0) {
+        occupancy->entities[e->prev].next = e->next;
+    } else {
+        occupancy->heads[idx] = e->next;
+    }
+    if (e->next >= 0) {
+        occupancy->entities[e->next].prev = e->prev;
+    }
+    occupancy->counts[idx]--;
+}
+
+bool rl_occupancy_insert(RL_Occupancy *occupancy, int id, unsigned int x, unsigned int y)
+{
+    RL_ASSERT(occupancy != NULL && occupancy->heads != NULL);
+    if (occupancy == NULL || occupancy->heads == NULL) return false;
+    RL_ASSERT(id >= 0);
+    if (id < 0 || x >= occupancy->width || y >= occupancy->height) return false;
+    if (id >= occupancy->capacity) {
+        /* grow to fit the id */
+        RL_OccupancyEntity *entities;
+        int i, capacity = occupancy->capacity;
+        while (capacity <= id) capacity *= 2;
+        entities = (RL_OccupancyEntity*) rl_realloc(occupancy->allocator, occupancy->entities,
+                                                    sizeof(*entities) * occupancy->capacity, sizeof(*entities) * capacity);
+        RL_ASSERT(entities);
+        if (entities == NULL) return false;
+        for (i = occupancy->capacity; i < capacity; ++i) {
+            entities[i].prev = RL_OCCUPANCY_NOT_INSERTED;
+        }
+        occupancy->entities = entities;
+        occupancy->capacity = capacity;
+    }
+    if (rl_occupancy_is_inserted(occupancy, id)) return false;
+    rl_occupancy_link(occupancy, id, x, y);
+
+    return true;
+}
+
+bool rl_occupancy_move(RL_Occupancy *occupancy, int id, unsigned int x, unsigned int y)
+{
+    RL_ASSERT(occupancy != NULL && occupancy->heads != NULL);
+    if (occupancy == NULL || occupancy->heads == NULL) return false;
+    if (!rl_occupancy_is_inserted(occupancy, id) || x >= occupancy->width || y >= occupancy->height) return false;
+    rl_occupancy_unlink(occupancy, id);
+    rl_occupancy_link(occupancy, id, x, y);
+
+    return true;
+}
+
+void rl_occupancy_remove(RL_Occupancy *occupancy, int id)
+{
+    RL_ASSERT(occupancy != NULL && occupancy->heads != NULL);
+    if (occupancy == NULL || occupancy->heads == NULL) return;
+    if (!rl_occupancy_is_inserted(occupancy, id)) return;
+    rl_occupancy_unlink(occupancy, id);
+    occupancy->entities[id].prev = RL_OCCUPANCY_NOT_INSERTED;
+}
+
+unsigned int rl_occupancy_count(const RL_Occupancy *occupancy, unsigned int x, unsigned int y)
+{
+    RL_ASSERT(occupancy != NULL);
+    if (occupancy == NULL || occupancy->counts == NULL || x >= occupancy->width || y >= occupancy->height) return 0;
+
+    return occupancy->counts[x + (size_t) y * occupancy->width];
+}
+
+int rl_occupancy_first(const RL_Occupancy *occupancy, unsigned int x, unsigned int y)
+{
+    RL_ASSERT(occupancy != NULL);
+    if (occupancy == NULL || occupancy->heads == NULL || x >= occupancy->width || y >= occupancy->height) return -1;
+
+    return occupancy->heads[x + (size_t) y * occupancy->width];
+}
+
+int rl_occupancy_next(const RL_Occupancy *occupancy, int id)
+{
+    RL_ASSERT(occupancy != NULL);
+    if (occupancy == NULL || !rl_occupancy_is_inserted(occupancy, id)) return -1;
+
+    return occupancy->entities[id].next;
+}
+
+RL_Status rl_rng_map_point_matching(RL_Map map, void *context, bool (*f)(const RL_Map map, void *context, unsigned int x, unsigned int y), unsigned int *dx, unsigned int *dy)
+{
+    unsigned int count, x, y;
+
+    RL_ASSERT(map.tiles != NULL);
+    if (map.tiles == NULL) {
+        return RL_ErrorNullParameter;
+    }
+    RL_ASSERT(dx != NULL && dy != NULL);
+    if (dx == NULL || dy == NULL) {
+        return RL_ErrorNullParameter;
+    }
+
+    /* simple reservoir sampling algorithm (k == 1) */
+    count = 0;
+    for (x=0; x<map.width; x++) {
+        for (y=0; y<map.height; y++) {
+            if (f == NULL || f(map, context, x, y)) {
+                count++;
+                if (RL_RNG_F(0, count - 1) == 0) {
+                    *dx = x;
+                    *dy = y;
+                }
+            }
+        }
+    }
+
+    return count > 0 ? RL_OK : RL_ErrorNotFound;
+}
+
+bool rl_rng_map_is_tile(RL_Map map, void *context, unsigned int x, unsigned int y)
+{
+    RL_Byte *t = (RL_Byte*) context;
+    RL_ASSERT(t != NULL);
+    return map.tiles[x+y*map.width] == *t;
+}
+RL_Status rl_rng_map_point(RL_Map map, RL_Byte t, unsigned int *dx, unsigned int *dy)
+{
+    return rl_rng_map_point_matching(map, &t, rl_rng_map_is_tile, dx, dy);
+}
+
+bool rl_rng_map_is_passable(RL_Map map, void *context, unsigned int x, unsigned int y)
+{
+    RL_UNUSED(context);
+    return RL_PASSABLE_F(map, x, y);
+}
+RL_Status rl_rng_map_passable(RL_Map map, unsigned int *x, unsigned int *y)
+{
+    return rl_rng_map_point_matching(map, NULL, rl_rng_map_is_passable, x, y);
+}
+
+RL_Status rl_rng_map_room(RL_Map map, RL_BSP *bsp, unsigned int *x, unsigned int *y)
+{
+    return rl_rng_map_room_matching(map, bsp, NULL, NULL, x, y);
+}
+
+RL_Status rl_rng_map_room_matching(RL_Map map, RL_BSP *bsp, void *context, bool (*f)(const RL_Map map, void *context, unsigned int x, unsigned int y), unsigned int *dx, unsigned int *dy)
+{
+    unsigned int i, x, y;
+    size_t leaf_count, match_count;
+    RL_BSP *leaf;
+
+    RL_ASSERT(bsp != NULL && map.tiles != NULL && dx != NULL && dy != NULL);
+    if (bsp == NULL || map.tiles == NULL || dx == NULL || dy == NULL) return RL_ErrorNullParameter;
+
+    leaf_count = rl_bsp_leaf_count(bsp);
+    RL_ASSERT(leaf_count > 0);
+
+    /* find the first leaf */
+    leaf = bsp;
+    while (leaf->left != NULL) leaf = leaf->left;
+
+    /* generate random room matching given function */
+    match_count = 0;
+    for (i=0; i<leaf_count; i++, leaf = rl_bsp_next_leaf(leaf)) {
+        RL_ASSERT(leaf != NULL && rl_bsp_is_leaf(leaf));
+        if (!rl_bsp_find_room(map, leaf, &x, &y)) {
+            continue;
+        }
+        if (f == NULL || f(map, context, x, y)) {
+            match_count++;
+            if (RL_RNG_F(0, match_count - 1) == 0) {
+                *dx = x;
+                *dy = y;
+            }
+        }
+    }
+    RL_ASSERT(match_count > 0);
+
+    if (match_count == 0) {
+        return RL_ErrorNotFound;
+    }
+
+    return RL_OK;
+}
+
+RL_WeightedTable rl_weighted_table_create(const float *weights, size_t length)
+{
+    return rl_weighted_table_create_ex(weights, length, NULL);
+}
+
+RL_WeightedTable rl_weighted_table_create_ex(const float *weights, size_t length, const RL_Allocator *allocator)
+{
+    RL_WeightedTable table = {0};
+    unsigned char *memory;
+    size_t *work, small = 0, large, i;
+    double total = 0, *scaled;
+    /* the column is drawn with RL_RNG_F(0, length - 1), which must stay below RAND_MAX (32767 on MSVC) */
+    RL_ASSERT(weights != NULL && length > 0 && length <= (size_t) RAND_MAX && length <= UINT_MAX);
+    if (weights == NULL || length == 0 || length > (size_t) RAND_MAX || length > UINT_MAX) return table;
+    for (i = 0; i < length; ++i) {
+        if (weights[i] > 0) total += weights[i];
+    }
+    RL_ASSERT(total > 0);
+    if (total <= 0) return table;
+    /* allocate all the memory we need at once - the scaled weights & worklist are only used while building */
+    memory = (unsigned char*) rl_malloc(allocator, (sizeof(*table.thresholds) + sizeof(*table.aliases)) * length);
+    scaled = (double*) rl_malloc(allocator, (sizeof(*scaled) + sizeof(*work)) * length);
+    if (memory == NULL || scaled == NULL) {
+        if (memory) rl_free(allocator, memory);
+        if (scaled) rl_free(allocator, scaled);
+        return table;
+    }
+    table.allocator = allocator;
+    table.length = length;
+    table.aliases = (size_t*) memory;
+    table.thresholds = (unsigned int*) (memory + sizeof(*table.aliases) * length);
+    work = (size_t*) (scaled + length);
+
+    /* Vose's alias method - small entries (scaled weight < 1) from the front of the worklist, large from the back */
+    large = length;
+    for (i = 0; i < length; ++i) {
+        scaled[i] = (weights[i] > 0 ? weights[i] : 0) * length / total;
+        if (scaled[i] < 1) work[small++] = i;
+        else work[--large] = i;
+    }
+    while (small > 0 && large < length) {
+        size_t s = work[--small], l = work[large++];
+        table.thresholds[s] = (unsigned int) (scaled[s] * RL_WEIGHTED_TABLE_RESOLUTION + 0.5);
+        table.aliases[s] = l;
+        scaled[l] -= 1 - scaled[s];
+        if (scaled[l] < 1) work[small++] = l;
+        else work[--large] = l;
+    }
+    /* the rest are full columns (up to rounding) */
+    while (small > 0) {
+        size_t s = work[--small];
+        table.thresholds[s] = RL_WEIGHTED_TABLE_RESOLUTION;
+        table.aliases[s] = s;
+    }
+    while (large < length) {
+        size_t l = work[large++];
+        table.thresholds[l] = RL_WEIGHTED_TABLE_RESOLUTION;
+        table.aliases[l] = l;
+    }
+    rl_free(allocator, scaled);
+
+    return table;
+}
+
+void rl_weighted_table_destroy(RL_WeightedTable table)
+{
+    if (table.aliases) {
+        rl_free(table.allocator, table.aliases);
+    }
+}
+
+size_t rl_weighted_table_sample(const RL_WeightedTable table)
+{
+    return rl_weighted_table_sample_with(table, NULL, NULL);
+}
+
+size_t rl_weighted_table_sample_with(const RL_WeightedTable table, RL_RngFun rng_f, void *context)
+{
+    size_t column;
+    unsigned int coin;
+    RL_ASSERT(table.thresholds != NULL);
+    if (table.thresholds == NULL) return 0;
+    if (rng_f) {
+        column = rng_f(context, 0, table.length - 1);
+        coin = rng_f(context, 0, RL_WEIGHTED_TABLE_RESOLUTION - 1);
+    } else {
+        column = RL_RNG_F(0, table.length - 1);
+        coin = RL_RNG_F(0, RL_WEIGHTED_TABLE_RESOLUTION - 1);
+    }
+
+    return coin < table.thresholds[column] ? column : table.aliases[column];
+}
+
+RL_Status rl_weighted_table_sample_many(const RL_WeightedTable table, size_t *out, size_t count, RL_RngFun rng_f, void *context)
+{
+    size_t i;
+    RL_ASSERT(table.thresholds != NULL && out != NULL);
+    if (table.thresholds == NULL || out == NULL) return RL_ErrorNullParameter;
+    for (i = 0; i < count; ++i) {
+        out[i] = rl_weighted_table_sample_with(table, rng_f, context);
+    }
+
+    return RL_OK;
+}
+
+RL_FloodFill *rl_floodfill_create(unsigned int width, unsigned int height)
+{
+    return rl_floodfill_create_ex(width, height, NULL);
+}
+
+RL_FloodFill *rl_floodfill_create_ex(unsigned int width, unsigned int height, const RL_Allocator *allocator)
+{
+    RL_FloodFill *fill;
+    RL_ASSERT(width > 0 && height > 0);
+    RL_ASSERT(width != UINT_MAX && !(width > UINT_MAX / height)); /* check for overflow */
+    fill = (RL_FloodFill*) rl_calloc(allocator, 1, sizeof(*fill));
+    RL_ASSERT(fill);
+    if (fill == NULL) return NULL;
+    fill->allocator = allocator;
+    fill->width = width;
+    fill->height = height;
+    fill->mask = (RL_Byte*) rl_calloc(allocator, ((size_t) width * height + 7) / 8, sizeof(*fill->mask));
+    fill->stack_cap = 64;
+    fill->stack = (unsigned int*) rl_malloc(allocator, sizeof(*fill->stack) * 2 * fill->stack_cap);
+    if (fill->mask == NULL || fill->stack == NULL) {
+        rl_floodfill_destroy(fill);
+        return NULL;
+    }
+
+    return fill;
+}
+
+void rl_floodfill_destroy(RL_FloodFill *fill)
+{
+    if (fill == NULL) return;
+    if (fill->mask) rl_free(fill->allocator, fill->mask);
+    if (fill->stack) rl_free(fill->allocator, fill->stack);
+    rl_free(fill->allocator, fill);
+}
+
+static bool rl_floodfill_is_set(const RL_FloodFill *fill, size_t idx)
+{
+    return (fill->mask[idx >> 3] & (1u << (idx & 7))) != 0;
+}
+
+/* does the tile need filling? */
+static bool rl_floodfill_matches(const RL_FloodFill *fill, const RL_Map *map, unsigned int x, unsigned int y, void *context, RL_MatchesFun matches_f)
+{
+    if (rl_floodfill_is_set(fill, (size_t) x + (size_t) y * map->width)) return false;
+
+    return matches_f ? matches_f(*map, context, x, y) : RL_PASSABLE_F(*map, x, y);
+}
+
+static bool rl_floodfill_push(RL_FloodFill *fill, unsigned int x, unsigned int y)
+{
+    if (fill->stack_len == fill->stack_cap) {
+        unsigned int *stack;
+        stack = (unsigned int*) rl_realloc(fill->allocator, fill->stack, sizeof(*stack) * 2 * fill->stack_cap,
+                                           sizeof(*stack) * 4 * fill->stack_cap);
+        RL_ASSERT(stack);
+        if (stack == NULL) return false;
+        fill->stack = stack;
+        fill->stack_cap *= 2;
+    }
+    fill->stack[fill->stack_len*2] = x;
+    fill->stack[fill->stack_len*2 + 1] = y;
+    fill->stack_len++;
+
+    return true;
+}
+
+/* pushes the first tile of each run of tiles needing a fill on row y from from to to */
+static bool rl_floodfill_seed_row(RL_FloodFill *fill, const RL_Map *map, unsigned int y, unsigned int from, unsigned int to, void *context, RL_MatchesFun matches_f)
+{
+    size_t row = (size_t) y * map->width;
+    unsigned int x = from;
+    if (matches_f == NULL) {
+        /* fast path - a single pass over the row for the passable runs, skipping the callback & whole bytes of the
+         * mask that are already filled */
+        while (x <= to) {
+            while (x <= to) {
+                size_t idx = row + x;
+                if ((idx & 7) == 0 && to - x >= 7 && fill->mask[idx >> 3] == 0xFF) {
+                    x += 8;
+                    continue;
+                }
+                if (!rl_floodfill_is_set(fill, idx) && RL_PASSABLE_F(*map, x, y)) break;
+                x++;
+            }
+            if (x > to) break;
+            if (!rl_floodfill_push(fill, x, y)) return false;
+            while (x <= to && !rl_floodfill_is_set(fill, row + x) && RL_PASSABLE_F(*map, x, y)) x++;
+        }
+        return true;
+    }
+    while (x <= to) {
+        while (x <= to && !rl_floodfill_matches(fill, map, x, y, context, matches_f)) x++;
+        if (x > to) break;
+        if (!rl_floodfill_push(fill, x, y)) return false;
+        while (x <= to && rl_floodfill_matches(fill, map, x, y, context, matches_f)) x++;
+    }
+
+    return true;
+}
+
+RL_Status rl_floodfill(RL_FloodFill *fill, const RL_Map map, unsigned int x, unsigned int y, bool allow_diagonal, void *context, RL_MatchesFun matches_f, RL_FillFun fill_f)
+{
+    unsigned int cur_x, cur_y, max_x, max_y;
+    RL_ASSERT(fill != NULL && map.tiles != NULL);
+    if (fill == NULL || map.tiles == NULL) return RL_ErrorNullParameter;
+    RL_ASSERT(fill->width == map.width && fill->height == map.height);
+    if (fill->width != map.width || fill->height != map.height) return RL_ErrorInvalidParameter;
+    if (!rl_map_in_bounds(map, x, y)) return RL_ErrorInvalidParameter;
+
+    /* clear the previous fill */
+    for (cur_y = fill->bounds.y; cur_y < fill->bounds.y + fill->bounds.height; ++cur_y) {
+        for (cur_x = fill->bounds.x; cur_x < fill->bounds.x + fill->bounds.width; ++cur_x) {
+            size_t idx = cur_x + cur_y * map.width;
+            fill->mask[idx >> 3] &= ~(1u << (idx & 7));
+        }
+    }
+    fill->count = 0;
+    fill->bounds.x = x;
+    fill->bounds.y = y;
+    fill->bounds.width = fill->bounds.height = 0;
+    max_x = x;
+    max_y = y;
+    fill->stack_len = 0;
+    if (!rl_floodfill_matches(fill, &map, x, y, context, matches_f)) return RL_OK;
+    if (!rl_floodfill_push(fill, x, y)) return RL_ErrorMemory;
+    RL_TRACE_BEGIN("rl_floodfill");
+    while (fill->stack_len) {
+        unsigned int left, right, from, to;
+        int dy;
+        fill->stack_len--;
+        x = fill->stack[fill->stack_len*2];
+        y = fill->stack[fill->stack_len*2 + 1];
+        if (rl_floodfill_is_set(fill, (size_t) x + (size_t) y * map.width)) continue;
+
+        /* fill the span */
+        left = right = x;
+        while (left > 0 && rl_floodfill_matches(fill, &map, left - 1, y, context, matches_f)) left--;
+        while (right + 1 < map.width && rl_floodfill_matches(fill, &map, right + 1, y, context, matches_f)) right++;
+        for (cur_x = left; cur_x <= right; ++cur_x) {
+            size_t idx = cur_x + y * map.width;
+            fill->mask[idx >> 3] |= 1u << (idx & 7);
+            if (fill_f) fill_f(cur_x, y, context);
+        }
+        fill->count += right - left + 1;
+        if (left < fill->bounds.x) fill->bounds.x = left;
+        if (right > max_x) max_x = right;
+        if (y < fill->bounds.y) fill->bounds.y = y;
+        if (y > max_y) max_y = y;
+        fill->bounds.width = max_x - fill->bounds.x + 1;
+        fill->bounds.height = max_y - fill->bounds.y + 1;
+
+        /* seed the start of each matching run above & below the span */
+        from = allow_diagonal && left > 0 ? left - 1 : left;
+        to = allow_diagonal && right + 1 < map.width ? right + 1 : right;
+        for (dy = -1; dy <= 1; dy += 2) {
+            unsigned int ny = y + dy;
+            if (ny >= map.height) continue;
+            if (!rl_floodfill_seed_row(fill, &map, ny, from, to, context, matches_f)) {
+                RL_TRACE_END("rl_floodfill");
+                return RL_ErrorMemory;
+            }
+        }
+    }
+    RL_TRACE_END("rl_floodfill");
+
+    return RL_OK;
+}
+
+bool rl_floodfill_is_filled(const RL_FloodFill *fill, unsigned int x, unsigned int y)
+{
+    size_t idx;
+    if (fill == NULL || x >= fill->width || y >= fill->height) return false;
+    idx = x + y * fill->width;
+
+    return rl_floodfill_is_set(fill, idx);
+}
+
+/* neighbors in order around the tile, so neighbors next to each other in the ring are adjacent */
+static const int rl_reachability_ring_x[8] = { 0, 1, 1, 1, 0, -1, -1, -1 };
+static const int rl_reachability_ring_y[8] = { -1, -1, 0, 1, 1, 1, 0, -1 };
+
+RL_Reachability *rl_reachability_create(const RL_Map map)
+{
+    return rl_reachability_create_ex(map, NULL);
+}
+
+RL_Reachability *rl_reachability_create_ex(const RL_Map map, const RL_Allocator *allocator)
+{
+    RL_Reachability *reach;
+    size_t length = (size_t) map.width * map.height;
+    RL_ASSERT(map.tiles != NULL);
+    if (map.tiles == NULL) return NULL;
+    RL_ASSERT(length < UINT_MAX / 4);
+    reach = (RL_Reachability*) rl_calloc(allocator, 1, sizeof(*reach));
+    RL_ASSERT(reach);
+    if (reach == NULL) return NULL;
+    reach->allocator = allocator;
+    reach->map = map;
+    reach->labels_cap = length * 2 + 8;
+    reach->labels = (unsigned int*) rl_malloc(allocator, sizeof(*reach->labels) * length);
+    reach->parents = (unsigned int*) rl_malloc(allocator, sizeof(*reach->parents) * reach->labels_cap);
+    reach->stack = (unsigned int*) rl_malloc(allocator, sizeof(*reach->stack) * length);
+    if (reach->labels == NULL || reach->parents == NULL || reach->stack == NULL ||
+            rl_reachability_rebuild(reach) != RL_OK) {
+        rl_reachability_destroy(reach);
+        return NULL;
+    }
+
+    return reach;
+}
+
+void rl_reachability_destroy(RL_Reachability *reach)
+{
+    if (reach == NULL) return;
+    if (reach->labels) rl_free(reach->allocator, reach->labels);
+    if (reach->parents) rl_free(reach->allocator, reach->parents);
+    if (reach->stack) rl_free(reach->allocator, reach->stack);
+    rl_free(reach->allocator, reach);
+}
+
+static unsigned int rl_reachability_find(RL_Reachability *reach, unsigned int label)
+{
+    /* path halving */
+    while (reach->parents[label] != label) {
+        reach->parents[label] = reach->parents[reach->parents[label]];
+        label = reach->parents[label];
+    }
+
+    return label;
+}
+
+/* labels every tile connected to start with a new label */
+static unsigned int rl_reachability_flood(RL_Reachability *reach, size_t start)
+{
+    RL_Map map = reach->map;
+    unsigned int label = reach->labels_len++;
+    size_t len = 0;
+    reach->parents[label] = label;
+    reach->labels[start] = label;
+    reach->stack[len++] = start;
+    while (len) {
+        size_t idx = reach->stack[--len];
+        int i;
+        for (i = 0; i < 8; ++i) {
+            unsigned int x = idx % map.width + rl_reachability_ring_x[i], y = idx / map.width + rl_reachability_ring_y[i];
+            size_t n = x + y*map.width;
+            if (!rl_map_in_bounds(map, x, y) || reach->labels[n] == label || !RL_PASSABLE_F(map, x, y)) continue;
+            reach->labels[n] = label;
+            reach->stack[len++] = n;
+        }
+    }
+
+    return label;
+}
+
+RL_Status rl_reachability_rebuild(RL_Reachability *reach)
+{
+    size_t length, i;
+    RL_ASSERT(reach != NULL);
+    if (reach == NULL) return RL_ErrorNullParameter;
+    length = (size_t) reach->map.width * reach->map.height;
+    RL_TRACE_BEGIN("rl_reachability_rebuild");
+    memset(reach->labels, 0, sizeof(*reach->labels) * length);
+    reach->labels_len = 1; /* 0 is impassable */
+    for (i = 0; i < length; ++i) {
+        if (reach->labels[i] == 0 && RL_PASSABLE_F(reach->map, i % reach->map.width, i / reach->map.width)) {
+            rl_reachability_flood(reach, i);
+        }
+    }
+    RL_TRACE_END("rl_reachability_rebuild");
+
+    return RL_OK;
+}
+
+RL_Status rl_reachability_update(RL_Reachability *reach, unsigned int x, unsigned int y)
+{
+    RL_Map map;
+    size_t idx;
+    bool passable;
+    int i, j, groups = 0;
+    int group[8];
+    RL_ASSERT(reach != NULL);
+    if (reach == NULL) return RL_ErrorNullParameter;
+    map = reach->map;
+    if (!rl_map_in_bounds(map, x, y)) return RL_ErrorInvalidParameter;
+    idx = x + y*map.width;
+    passable = RL_PASSABLE_F(map, x, y);
+    if (passable == (reach->labels[idx] != 0)) return RL_OK;
+    /* an update adds at most 4 labels - when there is no room left compact the labels */
+    if (reach->labels_len + 8 > reach->labels_cap) return rl_reachability_rebuild(reach);
+
+    if (passable) {
+        /* dug - merge the neighbors */
+        unsigned int root = 0;
+        for (i = 0; i < 8; ++i) {
+            unsigned int nx = x + rl_reachability_ring_x[i], ny = y + rl_reachability_ring_y[i];
+            unsigned int other;
+            if (!rl_map_in_bounds(map, nx, ny) || reach->labels[nx + ny*map.width] == 0) continue;
+            other = rl_reachability_find(reach, reach->labels[nx + ny*map.width]);
+            if (root == 0) root = other;
+            else if (other != root) reach->parents[other] = root;
+        }
+        if (root == 0) {
+            root = reach->labels_len++;
+            reach->parents[root] = root;
+        }
+        reach->labels[idx] = root;
+
+        return RL_OK;
+    }
+
+    /* filled - group the passable neighbors by whether they touch each other */
+    reach->labels[idx] = 0;
+    for (i = 0; i < 8; ++i) {
+        unsigned int nx = x + rl_reachability_ring_x[i], ny = y + rl_reachability_ring_y[i];
+        group[i] = -1;
+        if (!rl_map_in_bounds(map, nx, ny) || reach->labels[nx + ny*map.width] == 0) continue;
+        group[i] = i;
+        groups++;
+        for (j = 0; j < i; ++j) {
+            int dx = rl_reachability_ring_x[i] - rl_reachability_ring_x[j];
+            int dy = rl_reachability_ring_y[i] - rl_reachability_ring_y[j];
+            if (group[j] >= 0 && group[j] != group[i] && dx >= -1 && dx <= 1 && dy >= -1 && dy <= 1) {
+                int from = group[i], k;
+                for (k = 0; k <= i; ++k) {
+                    if (group[k] == from) group[k] = group[j];
+                }
+                groups--;
+            }
+        }
+    }
+    if (groups <= 1) return RL_OK;
+
+    /* the area might split - relabel from each group (a flood reaching the other groups relabels them too) */
+    RL_TRACE_BEGIN("rl_reachability_update");
+    {
+        unsigned int relabeled = reach->labels_len;
+        for (i = 0; i < 8; ++i) {
+            size_t n;
+            if (group[i] < 0) continue;
+            n = (x + rl_reachability_ring_x[i]) + (y + rl_reachability_ring_y[i])*map.width;
+            if (reach->labels[n] >= relabeled) continue;
+            rl_reachability_flood(reach, n);
+        }
+    }
+    RL_TRACE_END("rl_reachability_update");
+
+    return RL_OK;
+}
+
+unsigned int rl_reachability_component(RL_Reachability *reach, unsigned int x, unsigned int y)
+{
+    unsigned int label;
+    RL_ASSERT(reach != NULL);
+    if (reach == NULL || !rl_map_in_bounds(reach->map, x, y)) return 0;
+    label = reach->labels[x + y*reach->map.width];
+
+    return label ? rl_reachability_find(reach, label) : 0;
+}
+
+bool rl_reachability_connected(RL_Reachability *reach, unsigned int ax, unsigned int ay, unsigned int bx, unsigned int by)
+{
+    unsigned int a = rl_reachability_component(reach, ax, ay);
+
+    return a != 0 && a == rl_reachability_component(reach, bx, by);
+}
+
+/* index of the tile in the padded buffers */
+#define RL_DIFFUSION_INDEX(diffusion, x, y) (((size_t) (x) + 1) + ((size_t) (y) + 1) * (diffusion)->stride)
+
+RL_Diffusion *rl_diffusion_create(const RL_Map map)
+{
+    return rl_diffusion_create_ex(map, NULL);
+}
+
+RL_Diffusion *rl_diffusion_create_ex(const RL_Map map, const RL_Allocator *allocator)
+{
+    RL_Diffusion *diffusion;
+    float *memory;
+    size_t length;
+    unsigned int x, y;
+    RL_ASSERT(map.tiles != NULL);
+    if (map.tiles == NULL) return NULL;
+    diffusion = (RL_Diffusion*) rl_calloc(allocator, 1, sizeof(*diffusion));
+    RL_ASSERT(diffusion);
+    if (diffusion == NULL) return NULL;
+    diffusion->allocator = allocator;
+    diffusion->width = map.width;
+    diffusion->height = map.height;
+    diffusion->stride = (size_t) map.width + 2;
+    length = diffusion->stride * ((size_t) map.height + 2);
+    /* allocate all the memory we need at once */
+    memory = (float*) rl_calloc(allocator, length * 5, sizeof(*memory));
+    RL_ASSERT(memory);
+    if (memory == NULL) {
+        rl_free(allocator, diffusion);
+        return NULL;
+    }
+    diffusion->values = memory;
+    diffusion->back = memory + length;
+    diffusion->mask = memory + length * 2;
+    diffusion->open4 = memory + length * 3;
+    diffusion->open8 = memory + length * 4;
+    for (y = 0; y < map.height; ++y) {
+        for (x = 0; x < map.width; ++x) {
+            if (RL_PASSABLE_F(map, x, y)) rl_diffusion_set_passable(diffusion, x, y, true);
+        }
+    }
+
+    return diffusion;
+}
+
+void rl_diffusion_destroy(RL_Diffusion *diffusion)
+{
+    if (diffusion == NULL) return;
+    /* values & back are swapped each step - free the start of the allocation */
+    rl_free(diffusion->allocator, diffusion->values < diffusion->back ? diffusion->values : diffusion->back);
+    rl_free(diffusion->allocator, diffusion);
+}
+
+void rl_diffusion_set_passable(RL_Diffusion *diffusion, unsigned int x, unsigned int y, bool passable)
+{
+    size_t idx;
+    float delta;
+    int dx, dy;
+    RL_ASSERT(diffusion != NULL);
+    if (diffusion == NULL || x >= diffusion->width || y >= diffusion->height) return;
+    idx = RL_DIFFUSION_INDEX(diffusion, x, y);
+    delta = (passable ? 1.0f : 0.0f) - diffusion->mask[idx];
+    if (delta == 0) return;
+    diffusion->mask[idx] = passable ? 1.0f : 0.0f;
+    diffusion->values[idx] = 0;
+    diffusion->back[idx] = 0;
+    for (dy = -1; dy <= 1; ++dy) {
+        for (dx = -1; dx <= 1; ++dx) {
+            size_t n = (size_t) ((long) idx + dx + dy * (long) diffusion->stride);
+            if (dx == 0 && dy == 0) continue;
+            diffusion->open8[n] += delta;
+            if (dx == 0 || dy == 0) diffusion->open4[n] += delta;
+        }
+    }
+}
+
+void rl_diffusion_add(RL_Diffusion *diffusion, unsigned int x, unsigned int y, float amount)
+{
+    size_t idx;
+    RL_ASSERT(diffusion != NULL);
+    if (diffusion == NULL || x >= diffusion->width || y >= diffusion->height) return;
+    idx = RL_DIFFUSION_INDEX(diffusion, x, y);
+    diffusion->values[idx] += diffusion->mask[idx] * amount;
+}
+
+void rl_diffusion_clear(RL_Diffusion *diffusion)
+{
+    RL_ASSERT(diffusion != NULL);
+    if (diffusion == NULL) return;
+    memset(diffusion->values, 0, sizeof(*diffusion->values) * diffusion->stride * (diffusion->height + 2));
+}
+
+RL_Status rl_diffusion_step(RL_Diffusion *diffusion, float rate, float decay, bool diagonal, const RL_Rect *bounds)
+{
+    size_t stride, x, y, min_x = 1, min_y = 1, max_x, max_y;
+    float k;
+    RL_ASSERT(diffusion != NULL);
+    if (diffusion == NULL) return RL_ErrorNullParameter;
+    RL_ASSERT(rate >= 0 && rate <= 1);
+    if (rate < 0 || rate > 1) return RL_ErrorInvalidParameter;
+    stride = diffusion->stride;
+    max_x = diffusion->width;
+    max_y = diffusion->height;
+    if (bounds) {
+        if (bounds->x >= diffusion->width || bounds->y >= diffusion->height || bounds->width == 0 || bounds->height == 0) return RL_OK;
+        min_x = bounds->x + 1;
+        min_y = bounds->y + 1;
+        if (bounds->x + bounds->width < diffusion->width) max_x = bounds->x + bounds->width;
+        if (bounds->y + bounds->height < diffusion->height) max_y = bounds->y + bounds->height;
+    }
+    k = rate / (diagonal ? 8 : 4);
+    RL_TRACE_BEGIN("rl_diffusion_step");
+    for (y = min_y; y <= max_y; ++y) {
+        const float *c = diffusion->values + y * stride;
+        const float *n = c - stride;
+        const float *s = c + stride;
+        const float *m = diffusion->mask + y * stride;
+        float *out = diffusion->back + y * stride;
+        /* the inner loops have no branches so they can be vectorized */
+        if (diagonal) {
+            const float *open = diffusion->open8 + y * stride;
+            for (x = min_x; x <= max_x; ++x) {
+                float sum = n[x - 1] + n[x] + n[x + 1] + c[x - 1] + c[x + 1] + s[x - 1] + s[x] + s[x + 1];
+                out[x] = m[x] * decay * (c[x] + k * (sum - open[x] * c[x]));
+            }
+        } else {
+            const float *open = diffusion->open4 + y * stride;
+            for (x = min_x; x <= max_x; ++x) {
+                float sum = n[x] + c[x - 1] + c[x + 1] + s[x];
+                out[x] = m[x] * decay * (c[x] + k * (sum - open[x] * c[x]));
+            }
+        }
+    }
+    if (bounds) {
+        /* copy the updated region back, the rest of the field is unchanged */
+        for (y = min_y; y <= max_y; ++y) {
+            memcpy(diffusion->values + y * stride + min_x, diffusion->back + y * stride + min_x, sizeof(float) * (max_x - min_x + 1));
+        }
+    } else {
+        float *values = diffusion->values;
+        diffusion->values = diffusion->back;
+        diffusion->back = values;
+    }
+    RL_TRACE_END("rl_diffusion_step");
+
+    return RL_OK;
+}
+
+float rl_diffusion_value(const RL_Diffusion *diffusion, unsigned int x, unsigned int y)
+{
+    RL_ASSERT(diffusion != NULL);
+    if (diffusion == NULL || x >= diffusion->width || y >= diffusion->height) return 0;
+
+    return diffusion->values[RL_DIFFUSION_INDEX(diffusion, x, y)];
+}
+
+
+#if RL_ENABLE_PATHFINDING
+/* simplified distance for side by side nodes */
+static float rl_distance_simple(RL_Point node, RL_Point end)
+{
+    if (node.x == end.x && node.y == end.y) return 0;
+    if (node.x == end.x || node.y == end.y) return 1;
+    return 1.4;
+}
+
+static RL_Path *rl_path_ex(RL_Point p, const RL_Allocator *allocator)
+{
+    RL_Path *path = (RL_Path*) rl_malloc(allocator, sizeof(*path));
+    RL_ASSERT(path);
+    if (path == NULL) return NULL;
+    path->next = NULL;
+    path->point = p;
+    path->allocator = allocator;
+
+    return path;
+}
+
+RL_Path *rl_path(RL_Point p)
+{
+    return rl_path_ex(p, NULL);
+}
+
+float rl_distance_manhattan(RL_Point node, RL_Point end)
+{
+    return fabs(node.x - end.x) + fabs(node.y - end.y);
+}
+
+float rl_distance_manhattan_3d(RL_Point3d node, RL_Point3d end)
+{
+    return fabs(node.x - end.x) + fabs(node.y - end.y) + fabs(node.z - end.z);
+}
+
+float rl_distance_manhattan_axial(RL_Point node, RL_Point end)
+{
+    float s1 = -1 * (node.x + node.y);
+    float s2 = -1 * (end.x  + end.y);
+
+    return 0.5 * rl_distance_manhattan_3d((RL_Point3d) {node.x, node.y, s1},
+                                          (RL_Point3d) {end.x,  end.y,  s2});
+}
+
+float rl_distance_euclidian(RL_Point node, RL_Point end)
+{
+    float distance_x = node.x - end.x;
+    float distance_y = node.y - end.y;
+
+    return sqrt(distance_x * distance_x + distance_y * distance_y);
+}
+
+float rl_distance_chebyshev(RL_Point node, RL_Point end)
+{
+    float distance_x = fabs(node.x - end.x);
+    float distance_y = fabs(node.y - end.y);
+
+    return distance_x > distance_y ? distance_x : distance_y;
+}
+
+float rl_graph_score_manhattan(void *context, const RL_GraphNode *current, const RL_GraphNode *neighbor)
+{
+    RL_UNUSED(context);
+
+    return current->score + rl_distance_manhattan(current->point, neighbor->point);
+}
+
+float rl_graph_score_manhattan_axial(void *context, const RL_GraphNode *current, const RL_GraphNode *neighbor)
+{
+    RL_UNUSED(context);
+
+    return current->score + rl_distance_manhattan_axial(current->point, neighbor->point);
+}
+
+float rl_graph_score_euclidian(void *context, const RL_GraphNode *current, const RL_GraphNode *neighbor)
+{
+    RL_UNUSED(context);
+
+    return current->score + rl_distance_euclidian(current->point, neighbor->point);
+}
+
+float rl_graph_score_chebyshev(void *context, const RL_GraphNode *current, const RL_GraphNode *neighbor)
+{
+    RL_UNUSED(context);
+
+    return current->score + rl_distance_chebyshev(current->point, neighbor->point);
+}
+
+float rl_graph_score_simple(void *context, const RL_GraphNode *current, const RL_GraphNode *neighbor)
+{
+    RL_UNUSED(context);
+
+    return current->score + rl_distance_simple(current->point, neighbor->point);
+}
+
+
+RL_Graph rl_graph_floodfill_largest_area(const RL_Map map)
+{
+    RL_Graph floodfill = {0};
+    RL_ASSERT(map.tiles);
+    if (map.tiles == NULL) return floodfill;
+    int *visited = (int*) rl_calloc(NULL, map.width * map.height, sizeof(*visited));
+    RL_ASSERT(visited);
+    if (visited == NULL) return floodfill;
+    int floodfill_scored = 0;
+    for (unsigned int x = 0; x < map.width; ++x) {
+        for (unsigned int y = 0; y < map.height; ++y) {
+            if (RL_PASSABLE_F(map, x, y) && !visited[x + y*map.width]) {
+                RL_Graph test = rl_graph_create_scored(map, rl_point(x, y), NULL, NULL);
+                RL_ASSERT(test.nodes != NULL);
+                if (test.nodes == NULL) {
+                    rl_free(NULL, visited);
+                    // memory error
+                    return floodfill;
+                }
+                int test_scored = 0;
+                for (size_t i = 0; i < test.length; i++) {
+                    if (test.nodes[i].score != FLT_MAX) {
+                        visited[i] = 1;
+                        test_scored ++;
+                    }
+                }
+                if (test_scored > floodfill_scored) {
+                    floodfill_scored = test_scored;
+                    if (floodfill.nodes != NULL) {
+                        rl_graph_destroy(floodfill);
+                    }
+                    floodfill = test;
+                } else {
+                    rl_graph_destroy(test);
+                }
+            }
+        }
+    }
+
+    rl_free(NULL, visited);
+
+    return floodfill;
+}
+
+RL_Point rl_point(unsigned int x, unsigned int y)
+{
+    return (RL_Point) { .x = (float) x, .y = (float) y };
+}
+
+// TODO better bounds checking
+RL_Point rl_point_axial(unsigned int x, unsigned int y)
+{
+    RL_Point point;
+
+    RL_ASSERT(x < INT_MAX && y < INT_MAX);
+
+    int x_ = x;
+    int y_ = y;
+#if RL_HEX_FLAT_TOP == 1
+    int val = x_ & 1;
+#if RL_HEX_ODD_OFFSET == 1
+    int shift = (x_ - val) / 2;
+#else
+    int shift = (x_ + val) / 2;
+#endif
+    point.x = x_;
+    point.y = y_ - shift;
+#else // RL_HEX_FLAT_TOP
+    int val = y_ & 1;
+#if RL_HEX_ODD_OFFSET == 1
+    int shift = (y_ - val) / 2;
+#else
+    int shift = (y_ + val) / 2;
+#endif
+    point.x = x_ - shift;
+    point.y = y_;
+#endif // RL_HEX_FLAT_TOP
+
+    return point;
+}
+
+RL_Point rl_axial_to_offset(RL_Point axial)
+{
+    RL_Point offset;
+
+#if RL_HEX_FLAT_TOP == 1
+    // Flat-topped hex layouts (columns are shifted)
+#if RL_HEX_ODD_OFFSET == 1
+    offset.x = axial.x;
+    offset.y = axial.y + (axial.x - ((int)axial.x & 1)) / 2;
+#else
+    offset.x = axial.x;
+    offset.y = axial.y + (axial.x + ((int)axial.x & 1)) / 2;
+#endif
+#else // RL_HEX_FLAT_TOP
+#if RL_HEX_ODD_OFFSET == 1
+    offset.x = axial.x + (axial.y - ((int)axial.y & 1)) / 2;
+    offset.y = axial.y;
+#else
+    offset.x = axial.x + (axial.y + ((int)axial.y & 1)) / 2;
+    offset.y = axial.y;
+#endif
+#endif // RL_HEX_FLAT_TOP
+
+    return offset;
+}
+
+unsigned int rl_axial_to_map_x(RL_Point axial)
+{
+    return rl_axial_to_offset(axial).x;
+}
+
+unsigned int rl_axial_to_map_y(RL_Point axial)
+{
+    return rl_axial_to_offset(axial).y;
+}
+
+RL_Path *rl_line_create(RL_Point a, RL_Point b, float step)
+{
+    return rl_line_create_ex(a, b, step, NULL);
+}
+
+RL_Path *rl_line_create_ex(RL_Point a, RL_Point b, float step, const RL_Allocator *allocator)
+{
+    float delta_x = fabs(a.x - b.x);
+    float x_increment = b.x > a.x ? step : -step;
+    float delta_y = fabs(a.y - b.y);
+    float y_increment = b.y > a.y ? step : -step;
+    float error = 0.0;
+    float slope = delta_x ? delta_y / delta_x : 0.0;
+
+    RL_Path *head = rl_path_ex(a, allocator);
+    if (head == NULL) return NULL;
+    RL_Path *path = head;
+    while (path->point.x != b.x || path->point.y != b.y) {
+        RL_Point point = path->point;
+
+        if (delta_x > delta_y) {
+            error += slope;
+            if (error > 0.5 && point.y != b.y) {
+                error -= 1.0;
+                point.y += y_increment;
+            }
+
+            point.x += x_increment;
+        } else {
+            error += 1/slope;
+            if (error > 0.5 && point.x != b.x) {
+                error -= 1.0;
+                point.x += x_increment;
+            }
+
+            point.y += y_increment;
+        }
+
+        /* add new member to linked list & advance */
+        path->next = rl_path_ex(point, allocator);
+        if (path->next == NULL) {
+            rl_path_destroy(head);
+            return NULL;
+        }
+        path = path->next;
+    }
+
+    return head;
+}
+
+RL_Path *rl_path_create(const RL_Map map, RL_Point start, RL_Point end, RL_ScoreFun score_f, RL_NeighborsFun neighbors_f)
+{
+    return rl_path_create_ex(map, start, end, score_f, neighbors_f, NULL);
+}
+
+RL_Path *rl_path_create_ex(const RL_Map map, RL_Point start, RL_Point end, RL_ScoreFun score_f, RL_NeighborsFun neighbors_f, const RL_Allocator *allocator)
+{
+    RL_Graph graph = rl_graph_create_ex(map.width, map.height, neighbors_f, allocator);
+    RL_ASSERT(graph.nodes);
+    if (graph.nodes == NULL) return NULL;
+    RL_TRACE_BEGIN("rl_path_create");
+    rl_graph_score(graph, map, end, score_f);
+    RL_Path *path = rl_path_create_from_graph(graph, map, start);
+    RL_TRACE_END("rl_path_create");
+    RL_ASSERT(path);
+    rl_graph_destroy(graph);
+
+    return path;
+}
+
+RL_Path *rl_path_create_from_graph(const RL_Graph graph, const RL_Map map, RL_Point start)
+{
+    RL_Path *path = rl_path_ex(start, graph.allocator);
+    RL_Path *path_start = path;
+    RL_GraphNode *node = NULL;
+    RL_ASSERT(path != NULL);
+    RL_ASSERT(graph.nodes != NULL);
+    if (path == NULL || graph.nodes == NULL) return NULL;
+    for (size_t i=0; i<graph.length; i++) {
+        if (graph.nodes[i].point.x == start.x && graph.nodes[i].point.y == start.y) {
+            node = &graph.nodes[i];
+        }
+    }
+    if (node == NULL) {
+        return path;
+    }
+    while (node != NULL && node->score > 0) {
+        node = rl_graph_node_lowest_neighbor(graph, map, node);
+        if (node == NULL) break;
+        path->next = rl_path_ex(node->point, graph.allocator);
+        RL_ASSERT(path->next);
+        if (path->next == NULL) {
+            rl_path_destroy(path_start);
+            return NULL;
+        }
+        path = path->next;
+    }
+
+    return path_start;
+}
+
+RL_Path *rl_path_walk(RL_Path *path)
 {
-    void *r;
-    if (h == NULL) {
-        return NULL;
-    }
+    if (!path) return NULL;
+    RL_Path *next = path->next;
+    path->next = NULL;
+    rl_free(path->allocator, path);
 
-    r = NULL;
-    if (h->len) {
-        RL_ASSERT(h->heap);
-        r = h->heap[0];
-        rl_heap_remove(h, 0);
-    }
-    return r;
+    return next;
 }
 
-void *rl_heap_peek(RL_Heap *h)
+void rl_path_destroy(RL_Path *path)
 {
-    if (h == NULL) {
-        return NULL;
+    if (path) {
+        while ((path = rl_path_walk(path))) {}
     }
+}
 
-    RL_ASSERT(h->heap);
-    if (h->len) {
-        return h->heap[0];
-    } else {
-        return NULL;
+/* entry in the open set of RL_PathSearch - nodes can be in the open set more than once, stale entries (with a higher
+ * score than the node) are skipped when popped */
+typedef struct {
+    float priority; /* score + heuristic */
+    float score;
+    size_t index;
+} RL_PathSearchEntry;
+
+static int rl_path_search_heap_comparison(const void *heap_item_a, const void *heap_item_b)
+{
+    const RL_PathSearchEntry *a = (const RL_PathSearchEntry*) heap_item_a;
+    const RL_PathSearchEntry *b = (const RL_PathSearchEntry*) heap_item_b;
+
+    /* prefer deeper nodes on ties, they are likely closer to the end */
+    return a->priority < b->priority || (a->priority == b->priority && a->score > b->score);
+}
+
+static bool rl_path_search_push(RL_PathSearch *search, size_t index, float score)
+{
+    RL_PathSearchEntry *entry = (RL_PathSearchEntry*) rl_malloc(&search->pool_allocator, sizeof(*entry));
+    RL_ASSERT(entry != NULL);
+    if (entry == NULL) return false;
+    entry->priority = score + search->heuristic_f(search->graph.nodes[index].point, search->end);
+    entry->score = score;
+    entry->index = index;
+    if (!rl_heap_insert(search->open, entry)) {
+        rl_free(&search->pool_allocator, entry);
+        search->open = NULL; /* the heap is freed when it fails to grow */
+        return false;
     }
+
+    return true;
 }
 
-RL_Status rl_rng_map_point_matching(RL_Map map, void *context, bool (*f)(const RL_Map map, void *context, unsigned int x, unsigned int y), unsigned int *dx, unsigned int *dy)
+RL_PathSearch *rl_path_search_create(const RL_Map map, RL_Point start, RL_Point end, RL_ScoreFun score_f, RL_NeighborsFun neighbors_f, RL_DistanceFun heuristic_f)
 {
-    unsigned int count, x, y;
+    return rl_path_search_create_ex(map, start, end, score_f, neighbors_f, heuristic_f, NULL);
+}
 
+RL_PathSearch *rl_path_search_create_ex(const RL_Map map, RL_Point start, RL_Point end, RL_ScoreFun score_f, RL_NeighborsFun neighbors_f, RL_DistanceFun heuristic_f, const RL_Allocator *allocator)
+{
+    RL_PathSearch *search;
     RL_ASSERT(map.tiles != NULL);
-    if (map.tiles == NULL) {
-        return RL_ErrorNullParameter;
+    if (map.tiles == NULL) return NULL;
+    if (!rl_map_in_bounds(map, start.x, start.y) || !rl_map_in_bounds(map, end.x, end.y)) return NULL;
+    search = (RL_PathSearch*) rl_calloc(allocator, 1, sizeof(*search));
+    RL_ASSERT(search != NULL);
+    if (search == NULL) return NULL;
+
+    search->allocator = allocator;
+    search->map = map;
+    search->end = end;
+    search->score_f = score_f ? score_f : rl_graph_score_simple;
+    search->heuristic_f = heuristic_f ? heuristic_f : rl_distance_chebyshev;
+    search->graph = rl_graph_create_ex(map.width, map.height, neighbors_f, allocator);
+    search->parents = (size_t*) rl_malloc(allocator, sizeof(*search->parents) * map.width * map.height);
+    search->open = rl_heap_create_ex(RL_MAX_NEIGHBOR_COUNT * 4, rl_path_search_heap_comparison, allocator);
+    search->pool = rl_pool_create_ex(sizeof(RL_PathSearchEntry), 256, allocator);
+    search->pool_allocator = rl_pool_allocator(&search->pool);
+    search->start_index = (size_t) start.x + (size_t) start.y * map.width;
+    search->end_index = (size_t) end.x + (size_t) end.y * map.width;
+    search->best_index = search->start_index;
+    search->best_heuristic = FLT_MAX;
+    if (search->graph.nodes == NULL || search->parents == NULL || search->open == NULL) {
+        rl_path_search_destroy(search);
+        return NULL;
     }
-    RL_ASSERT(dx != NULL && dy != NULL);
-    if (dx == NULL || dy == NULL) {
-        return RL_ErrorNullParameter;
+
+    search->graph.nodes[search->start_index].score = 0;
+    search->parents[search->start_index] = search->start_index;
+    if (!rl_path_search_push(search, search->start_index, 0)) {
+        rl_path_search_destroy(search);
+        return NULL;
     }
 
-    /* simple reservoir sampling algorithm (k == 1) */
-    count = 0;
-    for (x=0; x<map.width; x++) {
-        for (y=0; y<map.height; y++) {
-            if (f == NULL || f(map, context, x, y)) {
-                count++;
-                if (RL_RNG_F(0, count - 1) == 0) {
-                    *dx = x;
-                    *dy = y;
+    return search;
+}
+
+bool rl_path_search_step(RL_PathSearch *search, size_t max_expansions)
+{
+    RL_GraphContext context;
+    size_t expansions = 0;
+    RL_ASSERT(search != NULL);
+    if (search == NULL) return true;
+    context = rl_graph_context(search->graph, search->map);
+    while (!search->finished && expansions < max_expansions && search->open != NULL) {
+        RL_PathSearchEntry *entry = (RL_PathSearchEntry*) rl_heap_pop(search->open);
+        if (entry == NULL) {
+            search->finished = true; /* open set exhausted - end is unreachable */
+            break;
+        }
+        size_t index = entry->index;
+        float score = entry->score;
+        rl_free(&search->pool_allocator, entry);
+        RL_GraphNode *current = &search->graph.nodes[index];
+        if (score > current->score) continue; /* stale entry */
+
+        expansions++;
+        search->expansions++;
+        RL_STATS_ADD(dijkstra_expansions, 1);
+        float heuristic = search->heuristic_f(current->point, search->end);
+        if (heuristic < search->best_heuristic) {
+            search->best_heuristic = heuristic;
+            search->best_index = index;
+        }
+        if (index == search->end_index) {
+            search->best_index = index;
+            search->finished = search->found = true;
+            break;
+        }
+
+        RL_GraphNode *neighbors[RL_MAX_NEIGHBOR_COUNT];
+        size_t neighbors_count = search->graph.neighbors(&context, current->point, neighbors);
+        for (size_t i=0; i<neighbors_count; i++) {
+            RL_GraphNode *neighbor = neighbors[i];
+            float distance = search->score_f(&context, current, neighbor);
+            if (distance < neighbor->score) {
+                size_t neighbor_index = neighbor - search->graph.nodes;
+                neighbor->score = distance;
+                search->parents[neighbor_index] = index;
+                if (!rl_path_search_push(search, neighbor_index, distance)) {
+                    search->finished = true; /* out of memory */
+                    break;
                 }
             }
         }
     }
 
-    return count > 0 ? RL_OK : RL_ErrorNotFound;
+    return search->finished;
 }
 
-bool rl_rng_map_is_tile(RL_Map map, void *context, unsigned int x, unsigned int y)
+RL_Path *rl_path_search_path(const RL_PathSearch *search)
 {
-    RL_Byte *t = (RL_Byte*) context;
-    RL_ASSERT(t != NULL);
-    return map.tiles[x+y*map.width] == *t;
+    RL_Path *path = NULL;
+    size_t index;
+    RL_ASSERT(search != NULL);
+    if (search == NULL) return NULL;
+    /* build the path backwards from the best node */
+    for (index = search->best_index; ; index = search->parents[index]) {
+        RL_Path *prev = rl_path_ex(search->graph.nodes[index].point, search->allocator);
+        RL_ASSERT(prev != NULL);
+        if (prev == NULL) {
+            rl_path_destroy(path);
+            return NULL;
+        }
+        prev->next = path;
+        path = prev;
+        if (index == search->start_index) break;
+    }
+
+    return path;
 }
-RL_Status rl_rng_map_point(RL_Map map, RL_Byte t, unsigned int *dx, unsigned int *dy)
+
+void rl_path_search_destroy(RL_PathSearch *search)
 {
-    return rl_rng_map_point_matching(map, &t, rl_rng_map_is_tile, dx, dy);
+    if (search == NULL) return;
+    if (search->open) {
+        rl_heap_destroy(search->open); /* entries are freed with the pool */
+    }
+    rl_pool_destroy(search->pool);
+    rl_graph_destroy(search->graph);
+    if (search->parents) {
+        rl_free(search->allocator, search->parents);
+    }
+    rl_free(search->allocator, search);
 }
 
-bool rl_rng_map_is_passable(RL_Map map, void *context, unsigned int x, unsigned int y)
+static size_t rl_coop_hash(size_t key)
 {
-    RL_UNUSED(context);
-    return RL_PASSABLE_F(map, x, y);
+    key ^= key >> 16;
+    key *= (size_t) 0x45d9f3bU;
+    key ^= key >> 16;
+
+    return key;
 }
-RL_Status rl_rng_map_passable(RL_Map map, unsigned int *x, unsigned int *y)
+
+static size_t rl_coop_key(const RL_Coop *coop, unsigned int x, unsigned int y, unsigned int t)
 {
-    return rl_rng_map_point_matching(map, NULL, rl_rng_map_is_passable, x, y);
+    return ((size_t) x + (size_t) y * coop->map.width) * (coop->window + 1) + t;
 }
 
-RL_Status rl_rng_map_room(RL_Map map, RL_BSP *bsp, unsigned int *x, unsigned int *y)
+/* returns the slot matching key, or the empty slot it would be inserted in (tables are at most half full) */
+static RL_CoopSlot *rl_coop_slot(RL_CoopSlot *table, size_t cap, unsigned int generation, size_t key)
 {
-    return rl_rng_map_room_matching(map, bsp, NULL, NULL, x, y);
+    size_t i = rl_coop_hash(key) & (cap - 1);
+    while (table[i].generation == generation && table[i].key != key) {
+        i = (i + 1) & (cap - 1);
+    }
+
+    return &table[i];
 }
 
-RL_Status rl_rng_map_room_matching(RL_Map map, RL_BSP *bsp, void *context, bool (*f)(const RL_Map map, void *context, unsigned int x, unsigned int y), unsigned int *dx, unsigned int *dy)
+/* invalidates every slot of a table in O(1) */
+static void rl_coop_clear(RL_CoopSlot *table, size_t cap, unsigned int *generation)
 {
-    unsigned int i, x, y;
-    size_t leaf_count, match_count;
-    RL_BSP *leaf;
+    if (++*generation == 0) {
+        memset(table, 0, sizeof(*table) * cap);
+        *generation = 1;
+    }
+}
 
-    RL_ASSERT(bsp != NULL && map.tiles != NULL && dx != NULL && dy != NULL);
-    if (bsp == NULL || map.tiles == NULL || dx == NULL || dy == NULL) return RL_ErrorNullParameter;
+/* agent reserving the tile at time t, or agent_count if none */
+static size_t rl_coop_reserved_by(const RL_Coop *coop, unsigned int x, unsigned int y, unsigned int t)
+{
+    RL_CoopSlot *slot = rl_coop_slot(coop->reservations, coop->reservations_cap, coop->reservations_generation, rl_coop_key(coop, x, y, t));
+    return slot->generation == coop->reservations_generation ? slot->value : coop->agent_count;
+}
 
-    leaf_count = rl_bsp_leaf_count(bsp);
-    RL_ASSERT(leaf_count > 0);
+/* returns the array grown to fit needed items (or NULL if out of memory, leaving the array as is) */
+static void *rl_grow_array(const RL_Allocator *allocator, void *array, size_t *cap, size_t item_size, size_t needed)
+{
+    size_t new_cap = *cap ? *cap : 64;
+    void *memory;
+    if (needed <= *cap) return array;
+    while (new_cap < needed) new_cap *= 2;
+    memory = rl_realloc(allocator, array, item_size * *cap, item_size * new_cap);
+    RL_ASSERT(memory);
+    if (memory == NULL) return NULL;
+    *cap = new_cap;
 
-    /* find the first leaf */
-    leaf = bsp;
-    while (leaf->left != NULL) leaf = leaf->left;
+    return memory;
+}
 
-    /* generate random room matching given function */
-    match_count = 0;
-    for (i=0; i<leaf_count; i++, leaf = rl_bsp_next_leaf(leaf)) {
-        RL_ASSERT(leaf != NULL && rl_bsp_is_leaf(leaf));
-        if (!rl_bsp_find_room(map, leaf, &x, &y)) {
-            continue;
+/* doubles the visited table, re-inserting the nodes */
+static bool rl_coop_grow_visited(RL_Coop *coop)
+{
+    size_t cap = coop->visited_cap * 2;
+    RL_CoopSlot *visited = (RL_CoopSlot*) rl_calloc(coop->allocator, cap, sizeof(*visited));
+    RL_ASSERT(visited);
+    if (visited == NULL) return false;
+    rl_free(coop->allocator, coop->visited);
+    coop->visited = visited;
+    coop->visited_cap = cap;
+    coop->visited_generation = 1;
+    for (size_t i = 0; i < coop->nodes_len; ++i) {
+        const RL_CoopNode *node = &coop->nodes[i];
+        RL_CoopSlot *slot = rl_coop_slot(visited, cap, 1, rl_coop_key(coop, node->x, node->y, node->t));
+        slot->key = rl_coop_key(coop, node->x, node->y, node->t);
+        slot->value = i;
+        slot->generation = 1;
+    }
+
+    return true;
+}
+
+/* push onto a binary min heap of scored indexes, growing it as needed */
+static bool rl_scored_heap_push(const RL_Allocator *allocator, RL_ScoredIndex **heap, size_t *len, size_t *cap, float score, size_t index)
+{
+    size_t i;
+    RL_ScoredIndex *items = (RL_ScoredIndex*) rl_grow_array(allocator, *heap, cap, sizeof(*items), *len + 1);
+    if (items == NULL) return false;
+    *heap = items;
+    i = (*len)++;
+    while (i) {
+        size_t p = (i - 1) / 2;
+        if (items[p].score <= score) break;
+        items[i] = items[p];
+        i = p;
+    }
+    items[i].score = score;
+    items[i].index = index;
+    RL_STATS_ADD(heap_pushes, 1);
+
+    return true;
+}
+
+static RL_ScoredIndex rl_scored_heap_pop(RL_ScoredIndex *heap, size_t *len)
+{
+    RL_ScoredIndex top = heap[0];
+    RL_ScoredIndex last = heap[--*len];
+    size_t i = 0;
+    for (;;) {
+        size_t c = 2*i + 1;
+        if (c >= *len) break;
+        if (c + 1 < *len && heap[c + 1].score < heap[c].score) c++;
+        if (last.score <= heap[c].score) break;
+        heap[i] = heap[c];
+        i = c;
+    }
+    if (*len) heap[i] = last;
+    RL_STATS_ADD(heap_pops, 1);
+
+    return top;
+}
+
+/* Multi-source Dijkstra shared by the influence maps, room table, placement & autoexplore. The distances are kept in the
+ * node scores of the graph & expanded with its neighbors function. The open set is an RL_ScoredIndex heap rather than an
+ * RL_Heap: entries are stored by value, so a tile whose distance drops is pushed again & its stale entry skipped when
+ * popped, whereas RL_Heap holds pointers to nodes whose scores must not change while they are in the heap. */
+typedef struct {
+    RL_Graph graph;
+    void *context;            /* passed to the neighbors & score functions */
+    RL_ScoreFun score_f;
+    unsigned int *visited;    /* a node score is only set when this matches generation - NULL when every score is set */
+    unsigned int generation;
+    float max_distance;       /* tiles farther than this are not reached */
+    RL_ScoredIndex **open;
+    size_t *open_len;
+    size_t *open_cap;
+    const RL_Allocator *allocator;
+    bool (*settle_f)(void *user, size_t index, float distance); /* called in order of distance - return false to stop */
+    bool (*enter_f)(void *user, size_t from, size_t to);        /* called before lowering a distance - return false to skip the tile */
+    void *user;
+} RL_ScoredRelax;
+
+static bool rl_scored_relax_seed(const RL_ScoredRelax *relax, size_t index)
+{
+    relax->graph.nodes[index].score = 0;
+    if (relax->visited) relax->visited[index] = relax->generation;
+
+    return rl_scored_heap_push(relax->allocator, relax->open, relax->open_len, relax->open_cap, 0, index);
+}
+
+/* expands the seeded open set until it is empty or settle_f returns false */
+static RL_Status rl_scored_relax(const RL_ScoredRelax *relax)
+{
+    RL_GraphNode *neighbors[RL_MAX_NEIGHBOR_COUNT];
+    while (*relax->open_len) {
+        RL_ScoredIndex entry = rl_scored_heap_pop(*relax->open, relax->open_len);
+        RL_GraphNode *current = &relax->graph.nodes[entry.index];
+        size_t count, i;
+        if (entry.score > current->score) continue; /* stale entry */
+        if (relax->settle_f && !relax->settle_f(relax->user, entry.index, entry.score)) break;
+        count = relax->graph.neighbors(relax->context, current->point, neighbors);
+        RL_STATS_ADD(dijkstra_expansions, 1);
+        for (i = 0; i < count; ++i) {
+            RL_GraphNode *neighbor = neighbors[i];
+            size_t n = (size_t) (neighbor - relax->graph.nodes);
+            float distance = relax->score_f(relax->context, current, neighbor);
+            if (distance >= FLT_MAX || distance > relax->max_distance) continue;
+            if ((relax->visited == NULL || relax->visited[n] == relax->generation) && neighbor->score <= distance) continue;
+            if (relax->enter_f && !relax->enter_f(relax->user, entry.index, n)) continue;
+            if (relax->visited) relax->visited[n] = relax->generation;
+            neighbor->score = distance;
+            if (!rl_scored_heap_push(relax->allocator, relax->open, relax->open_len, relax->open_cap, distance, n)) return RL_ErrorMemory;
         }
-        if (f == NULL || f(map, context, x, y)) {
-            match_count++;
-            if (RL_RNG_F(0, match_count - 1) == 0) {
-                *dx = x;
-                *dy = y;
+    }
+
+    return RL_OK;
+}
+
+RL_Coop *rl_coop_create(const RL_Map map, size_t agent_count, unsigned int window, RL_NeighborsFun neighbors_f)
+{
+    return rl_coop_create_ex(map, agent_count, window, neighbors_f, NULL);
+}
+
+RL_Coop *rl_coop_create_ex(const RL_Map map, size_t agent_count, unsigned int window, RL_NeighborsFun neighbors_f, const RL_Allocator *allocator)
+{
+    RL_ASSERT(map.tiles != NULL && agent_count > 0 && window > 0);
+    if (map.tiles == NULL || agent_count == 0 || window == 0) return NULL;
+    RL_Coop *coop = (RL_Coop*) rl_calloc(allocator, 1, sizeof(*coop));
+    RL_ASSERT(coop);
+    if (coop == NULL) return NULL;
+    coop->allocator = allocator;
+    coop->map = map;
+    coop->neighbors_f = neighbors_f ? neighbors_f : rl_graph_neighbors_ordinal_passable;
+    coop->window = window;
+    coop->agent_count = agent_count;
+    coop->reservations_cap = 64;
+    while (coop->reservations_cap < agent_count * (window + 1) * 2) coop->reservations_cap *= 2;
+    coop->visited_cap = 1024;
+    coop->agents = (RL_CoopAgent*) rl_calloc(coop->allocator, agent_count, sizeof(*coop->agents));
+    coop->heuristics = (RL_CoopHeuristic*) rl_calloc(coop->allocator, agent_count, sizeof(*coop->heuristics));
+    coop->reservations = (RL_CoopSlot*) rl_calloc(coop->allocator, coop->reservations_cap, sizeof(*coop->reservations));
+    coop->visited = (RL_CoopSlot*) rl_calloc(coop->allocator, coop->visited_cap, sizeof(*coop->visited));
+    if (coop->agents == NULL || coop->heuristics == NULL || coop->reservations == NULL || coop->visited == NULL) {
+        rl_coop_destroy(coop);
+        return NULL;
+    }
+    for (size_t i = 0; i < agent_count; ++i) {
+        coop->agents[i].path = (RL_Point*) rl_malloc(coop->allocator, sizeof(*coop->agents[i].path) * (window + 1));
+        if (coop->agents[i].path == NULL) {
+            rl_coop_destroy(coop);
+            return NULL;
+        }
+    }
+
+    return coop;
+}
+
+void rl_coop_set_agent(RL_Coop *coop, size_t agent, RL_Point position, RL_Point goal)
+{
+    RL_ASSERT(coop != NULL && agent < coop->agent_count);
+    if (coop == NULL || agent >= coop->agent_count) return;
+    RL_ASSERT(rl_map_in_bounds(coop->map, position.x, position.y) && rl_map_in_bounds(coop->map, goal.x, goal.y));
+    coop->agents[agent].position = position;
+    coop->agents[agent].goal = goal;
+    coop->agents[agent].path[0] = position;
+    coop->agents[agent].path_length = 1;
+}
+
+/* can the agent move from a at time t to b at time t + 1 without running into (or swapping places with) an agent
+ * planned before it? */
+static bool rl_coop_can_move(const RL_Coop *coop, size_t agent, unsigned int ax, unsigned int ay, unsigned int bx, unsigned int by, unsigned int t)
+{
+    size_t other = rl_coop_reserved_by(coop, bx, by, t + 1);
+    if (other != coop->agent_count && other != agent) return false;
+    other = rl_coop_reserved_by(coop, bx, by, t);
+    if (other != coop->agent_count && other != agent && rl_coop_reserved_by(coop, ax, ay, t + 1) == other) return false;
+
+    return true;
+}
+
+/* can the agent stay at the goal from time t until the end of the window? */
+static bool rl_coop_can_stay(const RL_Coop *coop, size_t agent, unsigned int x, unsigned int y, unsigned int t)
+{
+    for (; t <= coop->window; ++t) {
+        size_t other = rl_coop_reserved_by(coop, x, y, t);
+        if (other != coop->agent_count && other != agent) return false;
+    }
+
+    return true;
+}
+
+/* finds the heuristic for the agent's goal, or restarts one that isn't used this turn */
+static RL_Status rl_coop_heuristic(RL_Coop *coop, RL_CoopAgent *agent)
+{
+    size_t i, reuse = coop->heuristics_len;
+    for (i = 0; i < coop->heuristics_len; ++i) {
+        RL_CoopHeuristic *h = &coop->heuristics[i];
+        if (h->goal.x == agent->goal.x && h->goal.y == agent->goal.y) {
+            h->turn = coop->turn;
+            agent->heuristic = i;
+            return RL_OK;
+        }
+        if (h->turn != coop->turn && reuse == coop->heuristics_len) reuse = i;
+    }
+    RL_ASSERT(reuse < coop->agent_count); /* at most one goal per agent is used each turn */
+    RL_CoopHeuristic *h = &coop->heuristics[reuse];
+    if (reuse == coop->heuristics_len) {
+        h->graph = rl_graph_create_ex(coop->map.width, coop->map.height, coop->neighbors_f, coop->allocator);
+        h->closed = (RL_Byte*) rl_malloc(coop->allocator, sizeof(*h->closed) * coop->map.width * coop->map.height);
+        if (h->graph.nodes == NULL || h->closed == NULL) return RL_ErrorMemory;
+        coop->heuristics_len++;
+    }
+    rl_graph_reset(h->graph);
+    memset(h->closed, 0, sizeof(*h->closed) * coop->map.width * coop->map.height);
+    h->goal = agent->goal;
+    h->origin = agent->position;
+    h->turn = coop->turn;
+    h->open_len = 0;
+    size_t goal = (size_t) agent->goal.x + (size_t) agent->goal.y * coop->map.width;
+    h->graph.nodes[goal].score = 0;
+    if (!rl_scored_heap_push(coop->allocator, &h->open, &h->open_len, &h->open_cap, rl_distance_chebyshev(agent->goal, h->origin), goal)) return RL_ErrorMemory;
+    agent->heuristic = reuse;
+
+    return RL_OK;
+}
+
+/* distance from the tile to the goal (FLT_MAX if unreachable), resuming the heuristic's search until the tile is
+ * closed - the chebyshev distance to origin is consistent, so the distance of a closed tile is exact */
+static float rl_coop_distance(RL_Coop *coop, RL_CoopHeuristic *h, size_t index, bool *out_of_memory)
+{
+    RL_GraphContext context = rl_graph_context(h->graph, coop->map);
+    while (!h->closed[index] && h->open_len) {
+        RL_ScoredIndex entry = rl_scored_heap_pop(h->open, &h->open_len);
+        RL_GraphNode *current = &h->graph.nodes[entry.index];
+        if (h->closed[entry.index]) continue; /* stale */
+        h->closed[entry.index] = 1;
+        RL_STATS_ADD(dijkstra_expansions, 1);
+        RL_GraphNode *neighbors[RL_MAX_NEIGHBOR_COUNT];
+        size_t neighbors_count = coop->neighbors_f(&context, current->point, neighbors);
+        for (size_t i = 0; i < neighbors_count; ++i) {
+            float distance = rl_graph_score_simple(&context, current, neighbors[i]);
+            if (distance >= neighbors[i]->score) continue;
+            neighbors[i]->score = distance;
+            if (!rl_scored_heap_push(coop->allocator, &h->open, &h->open_len, &h->open_cap, distance + rl_distance_chebyshev(neighbors[i]->point, h->origin), neighbors[i] - h->graph.nodes)) {
+                *out_of_memory = true;
+                return FLT_MAX;
             }
         }
     }
-    RL_ASSERT(match_count > 0);
 
-    if (match_count == 0) {
-        return RL_ErrorNotFound;
+    return h->closed[index] ? h->graph.nodes[index].score : FLT_MAX;
+}
+
+/* space-time A* for the agent against the current reservations */
+static RL_Status rl_coop_search(RL_Coop *coop, size_t agent_index)
+{
+    RL_CoopAgent *agent = &coop->agents[agent_index];
+    RL_Map map = coop->map;
+    RL_CoopHeuristic *heuristic = &coop->heuristics[agent->heuristic];
+    RL_GraphContext context = rl_graph_context(heuristic->graph, map);
+    unsigned int gx = agent->goal.x, gy = agent->goal.y;
+    size_t start = (size_t) agent->position.x + (size_t) agent->position.y * map.width;
+    bool out_of_memory = false;
+    float start_h = rl_coop_distance(coop, heuristic, start, &out_of_memory);
+
+    agent->path[0] = agent->position;
+    agent->path_length = 1;
+    if (out_of_memory) return RL_ErrorMemory;
+    if (start_h == FLT_MAX) return RL_OK; /* goal is unreachable - wait */
+
+    rl_coop_clear(coop->visited, coop->visited_cap, &coop->visited_generation);
+    coop->nodes_len = 0;
+    coop->open_len = 0;
+    RL_CoopNode *nodes = (RL_CoopNode*) rl_grow_array(coop->allocator, coop->nodes, &coop->nodes_cap, sizeof(*nodes), 1);
+    if (nodes == NULL) return RL_ErrorMemory;
+    coop->nodes = nodes;
+    coop->nodes[0] = (RL_CoopNode) { agent->position.x, agent->position.y, 0, 0, 0 };
+    coop->nodes_len = 1;
+    RL_CoopSlot *slot = rl_coop_slot(coop->visited, coop->visited_cap, coop->visited_generation, rl_coop_key(coop, agent->position.x, agent->position.y, 0));
+    *slot = (RL_CoopSlot) { rl_coop_key(coop, agent->position.x, agent->position.y, 0), 0, coop->visited_generation };
+    if (!rl_scored_heap_push(coop->allocator, &coop->open, &coop->open_len, &coop->open_cap, start_h, 0)) return RL_ErrorMemory;
+
+    while (coop->open_len) {
+        RL_ScoredIndex entry = rl_scored_heap_pop(coop->open, &coop->open_len);
+        RL_CoopNode current = coop->nodes[entry.index];
+        size_t current_index = (size_t) current.x + (size_t) current.y * map.width;
+        if (entry.score > current.score + heuristic->graph.nodes[current_index].score) continue; /* stale (closed when pushed) */
+        RL_STATS_ADD(dijkstra_expansions, 1);
+
+        if (current.t == coop->window || (current.x == gx && current.y == gy && rl_coop_can_stay(coop, agent_index, gx, gy, current.t))) {
+            size_t n = entry.index;
+            agent->path_length = current.t + 1;
+            for (;;) {
+                agent->path[coop->nodes[n].t] = rl_point(coop->nodes[n].x, coop->nodes[n].y);
+                if (coop->nodes[n].t == 0) break;
+                n = coop->nodes[n].parent;
+            }
+            return RL_OK;
+        }
+
+        /* neighbors, plus waiting in place */
+        RL_GraphNode *neighbors[RL_MAX_NEIGHBOR_COUNT + 1];
+        size_t neighbors_count = coop->neighbors_f(&context, rl_point(current.x, current.y), neighbors);
+        RL_ASSERT(neighbors_count <= RL_MAX_NEIGHBOR_COUNT);
+        neighbors[neighbors_count++] = &heuristic->graph.nodes[current_index];
+        for (size_t i = 0; i < neighbors_count; ++i) {
+            size_t index = neighbors[i] - heuristic->graph.nodes;
+            unsigned int x = index % map.width, y = index / map.width;
+            float h, score;
+            if (!rl_coop_can_move(coop, agent_index, current.x, current.y, x, y, current.t)) continue;
+            h = rl_coop_distance(coop, heuristic, index, &out_of_memory);
+            if (out_of_memory) return RL_ErrorMemory;
+            if (h == FLT_MAX) continue;
+            if (index == current_index) {
+                score = current.score + (x == gx && y == gy ? 0 : 1); /* waiting at the goal is free */
+            } else {
+                score = current.score + rl_distance_simple(rl_point(current.x, current.y), rl_point(x, y));
+            }
+
+            if (coop->nodes_len * 2 >= coop->visited_cap && !rl_coop_grow_visited(coop)) return RL_ErrorMemory;
+            size_t key = rl_coop_key(coop, x, y, current.t + 1);
+            slot = rl_coop_slot(coop->visited, coop->visited_cap, coop->visited_generation, key);
+            size_t n;
+            if (slot->generation == coop->visited_generation) {
+                n = slot->value;
+                if (coop->nodes[n].score <= score) continue;
+            } else {
+                nodes = (RL_CoopNode*) rl_grow_array(coop->allocator, coop->nodes, &coop->nodes_cap, sizeof(*nodes), coop->nodes_len + 1);
+                if (nodes == NULL) return RL_ErrorMemory;
+                coop->nodes = nodes;
+                n = coop->nodes_len++;
+                coop->nodes[n].x = x;
+                coop->nodes[n].y = y;
+                coop->nodes[n].t = current.t + 1;
+                *slot = (RL_CoopSlot) { key, n, coop->visited_generation };
+            }
+            coop->nodes[n].score = score;
+            coop->nodes[n].parent = entry.index;
+            if (!rl_scored_heap_push(coop->allocator, &coop->open, &coop->open_len, &coop->open_cap, score + h, n)) return RL_ErrorMemory;
+        }
+    }
+
+    return RL_OK; /* boxed in - wait */
+}
+
+RL_Status rl_coop_plan(RL_Coop *coop)
+{
+    RL_ASSERT(coop != NULL);
+    if (coop == NULL) return RL_ErrorNullParameter;
+
+    RL_TRACE_BEGIN("rl_coop_plan");
+    rl_coop_clear(coop->reservations, coop->reservations_cap, &coop->reservations_generation);
+    coop->turn++;
+    for (size_t a = 0; a < coop->agent_count; ++a) {
+        RL_CoopAgent *agent = &coop->agents[a];
+        RL_Status status = rl_coop_heuristic(coop, agent);
+        if (status == RL_OK) status = rl_coop_search(coop, a);
+        if (status != RL_OK) {
+            RL_TRACE_END("rl_coop_plan");
+            return status;
+        }
+
+        /* reserve the path, staying at the end of it for the rest of the window */
+        for (unsigned int t = 0; t <= coop->window; ++t) {
+            RL_Point p = agent->path[t < agent->path_length ? t : agent->path_length - 1];
+            size_t key = rl_coop_key(coop, p.x, p.y, t);
+            RL_CoopSlot *slot = rl_coop_slot(coop->reservations, coop->reservations_cap, coop->reservations_generation, key);
+            if (slot->generation != coop->reservations_generation) {
+                *slot = (RL_CoopSlot) { key, a, coop->reservations_generation };
+            }
+        }
+    }
+
+    /* an agent boxed in by the agents planned before it waits in place, but agents planned before it may have
+     * reserved its tile for this turn (expecting it to move) - make those agents wait too, and so on */
+    for (size_t a = 0; a < coop->agent_count; ++a) {
+        size_t waiting = a;
+        while (coop->agents[waiting].path_length == 1) {
+            RL_Point p = coop->agents[waiting].position;
+            size_t other = rl_coop_reserved_by(coop, p.x, p.y, 1);
+            if (other == coop->agent_count || other == waiting || coop->agents[other].path_length == 1) break;
+            coop->agents[other].path_length = 1;
+            waiting = other;
+        }
+    }
+    RL_TRACE_END("rl_coop_plan");
+
+    return RL_OK;
+}
+
+RL_Point rl_coop_next(const RL_Coop *coop, size_t agent)
+{
+    RL_ASSERT(coop != NULL && agent < coop->agent_count);
+    if (coop == NULL || agent >= coop->agent_count) return rl_point(0, 0);
+    const RL_CoopAgent *a = &coop->agents[agent];
+
+    return a->path[a->path_length > 1 ? 1 : 0];
+}
+
+void rl_coop_destroy(RL_Coop *coop)
+{
+    if (coop == NULL) return;
+    if (coop->agents) {
+        for (size_t i = 0; i < coop->agent_count; ++i) {
+            if (coop->agents[i].path) rl_free(coop->allocator, coop->agents[i].path);
+        }
+        rl_free(coop->allocator, coop->agents);
+    }
+    if (coop->heuristics) {
+        for (size_t i = 0; i < coop->agent_count; ++i) {
+            if (coop->heuristics[i].graph.nodes) rl_graph_destroy(coop->heuristics[i].graph);
+            if (coop->heuristics[i].closed) rl_free(coop->allocator, coop->heuristics[i].closed);
+            if (coop->heuristics[i].open) rl_free(coop->allocator, coop->heuristics[i].open);
+        }
+        rl_free(coop->allocator, coop->heuristics);
+    }
+    if (coop->reservations) rl_free(coop->allocator, coop->reservations);
+    if (coop->visited) rl_free(coop->allocator, coop->visited);
+    if (coop->nodes) rl_free(coop->allocator, coop->nodes);
+    if (coop->open) rl_free(coop->allocator, coop->open);
+    rl_free(coop->allocator, coop);
+}
+
+RL_Influence *rl_influence_create(const RL_Map map, RL_ScoreFun score_f, RL_NeighborsFun neighbors_f)
+{
+    return rl_influence_create_ex(map, score_f, neighbors_f, NULL);
+}
+
+RL_Influence *rl_influence_create_ex(const RL_Map map, RL_ScoreFun score_f, RL_NeighborsFun neighbors_f, const RL_Allocator *allocator)
+{
+    RL_ASSERT(map.tiles != NULL);
+    if (map.tiles == NULL) return NULL;
+    RL_Influence *influence = (RL_Influence*) rl_calloc(allocator, 1, sizeof(*influence));
+    RL_ASSERT(influence);
+    if (influence == NULL) return NULL;
+    influence->allocator = allocator;
+    influence->map = map;
+    influence->values = (float*) rl_calloc(allocator, (size_t) map.width * map.height, sizeof(*influence->values));
+    influence->scale = 1;
+    influence->decay = 1;
+    influence->graph = rl_graph_create_ex(map.width, map.height, neighbors_f, allocator);
+    influence->score_f = score_f ? score_f : rl_graph_score_simple;
+    influence->visited = (unsigned int*) rl_calloc(allocator, (size_t) map.width * map.height, sizeof(*influence->visited));
+    if (influence->values == NULL || influence->graph.nodes == NULL || influence->visited == NULL) {
+        rl_influence_destroy(influence);
+        return NULL;
+    }
+
+    return influence;
+}
+
+void rl_influence_destroy(RL_Influence *influence)
+{
+    if (influence == NULL) return;
+    if (influence->values) rl_free(influence->allocator, influence->values);
+    if (influence->graph.nodes) rl_graph_destroy(influence->graph);
+    if (influence->visited) rl_free(influence->allocator, influence->visited);
+    if (influence->open) rl_free(influence->allocator, influence->open);
+    rl_free(influence->allocator, influence);
+}
+
+void rl_influence_clear(RL_Influence *influence)
+{
+    RL_ASSERT(influence != NULL);
+    if (influence == NULL) return;
+    memset(influence->values, 0, sizeof(*influence->values) * influence->map.width * influence->map.height);
+    influence->scale = 1;
+    influence->decay = 1;
+}
+
+static float rl_influence_falloff(RL_InfluenceSource source, float distance)
+{
+    switch (source.falloff) {
+        case RL_FalloffInverse:
+            return source.strength / (1 + distance);
+        case RL_FalloffConstant:
+            return source.strength;
+        case RL_FalloffLinear:
+        default:
+            return source.strength * (1 - distance / (source.radius + 1));
     }
+}
 
-    return RL_OK;
+typedef struct {
+    RL_Influence *influence;
+    RL_InfluenceSource source;
+    float amount;
+} RL_InfluencePropagation;
+
+static bool rl_influence_settle(void *user, size_t index, float distance)
+{
+    RL_InfluencePropagation *propagation = (RL_InfluencePropagation*) user;
+    propagation->influence->values[index] += propagation->amount * rl_influence_falloff(propagation->source, distance);
+
+    return true;
 }
 
+/* bounded Dijkstra from the source, adding amount * the falloff to each tile within the radius */
+static RL_Status rl_influence_propagate(RL_Influence *influence, RL_InfluenceSource source, float amount)
+{
+    RL_Map map;
+    RL_GraphContext context;
+    RL_InfluencePropagation propagation;
+    RL_ScoredRelax relax;
+    RL_ASSERT(influence != NULL);
+    if (influence == NULL) return RL_ErrorNullParameter;
+    map = influence->map;
+    RL_ASSERT(rl_map_in_bounds(map, source.x, source.y) && source.radius >= 0);
+    if (!rl_map_in_bounds(map, source.x, source.y) || source.radius < 0) return RL_ErrorInvalidParameter;
+    if (++influence->generation == 0) {
+        memset(influence->visited, 0, sizeof(*influence->visited) * map.width * map.height);
+        influence->generation = 1;
+    }
+    context = rl_graph_context(influence->graph, map);
+    propagation.influence = influence;
+    propagation.source = source;
+    propagation.amount = amount;
+    relax = (RL_ScoredRelax) {
+        .graph = influence->graph,
+        .context = &context,
+        .score_f = influence->score_f,
+        .visited = influence->visited,
+        .generation = influence->generation,
+        .max_distance = source.radius,
+        .open = &influence->open,
+        .open_len = &influence->open_len,
+        .open_cap = &influence->open_cap,
+        .allocator = influence->allocator,
+        .settle_f = rl_influence_settle,
+        .user = &propagation,
+    };
+    influence->open_len = 0;
+    if (!rl_scored_relax_seed(&relax, source.x + source.y * map.width)) return RL_ErrorMemory;
+
+    return rl_scored_relax(&relax);
+}
 
-#if RL_ENABLE_PATHFINDING
-/* simplified distance for side by side nodes */
-static float rl_distance_simple(RL_Point node, RL_Point end)
+RL_Status rl_influence_add(RL_Influence *influence, RL_InfluenceSource *source)
 {
-    if (node.x == end.x && node.y == end.y) return 0;
-    if (node.x == end.x || node.y == end.y) return 1;
-    return 1.4;
+    RL_ASSERT(influence != NULL && source != NULL);
+    if (influence == NULL || source == NULL) return RL_ErrorNullParameter;
+    source->decay = influence->decay;
+
+    return rl_influence_propagate(influence, *source, 1 / influence->scale);
 }
 
-RL_Path *rl_path(RL_Point p)
+RL_Status rl_influence_remove(RL_Influence *influence, RL_InfluenceSource source)
 {
-    RL_Path *path = (RL_Path*) RL_MALLOC(sizeof(*path));
-    RL_ASSERT(path);
-    if (path == NULL) return NULL;
-    path->next = NULL;
-    path->point = p;
+    double left;
+    RL_ASSERT(influence != NULL);
+    if (influence == NULL) return RL_ErrorNullParameter;
+    /* the source has decayed by the factors since it was added */
+    left = source.decay > 0 ? influence->decay / source.decay : 0;
 
-    return path;
+    return rl_influence_propagate(influence, source, (float) (-left / influence->scale));
 }
 
-float rl_distance_manhattan(RL_Point node, RL_Point end)
+RL_Status rl_influence_move(RL_Influence *influence, RL_InfluenceSource *source, unsigned int x, unsigned int y)
 {
-    return fabs(node.x - end.x) + fabs(node.y - end.y);
+    RL_Status status;
+    RL_ASSERT(influence != NULL && source != NULL);
+    if (influence == NULL || source == NULL) return RL_ErrorNullParameter;
+    if (source->x == x && source->y == y) return RL_OK;
+    if (!rl_map_in_bounds(influence->map, x, y)) return RL_ErrorInvalidParameter;
+    status = rl_influence_remove(influence, *source);
+    if (status != RL_OK) return status;
+    source->x = x;
+    source->y = y;
+
+    return rl_influence_add(influence, source);
 }
 
-float rl_distance_manhattan_3d(RL_Point3d node, RL_Point3d end)
+void rl_influence_decay(RL_Influence *influence, float factor)
 {
-    return fabs(node.x - end.x) + fabs(node.y - end.y) + fabs(node.z - end.z);
+    size_t i, length;
+    float *values;
+    RL_ASSERT(influence != NULL && factor >= 0);
+    if (influence == NULL) return;
+    if (factor <= 0) {
+        rl_influence_clear(influence);
+        return;
+    }
+    influence->decay *= factor;
+    influence->scale *= factor;
+    if (influence->scale >= 1e-3f) return;
+    /* fold the scale into the values before they grow large enough to lose precision */
+    values = influence->values;
+    length = (size_t) influence->map.width * influence->map.height;
+    for (i = 0; i < length; ++i) {
+        values[i] *= influence->scale;
+    }
+    influence->scale = 1;
 }
 
-float rl_distance_manhattan_axial(RL_Point node, RL_Point end)
+float rl_influence_value(const RL_Influence *influence, unsigned int x, unsigned int y)
 {
-    float s1 = -1 * (node.x + node.y);
-    float s2 = -1 * (end.x  + end.y);
+    RL_ASSERT(influence != NULL);
+    if (influence == NULL || !rl_map_in_bounds(influence->map, x, y)) return 0;
 
-    return 0.5 * rl_distance_manhattan_3d((RL_Point3d) {node.x, node.y, s1},
-                                          (RL_Point3d) {end.x,  end.y,  s2});
+    return influence->values[x + y * influence->map.width] * influence->scale;
 }
 
-float rl_distance_euclidian(RL_Point node, RL_Point end)
+typedef struct {
+    int x, y;
+    float distance, angle;
+} RL_AoeOffset;
+
+static int rl_aoe_offset_compare(const void *a, const void *b)
 {
-    float distance_x = node.x - end.x;
-    float distance_y = node.y - end.y;
+    const RL_AoeOffset *offset_a = (const RL_AoeOffset*) a;
+    const RL_AoeOffset *offset_b = (const RL_AoeOffset*) b;
+    if (offset_a->distance != offset_b->distance) return offset_a->distance < offset_b->distance ? -1 : 1;
+    if (offset_a->angle != offset_b->angle) return offset_a->angle < offset_b->angle ? -1 : 1;
 
-    return sqrt(distance_x * distance_x + distance_y * distance_y);
+    return 0;
 }
 
-float rl_distance_chebyshev(RL_Point node, RL_Point end)
+/* rounds half away from zero, so parents are symmetric around the origin */
+static int rl_aoe_round(float v)
 {
-    float distance_x = fabs(node.x - end.x);
-    float distance_y = fabs(node.y - end.y);
+    return v < 0 ? -(int) (-v + 0.5f) : (int) (v + 0.5f);
+}
 
-    return distance_x > distance_y ? distance_x : distance_y;
+RL_AoeTable rl_aoe_table_create(unsigned int max_radius)
+{
+    return rl_aoe_table_create_ex(max_radius, NULL);
 }
 
-float rl_graph_score_manhattan(void *context, const RL_GraphNode *current, const RL_GraphNode *neighbor)
+RL_AoeTable rl_aoe_table_create_ex(unsigned int max_radius, const RL_Allocator *allocator)
 {
-    RL_UNUSED(context);
+    RL_AoeTable table = {0};
+    int size = 2 * (int) max_radius + 1, r = (int) max_radius;
+    RL_AoeOffset *sorted = (RL_AoeOffset*) rl_malloc(allocator, sizeof(*sorted) * size * size);
+    size_t *grid = (size_t*) rl_malloc(allocator, sizeof(*grid) * size * size); /* offset index of each cell in the square */
+    size_t length = 0;
+    RL_ASSERT(sorted && grid);
+    if (sorted == NULL || grid == NULL) {
+        if (sorted) rl_free(allocator, sorted);
+        if (grid) rl_free(allocator, grid);
+        return table;
+    }
+    for (int y = -r; y <= r; ++y) {
+        for (int x = -r; x <= r; ++x) {
+            float distance = sqrtf((float) (x*x + y*y));
+            if (distance > max_radius) continue;
+            sorted[length++] = (RL_AoeOffset) { x, y, distance, atan2f((float) y, (float) x) };
+        }
+    }
+    qsort(sorted, length, sizeof(*sorted), rl_aoe_offset_compare);
+
+    table.allocator = allocator;
+    table.offsets = (int*) rl_malloc(allocator, sizeof(*table.offsets) * 2 * length);
+    table.distances = (float*) rl_malloc(allocator, sizeof(*table.distances) * length);
+    table.angles = (float*) rl_malloc(allocator, sizeof(*table.angles) * length);
+    table.parents = (size_t*) rl_malloc(allocator, sizeof(*table.parents) * length);
+    table.hit = (RL_Byte*) rl_malloc(allocator, sizeof(*table.hit) * length);
+    if (table.offsets == NULL || table.distances == NULL || table.angles == NULL || table.parents == NULL || table.hit == NULL) {
+        rl_aoe_table_destroy(table);
+        rl_free(allocator, sorted);
+        rl_free(allocator, grid);
+        table.offsets = NULL;
+        return table;
+    }
+    table.max_radius = max_radius;
+    table.length = length;
+    for (size_t i = 0; i < length; ++i) {
+        table.offsets[i*2] = sorted[i].x;
+        table.offsets[i*2 + 1] = sorted[i].y;
+        table.distances[i] = sorted[i].distance;
+        table.angles[i] = sorted[i].angle;
+        grid[(sorted[i].x + r) + (sorted[i].y + r) * size] = i;
+    }
+    /* parent - the cell on the line to the origin one chebyshev step closer, always closer so it is sorted earlier */
+    table.parents[0] = 0;
+    for (size_t i = 1; i < length; ++i) {
+        int x = sorted[i].x, y = sorted[i].y;
+        int steps = abs(x) > abs(y) ? abs(x) : abs(y);
+        int px = rl_aoe_round((float) x * (steps - 1) / steps), py = rl_aoe_round((float) y * (steps - 1) / steps);
+        table.parents[i] = grid[(px + r) + (py + r) * size];
+        RL_ASSERT(table.parents[i] < i);
+    }
+    rl_free(allocator, sorted);
+    rl_free(allocator, grid);
 
-    return current->score + rl_distance_manhattan(current->point, neighbor->point);
+    return table;
 }
 
-float rl_graph_score_manhattan_axial(void *context, const RL_GraphNode *current, const RL_GraphNode *neighbor)
+void rl_aoe_table_destroy(RL_AoeTable table)
 {
-    RL_UNUSED(context);
+    if (table.offsets) rl_free(table.allocator, table.offsets);
+    if (table.distances) rl_free(table.allocator, table.distances);
+    if (table.angles) rl_free(table.allocator, table.angles);
+    if (table.parents) rl_free(table.allocator, table.parents);
+    if (table.hit) rl_free(table.allocator, table.hit);
+}
 
-    return current->score + rl_distance_manhattan_axial(current->point, neighbor->point);
+/* walks the offsets within radius, marking the hit tiles & writing those within the cone (if cone is set) to out */
+static size_t rl_aoe_query(RL_AoeTable *table, const RL_Map map, RL_Point origin, float radius, bool cone, float direction, float half_angle, RL_Point *out, size_t out_cap)
+{
+    size_t count = 0;
+    RL_ASSERT(table != NULL && table->offsets != NULL && map.tiles != NULL && out != NULL);
+    if (table == NULL || table->offsets == NULL || map.tiles == NULL || out == NULL) return 0;
+    RL_ASSERT(radius <= table->max_radius);
+    if (!rl_map_in_bounds(map, origin.x, origin.y)) return 0;
+    for (size_t i = 0; i < table->length && table->distances[i] <= radius; ++i) {
+        unsigned int x = (unsigned int) origin.x + table->offsets[i*2], y = (unsigned int) origin.y + table->offsets[i*2 + 1];
+        size_t parent = table->parents[i];
+        table->hit[i] = 0;
+        if (!rl_map_in_bounds(map, x, y)) continue;
+        if (i > 0) {
+            unsigned int px = (unsigned int) origin.x + table->offsets[parent*2], py = (unsigned int) origin.y + table->offsets[parent*2 + 1];
+            if (!table->hit[parent] || (parent > 0 && RL_OPAQUE_F(map, px, py))) continue;
+        }
+        table->hit[i] = 1;
+        if (cone) {
+            const float pi = 3.14159265f;
+            float diff = fabsf(table->angles[i] - direction);
+            if (diff > pi) diff = 2 * pi - diff;
+            if (i == 0 || diff > half_angle) continue;
+        }
+        if (count == out_cap) break;
+        out[count++] = rl_point(x, y);
+    }
+
+    return count;
 }
 
-float rl_graph_score_euclidian(void *context, const RL_GraphNode *current, const RL_GraphNode *neighbor)
+size_t rl_aoe_blast(RL_AoeTable *table, const RL_Map map, RL_Point center, float radius, RL_Point *out, size_t out_cap)
 {
-    RL_UNUSED(context);
+    return rl_aoe_query(table, map, center, radius, false, 0, 0, out, out_cap);
+}
 
-    return current->score + rl_distance_euclidian(current->point, neighbor->point);
+size_t rl_aoe_cone(RL_AoeTable *table, const RL_Map map, RL_Point origin, RL_Point target, float radius, float half_angle, RL_Point *out, size_t out_cap)
+{
+    float direction = atan2f(target.y - origin.y, target.x - origin.x);
+
+    return rl_aoe_query(table, map, origin, radius, true, direction, half_angle, out, out_cap);
 }
 
-float rl_graph_score_chebyshev(void *context, const RL_GraphNode *current, const RL_GraphNode *neighbor)
+size_t rl_aoe_line(const RL_Map map, RL_Point origin, RL_Point target, unsigned int length, RL_Point *out, size_t out_cap)
 {
-    RL_UNUSED(context);
+    /* Bresenham from origin towards target, continuing past the target */
+    int x = (int) origin.x, y = (int) origin.y;
+    int dx = abs((int) target.x - x), dy = -abs((int) target.y - y);
+    int sx = x < (int) target.x ? 1 : -1, sy = y < (int) target.y ? 1 : -1;
+    int error = dx + dy;
+    size_t count = 0;
+    RL_ASSERT(map.tiles != NULL && out != NULL);
+    if (map.tiles == NULL || out == NULL || (dx == 0 && dy == 0)) return 0;
+    while (count < length && count < out_cap) {
+        int e2 = 2 * error;
+        if (e2 >= dy) { error += dy; x += sx; }
+        if (e2 <= dx) { error += dx; y += sy; }
+        if (!rl_map_in_bounds(map, x, y) || RL_OPAQUE_F(map, x, y)) break;
+        out[count++] = rl_point(x, y);
+    }
 
-    return current->score + rl_distance_chebyshev(current->point, neighbor->point);
+    return count;
 }
 
-float rl_graph_score_simple(void *context, const RL_GraphNode *current, const RL_GraphNode *neighbor)
+/* scratch memory for a room table sweep - one per thread */
+typedef struct {
+    RL_RoomTable table;
+    int room;
+    size_t found;
+    RL_Graph graph; /* node scores hold the distances from the exits of the room */
+    int *via;       /* first room entered on the way to each tile (-1 for none yet) */
+    unsigned int *visited;
+    unsigned int generation;
+    RL_ScoredIndex *open;
+    size_t open_len;
+    size_t open_cap;
+} RL_RoomSweep;
+
+/* the sweeps run in parallel with OpenMP - serialize the calls to the allocator */
+static void *rl_room_table_alloc_f(void *user, size_t size)
+{
+    void *ptr;
+#ifdef _OPENMP
+#pragma omp critical(rl_room_table_allocator)
+#endif
+    ptr = rl_malloc((const RL_Allocator*) user, size);
+
+    return ptr;
+}
+
+static void rl_room_table_free_f(void *user, void *ptr)
 {
-    RL_UNUSED(context);
+#ifdef _OPENMP
+#pragma omp critical(rl_room_table_allocator)
+#endif
+    rl_free((const RL_Allocator*) user, ptr);
+}
 
-    return current->score + rl_distance_simple(current->point, neighbor->point);
+static bool rl_room_table_settle(void *user, size_t index, float distance)
+{
+    RL_RoomSweep *sweep = (RL_RoomSweep*) user;
+    RL_RoomTable table = sweep->table;
+    int current = table.rooms[index];
+    size_t row = (size_t) sweep->room * table.room_count;
+    if (sweep->found >= table.room_count) return false;
+    if (current >= 0 && current != sweep->room && table.next_hops[row + current] < 0) {
+        /* the first tile popped in a room is the closest */
+        table.distances[row + current] = distance;
+        table.next_hops[row + current] = sweep->via[index];
+        sweep->found++;
+    }
+
+    return true;
 }
 
+static bool rl_room_table_enter(void *user, size_t from, size_t to)
+{
+    RL_RoomSweep *sweep = (RL_RoomSweep*) user;
+    /* the exits of the room are all seeded, so the search never needs to walk back in */
+    if (sweep->table.rooms[to] == sweep->room) return false;
+    sweep->via[to] = sweep->via[from] >= 0 ? sweep->via[from] : sweep->table.rooms[to];
+
+    return true;
+}
 
-RL_Graph rl_graph_floodfill_largest_area(const RL_Map map)
+/* multi-source Dijkstra from the exits of the room, filling in the row of the room */
+static RL_Status rl_room_table_sweep(RL_RoomTable table, const RL_Map map, RL_RoomSweep *sweep, const RL_Allocator *allocator, int room)
 {
-    RL_Graph floodfill = {0};
-    RL_ASSERT(map.tiles);
-    if (map.tiles == NULL) return floodfill;
-    int *visited = (int*) RL_CALLOC(map.width * map.height, sizeof(*visited));
-    RL_ASSERT(visited);
-    if (visited == NULL) return floodfill;
-    int floodfill_scored = 0;
-    for (unsigned int x = 0; x < map.width; ++x) {
-        for (unsigned int y = 0; y < map.height; ++y) {
-            if (RL_PASSABLE_F(map, x, y) && !visited[x + y*map.width]) {
-                RL_Graph test = rl_graph_create_scored(map, rl_point(x, y), NULL, NULL);
-                RL_ASSERT(test.nodes != NULL);
-                if (test.nodes == NULL) {
-                    RL_FREE(visited);
-                    // memory error
-                    return floodfill;
-                }
-                int test_scored = 0;
-                for (size_t i = 0; i < test.length; i++) {
-                    if (test.nodes[i].score != FLT_MAX) {
-                        visited[i] = 1;
-                        test_scored ++;
-                    }
-                }
-                if (test_scored > floodfill_scored) {
-                    floodfill_scored = test_scored;
-                    if (floodfill.nodes != NULL) {
-                        rl_graph_destroy(floodfill);
+    RL_GraphContext context = rl_graph_context(sweep->graph, map);
+    RL_ScoredRelax relax;
+    unsigned int x, y;
+    if (++sweep->generation == 0) {
+        memset(sweep->visited, 0, sizeof(*sweep->visited) * map.width * map.height);
+        sweep->generation = 1;
+    }
+    sweep->table = table;
+    sweep->room = room;
+    sweep->found = 1;
+    sweep->open_len = 0;
+    relax = (RL_ScoredRelax) {
+        .graph = sweep->graph,
+        .context = &context,
+        .score_f = rl_graph_score_simple,
+        .visited = sweep->visited,
+        .generation = sweep->generation,
+        .max_distance = FLT_MAX,
+        .open = &sweep->open,
+        .open_len = &sweep->open_len,
+        .open_cap = &sweep->open_cap,
+        .allocator = allocator,
+        .settle_f = rl_room_table_settle,
+        .enter_f = rl_room_table_enter,
+        .user = sweep,
+    };
+    for (y = 0; y < map.height; ++y) {
+        for (x = 0; x < map.width; ++x) {
+            size_t i = x + y * map.width;
+            bool exit = false;
+            if (table.rooms[i] != room) continue;
+            for (int dy = -1; dy <= 1 && !exit; ++dy) {
+                for (int dx = -1; dx <= 1; ++dx) {
+                    unsigned int nx = x + dx, ny = y + dy;
+                    if (!rl_map_in_bounds(map, nx, ny) || !RL_PASSABLE_F(map, nx, ny)) continue;
+                    if (table.rooms[nx + ny * map.width] != room) {
+                        exit = true;
+                        break;
                     }
-                    floodfill = test;
-                } else {
-                    rl_graph_destroy(test);
                 }
             }
+            if (!exit) continue;
+            sweep->via[i] = -1;
+            if (!rl_scored_relax_seed(&relax, i)) return RL_ErrorMemory;
         }
     }
 
-    RL_FREE(visited);
-
-    return floodfill;
+    return rl_scored_relax(&relax);
 }
 
-RL_Point rl_point(unsigned int x, unsigned int y)
+RL_RoomTable rl_room_table_create(const RL_Map map, const RL_Rect *rects, size_t room_count)
 {
-    return (RL_Point) { .x = (float) x, .y = (float) y };
+    return rl_room_table_create_ex(map, rects, room_count, NULL);
 }
 
-// TODO better bounds checking
-RL_Point rl_point_axial(unsigned int x, unsigned int y)
+RL_RoomTable rl_room_table_create_ex(const RL_Map map, const RL_Rect *rects, size_t room_count, const RL_Allocator *allocator)
 {
-    RL_Point point;
-
-    RL_ASSERT(x < INT_MAX && y < INT_MAX);
+    RL_RoomTable table = {0};
+    RL_Allocator serialized;
+    RL_Status status = RL_OK;
+    size_t length, i;
+    RL_ASSERT(map.tiles != NULL && (rects != NULL || room_count == 0));
+    if (map.tiles == NULL || (rects == NULL && room_count > 0)) return table;
+    RL_ASSERT(room_count < INT_MAX);
+    if (room_count >= INT_MAX) return table;
+    length = (size_t) map.width * map.height;
+    table.allocator = allocator;
+    table.rooms = (int*) rl_malloc(allocator, sizeof(*table.rooms) * length);
+    table.distances = (float*) rl_malloc(allocator, sizeof(*table.distances) * (room_count * room_count + 1));
+    table.next_hops = (int*) rl_malloc(allocator, sizeof(*table.next_hops) * (room_count * room_count + 1));
+    if (table.rooms == NULL || table.distances == NULL || table.next_hops == NULL) {
+        rl_room_table_destroy(table);
+        table.distances = NULL;
+        return table;
+    }
+    table.room_count = room_count;
+    table.width = map.width;
+    table.height = map.height;
+    RL_TRACE_BEGIN("rl_room_table_create");
+    for (i = 0; i < length; ++i) {
+        table.rooms[i] = -1;
+    }
+    for (i = 0; i < room_count; ++i) {
+        for (unsigned int y = rects[i].y; y < rects[i].y + rects[i].height && y < map.height; ++y) {
+            for (unsigned int x = rects[i].x; x < rects[i].x + rects[i].width && x < map.width; ++x) {
+                size_t t = x + y * map.width;
+                if (map.tiles[t] == RL_TileRoom && table.rooms[t] < 0) table.rooms[t] = (int) i;
+            }
+        }
+    }
+    for (i = 0; i < room_count * room_count; ++i) {
+        bool same = i / room_count == i % room_count;
+        table.distances[i] = same ? 0 : FLT_MAX;
+        table.next_hops[i] = same ? (int) (i / room_count) : -1;
+    }
 
-    int x_ = x;
-    int y_ = y;
-#if RL_HEX_FLAT_TOP == 1
-    int val = x_ & 1;
-#if RL_HEX_ODD_OFFSET == 1
-    int shift = (x_ - val) / 2;
-#else
-    int shift = (x_ + val) / 2;
+    /* each sweep only writes to the row of its own room */
+    serialized.alloc_f = rl_room_table_alloc_f;
+    serialized.free_f = rl_room_table_free_f;
+    serialized.user = (void*) allocator;
+#ifdef _OPENMP
+#pragma omp parallel
 #endif
-    point.x = x_;
-    point.y = y_ - shift;
-#else // RL_HEX_FLAT_TOP
-    int val = y_ & 1;
-#if RL_HEX_ODD_OFFSET == 1
-    int shift = (y_ - val) / 2;
-#else
-    int shift = (y_ + val) / 2;
+    {
+        RL_RoomSweep sweep = {0};
+        long room;
+        sweep.graph = rl_graph_create_ex(map.width, map.height, NULL, &serialized);
+        sweep.via = (int*) rl_malloc(&serialized, sizeof(*sweep.via) * length);
+        sweep.visited = (unsigned int*) rl_calloc(&serialized, length, sizeof(*sweep.visited));
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
 #endif
-    point.x = x_ - shift;
-    point.y = y_;
-#endif // RL_HEX_FLAT_TOP
+        for (room = 0; room < (long) room_count; ++room) {
+            RL_Status sweep_status = RL_ErrorMemory;
+            if (sweep.graph.nodes && sweep.via && sweep.visited) {
+                sweep_status = rl_room_table_sweep(table, map, &sweep, &serialized, (int) room);
+            }
+            if (sweep_status != RL_OK) {
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+                status = sweep_status;
+            }
+        }
+        if (sweep.graph.nodes) rl_graph_destroy(sweep.graph);
+        if (sweep.via) rl_free(&serialized, sweep.via);
+        if (sweep.visited) rl_free(&serialized, sweep.visited);
+        if (sweep.open) rl_free(&serialized, sweep.open);
+    }
+    RL_TRACE_END("rl_room_table_create");
+    if (status != RL_OK) {
+        rl_room_table_destroy(table);
+        table.distances = NULL;
+    }
 
-    return point;
+    return table;
 }
 
-RL_Point rl_axial_to_offset(RL_Point axial)
+RL_RoomTable rl_room_table_create_bsp(const RL_Map map, const RL_BSP *root)
 {
-    RL_Point offset;
-
-#if RL_HEX_FLAT_TOP == 1
-    // Flat-topped hex layouts (columns are shifted)
-#if RL_HEX_ODD_OFFSET == 1
-    offset.x = axial.x;
-    offset.y = axial.y + (axial.x - ((int)axial.x & 1)) / 2;
-#else
-    offset.x = axial.x;
-    offset.y = axial.y + (axial.x + ((int)axial.x & 1)) / 2;
-#endif
-#else // RL_HEX_FLAT_TOP
-#if RL_HEX_ODD_OFFSET == 1
-    offset.x = axial.x + (axial.y - ((int)axial.y & 1)) / 2;
-    offset.y = axial.y;
-#else
-    offset.x = axial.x + (axial.y + ((int)axial.y & 1)) / 2;
-    offset.y = axial.y;
-#endif
-#endif // RL_HEX_FLAT_TOP
-
-    return offset;
+    return rl_room_table_create_bsp_ex(map, root, NULL);
 }
 
-unsigned int rl_axial_to_map_x(RL_Point axial)
+RL_RoomTable rl_room_table_create_bsp_ex(const RL_Map map, const RL_BSP *root, const RL_Allocator *allocator)
 {
-    return rl_axial_to_offset(axial).x;
+    RL_RoomTable table = {0};
+    RL_Rect *rects;
+    const RL_BSP *leaf;
+    size_t count, i = 0;
+    RL_ASSERT(root != NULL);
+    if (root == NULL) return table;
+    count = rl_bsp_leaf_count(root);
+    rects = (RL_Rect*) rl_malloc(allocator, sizeof(*rects) * count);
+    RL_ASSERT(rects != NULL);
+    if (rects == NULL) return table;
+    leaf = root;
+    while (leaf->left != NULL) {
+        leaf = leaf->left;
+    }
+    for (; leaf != NULL && i < count; leaf = rl_bsp_next_leaf(leaf)) {
+        rects[i].x = leaf->x;
+        rects[i].y = leaf->y;
+        rects[i].width = leaf->width;
+        rects[i].height = leaf->height;
+        i++;
+    }
+    table = rl_room_table_create_ex(map, rects, i, allocator);
+    rl_free(allocator, rects);
+
+    return table;
 }
 
-unsigned int rl_axial_to_map_y(RL_Point axial)
+void rl_room_table_destroy(RL_RoomTable table)
 {
-    return rl_axial_to_offset(axial).y;
+    if (table.rooms) rl_free(table.allocator, table.rooms);
+    if (table.distances) rl_free(table.allocator, table.distances);
+    if (table.next_hops) rl_free(table.allocator, table.next_hops);
 }
 
-RL_Path *rl_line_create(RL_Point a, RL_Point b, float step)
+int rl_room_table_room(const RL_RoomTable table, unsigned int x, unsigned int y)
 {
-    float delta_x = fabs(a.x - b.x);
-    float x_increment = b.x > a.x ? step : -step;
-    float delta_y = fabs(a.y - b.y);
-    float y_increment = b.y > a.y ? step : -step;
-    float error = 0.0;
-    float slope = delta_x ? delta_y / delta_x : 0.0;
-
-    RL_Path *head = rl_path(a);
-    if (head == NULL) return NULL;
-    RL_Path *path = head;
-    while (path->point.x != b.x || path->point.y != b.y) {
-        RL_Point point = path->point;
+    RL_ASSERT(table.rooms != NULL);
+    if (table.rooms == NULL || x >= table.width || y >= table.height) return -1;
 
-        if (delta_x > delta_y) {
-            error += slope;
-            if (error > 0.5 && point.y != b.y) {
-                error -= 1.0;
-                point.y += y_increment;
-            }
+    return table.rooms[x + y * table.width];
+}
 
-            point.x += x_increment;
-        } else {
-            error += 1/slope;
-            if (error > 0.5 && point.x != b.x) {
-                error -= 1.0;
-                point.x += x_increment;
-            }
+float rl_room_table_distance(const RL_RoomTable table, int from, int to)
+{
+    RL_ASSERT(table.distances != NULL && from >= 0 && to >= 0 && (size_t) from < table.room_count && (size_t) to < table.room_count);
+    if (table.distances == NULL || from < 0 || to < 0 || (size_t) from >= table.room_count || (size_t) to >= table.room_count) return FLT_MAX;
 
-            point.y += y_increment;
-        }
+    return table.distances[(size_t) from * table.room_count + to];
+}
 
-        /* add new member to linked list & advance */
-        path->next = rl_path(point);
-        path = path->next;
-    }
+int rl_room_table_next(const RL_RoomTable table, int from, int to)
+{
+    RL_ASSERT(table.next_hops != NULL && from >= 0 && to >= 0 && (size_t) from < table.room_count && (size_t) to < table.room_count);
+    if (table.next_hops == NULL || from < 0 || to < 0 || (size_t) from >= table.room_count || (size_t) to >= table.room_count) return -1;
 
-    return head;
+    return table.next_hops[(size_t) from * table.room_count + to];
 }
 
-RL_Path *rl_path_create(const RL_Map map, RL_Point start, RL_Point end, RL_ScoreFun score_f, RL_NeighborsFun neighbors_f)
+/* Dijkstra from the source lowering the distances (node scores) to it - tiles that are already closer to another
+ * source are pruned */
+static RL_Status rl_place_relax(RL_Map map, RL_Graph graph, RL_ScoredIndex **open, size_t *open_cap, size_t source)
 {
-    RL_Graph graph = rl_graph_create_scored(map, end, score_f, neighbors_f);
-    RL_ASSERT(graph.nodes);
-    if (graph.nodes == NULL) return NULL;
-    RL_Path *path = rl_path_create_from_graph(graph, map, start);
-    RL_ASSERT(path);
-    rl_graph_destroy(graph);
+    RL_GraphContext context = rl_graph_context(graph, map);
+    size_t open_len = 0;
+    RL_ScoredRelax relax = {
+        .graph = graph,
+        .context = &context,
+        .score_f = rl_graph_score_simple,
+        .max_distance = FLT_MAX,
+        .open = open,
+        .open_len = &open_len,
+        .open_cap = open_cap,
+    };
+    if (!rl_scored_relax_seed(&relax, source)) return RL_ErrorMemory;
 
-    return path;
+    return rl_scored_relax(&relax);
 }
 
-RL_Path *rl_path_create_from_graph(const RL_Graph graph, const RL_Map map, RL_Point start)
+/* scores the distance field from start, returns an empty graph (nodes set to NULL) on allocation failure */
+static RL_Graph rl_place_distances(RL_Map map, RL_Point start, RL_ScoredIndex **open, size_t *open_cap)
 {
-    RL_Path *path = rl_path(start);
-    RL_Path *path_start = path;
-    RL_GraphNode *node = NULL;
-    RL_ASSERT(path != NULL);
+    RL_Graph graph = rl_graph_create(map.width, map.height, NULL);
     RL_ASSERT(graph.nodes != NULL);
-    if (path == NULL || graph.nodes == NULL) return NULL;
-    for (size_t i=0; i<graph.length; i++) {
-        if (graph.nodes[i].point.x == start.x && graph.nodes[i].point.y == start.y) {
-            node = &graph.nodes[i];
-        }
+    if (graph.nodes == NULL) return graph;
+    if (rl_place_relax(map, graph, open, open_cap, (size_t) start.x + (size_t) start.y * map.width) != RL_OK) {
+        rl_graph_destroy(graph);
+        graph.nodes = NULL;
     }
-    if (node == NULL) {
-        return path;
-    }
-    while (node != NULL && node->score > 0) {
-        node = rl_graph_node_lowest_neighbor(graph, map, node);
-        if (node == NULL) break;
-        path->next = rl_path(node->point);
-        RL_ASSERT(path->next);
-        if (path->next == NULL) {
-            rl_path_destroy(path);
-            return NULL;
+
+    return graph;
+}
+
+/* partially sorts the items so the k-th lowest score is at k (quickselect with a 3 way partition for equal distances) */
+static void rl_place_select(RL_ScoredIndex *items, size_t length, size_t k)
+{
+    size_t lo = 0, hi = length;
+    while (hi - lo > 1) {
+        float pivot = items[lo + (hi - lo) / 2].score;
+        size_t lt = lo, i = lo, gt = hi;
+        while (i < gt) {
+            RL_ScoredIndex item = items[i];
+            if (item.score < pivot) {
+                items[i++] = items[lt];
+                items[lt++] = item;
+            } else if (item.score > pivot) {
+                items[i] = items[--gt];
+                items[gt] = item;
+            } else {
+                i++;
+            }
         }
-        path = path->next;
+        if (k < lt) hi = lt;
+        else if (k >= gt) lo = gt;
+        else return;
     }
-
-    return path_start;
 }
 
-RL_Path *rl_path_walk(RL_Path *path)
+RL_Status rl_rng_map_percentile(RL_Map map, RL_Point start, float min_percentile, float max_percentile, void *context, RL_MatchesFun f, unsigned int *x, unsigned int *y)
 {
-    if (!path) return NULL;
-    RL_Path *next = path->next;
-    path->next = NULL;
-    RL_FREE(path);
+    RL_ScoredIndex *candidates = NULL;
+    size_t candidates_len = 0, candidates_cap = 0, lo, hi, rank;
+    RL_Graph distances;
+    RL_Status status = RL_OK;
+    RL_ASSERT(map.tiles != NULL && x != NULL && y != NULL);
+    if (map.tiles == NULL || x == NULL || y == NULL) return RL_ErrorNullParameter;
+    RL_ASSERT(rl_map_in_bounds(map, start.x, start.y) && min_percentile <= max_percentile);
+    if (!rl_map_in_bounds(map, start.x, start.y) || !(min_percentile <= max_percentile)) return RL_ErrorInvalidParameter;
+    distances = rl_place_distances(map, start, &candidates, &candidates_cap); /* the heap memory is reused for the candidates */
+    if (distances.nodes == NULL) {
+        if (candidates) rl_free(NULL, candidates);
+        return RL_ErrorMemory;
+    }
+    RL_ScoredIndex *memory = (RL_ScoredIndex*) rl_grow_array(NULL, candidates, &candidates_cap, sizeof(*candidates), (size_t) map.width * map.height);
+    if (memory == NULL) status = RL_ErrorMemory;
+    else candidates = memory;
+    for (unsigned int ty = 0; ty < map.height && status == RL_OK; ++ty) {
+        for (unsigned int tx = 0; tx < map.width; ++tx) {
+            size_t i = tx + ty * map.width;
+            float distance = distances.nodes[i].score;
+            if (distance == FLT_MAX || distance == 0) continue;
+            if (f && !f(map, context, tx, ty)) continue;
+            candidates[candidates_len].score = distance;
+            candidates[candidates_len++].index = i;
+        }
+    }
+    if (status == RL_OK && candidates_len == 0) status = RL_ErrorNotFound;
+    if (status == RL_OK) {
+        /* random rank within the percentiles, then select the candidate with that rank */
+        lo = (size_t) ((candidates_len - 1) * (min_percentile < 0 ? 0 : min_percentile > 1 ? 1 : min_percentile));
+        hi = (size_t) ((candidates_len - 1) * (max_percentile < 0 ? 0 : max_percentile > 1 ? 1 : max_percentile));
+        rank = lo + (size_t) ((double) RL_RNG_F(0, 32766) / 32767 * (hi - lo + 1));
+        rl_place_select(candidates, candidates_len, rank);
+        *x = candidates[rank].index % map.width;
+        *y = candidates[rank].index / map.width;
+    }
+    rl_graph_destroy(distances);
+    if (candidates) rl_free(NULL, candidates);
 
-    return next;
+    return status;
 }
 
-void rl_path_destroy(RL_Path *path)
+size_t rl_rng_map_spread(RL_Map map, RL_Point start, void *context, RL_MatchesFun f, RL_Point *points, size_t count)
 {
-    if (path) {
-        while ((path = rl_path_walk(path))) {}
+    RL_ScoredIndex *open = NULL;
+    size_t open_cap = 0, placed = 0;
+    RL_Graph graph;
+    RL_ASSERT(map.tiles != NULL && points != NULL);
+    if (map.tiles == NULL || points == NULL) return 0;
+    RL_ASSERT(rl_map_in_bounds(map, start.x, start.y));
+    if (!rl_map_in_bounds(map, start.x, start.y)) return 0;
+    graph = rl_place_distances(map, start, &open, &open_cap);
+    while (graph.nodes != NULL && placed < count) {
+        size_t farthest = 0, ties = 0, pick;
+        for (unsigned int ty = 0; ty < map.height; ++ty) {
+            for (unsigned int tx = 0; tx < map.width; ++tx) {
+                size_t i = tx + ty * map.width;
+                if (graph.nodes[i].score == FLT_MAX || graph.nodes[i].score == 0) continue;
+                if (ties && graph.nodes[i].score < graph.nodes[farthest].score) continue;
+                if (f && !f(map, context, tx, ty)) continue;
+                if (ties == 0 || graph.nodes[i].score > graph.nodes[farthest].score) {
+                    farthest = i;
+                    ties = 1;
+                } else {
+                    ties++;
+                }
+            }
+        }
+        if (ties == 0) break;
+        if (ties > 1) {
+            /* pick a tie with a single draw bounded below RAND_MAX (32767 on MSVC) - scaled when there are more ties
+             * than that - then find it with a second scan from the first tie */
+            pick = ties < 32767 ? RL_RNG_F(0, (unsigned int) ties - 1) : (size_t) ((double) RL_RNG_F(0, 32766) / 32767 * ties);
+            for (size_t i = farthest; i < (size_t) map.width * map.height; ++i) {
+                if (graph.nodes[i].score != graph.nodes[farthest].score) continue;
+                if (f && !f(map, context, i % map.width, i / map.width)) continue;
+                if (pick-- == 0) {
+                    farthest = i;
+                    break;
+                }
+            }
+        }
+        points[placed++] = rl_point(farthest % map.width, farthest / map.width);
+        if (rl_place_relax(map, graph, &open, &open_cap, farthest) != RL_OK) break;
     }
+    if (graph.nodes) rl_graph_destroy(graph);
+    if (open) rl_free(NULL, open);
+
+    return placed;
 }
 
 size_t rl_neighbors_default_fn(const RL_Graph graph, const RL_Map map, RL_Point point, RL_GraphNode **neighbors, bool allow_diagonal_neighbors, bool only_passable_neighbors)
@@ -2713,7 +7719,12 @@ size_t rl_graph_neighbors_axial_passable(void *context, RL_Point point, RL_Graph
 
 RL_Graph rl_graph_create_scored(const RL_Map map, RL_Point start, RL_ScoreFun score_f, RL_NeighborsFun neighbors_f)
 {
-    RL_Graph graph = rl_graph_create_from_map(map, neighbors_f);
+    return rl_graph_create_scored_ex(map, start, score_f, neighbors_f, NULL);
+}
+
+RL_Graph rl_graph_create_scored_ex(const RL_Map map, RL_Point start, RL_ScoreFun score_f, RL_NeighborsFun neighbors_f, const RL_Allocator *allocator)
+{
+    RL_Graph graph = rl_graph_create_from_map_ex(map, neighbors_f, allocator);
     rl_graph_score(graph, map, start, score_f);
 
     return graph;
@@ -2721,14 +7732,24 @@ RL_Graph rl_graph_create_scored(const RL_Map map, RL_Point start, RL_ScoreFun sc
 
 RL_Graph rl_graph_create_from_map(const RL_Map map, RL_NeighborsFun neighbors_f)
 {
-    return rl_graph_create(map.width, map.height, neighbors_f);
+    return rl_graph_create_from_map_ex(map, neighbors_f, NULL);
+}
+
+RL_Graph rl_graph_create_from_map_ex(const RL_Map map, RL_NeighborsFun neighbors_f, const RL_Allocator *allocator)
+{
+    return rl_graph_create_ex(map.width, map.height, neighbors_f, allocator);
 }
 
 RL_Graph rl_graph_create(unsigned int map_width, unsigned int map_height, RL_NeighborsFun neighbors_f)
+{
+    return rl_graph_create_ex(map_width, map_height, neighbors_f, NULL);
+}
+
+RL_Graph rl_graph_create_ex(unsigned int map_width, unsigned int map_height, RL_NeighborsFun neighbors_f, const RL_Allocator *allocator)
 {
     RL_Graph graph = {0};
     size_t length = map_width * map_height;
-    RL_GraphNode *nodes = (RL_GraphNode*) RL_CALLOC(length, sizeof(*nodes));
+    RL_GraphNode *nodes = (RL_GraphNode*) rl_calloc(allocator, length, sizeof(*nodes));
     RL_ASSERT(nodes != NULL);
     if (nodes == NULL) {
         return graph;
@@ -2748,6 +7769,7 @@ RL_Graph rl_graph_create(unsigned int map_width, unsigned int map_height, RL_Nei
     graph.length = length;
     graph.nodes = nodes;
     graph.neighbors = neighbors_f;
+    graph.allocator = allocator;
 
     return graph;
 }
@@ -2803,6 +7825,60 @@ RL_GraphContext rl_graph_context(const RL_Graph graph, const RL_Map map)
     };
 }
 
+RL_OccupancyContext rl_occupancy_context(const RL_Graph graph, const RL_Map map, const RL_Occupancy *occupancy, int mover, float occupied_cost)
+{
+    return (RL_OccupancyContext) {
+        .graph_context = rl_graph_context(graph, map),
+        .occupancy = occupancy,
+        .mover = mover,
+        .occupied_cost = occupied_cost,
+    };
+}
+
+float rl_graph_score_occupancy(void *context, const RL_GraphNode *current, const RL_GraphNode *neighbor)
+{
+    RL_OccupancyContext *occupancy_context = (RL_OccupancyContext*) context;
+    RL_ASSERT(occupancy_context != NULL && occupancy_context->occupancy != NULL);
+    if (occupancy_context == NULL || occupancy_context->occupancy == NULL) return FLT_MAX;
+    const RL_Occupancy *occupancy = occupancy_context->occupancy;
+    unsigned int x = neighbor->point.x, y = neighbor->point.y;
+    unsigned int count = rl_occupancy_count(occupancy, x, y);
+    int mover = occupancy_context->mover;
+    if (mover >= 0 && mover < occupancy->capacity && occupancy->entities[mover].prev != RL_OCCUPANCY_NOT_INSERTED &&
+        occupancy->entities[mover].x == x && occupancy->entities[mover].y == y) {
+        count--;
+    }
+    float score = rl_graph_score_simple(context, current, neighbor);
+    if (count == 0) return score;
+    if (occupancy_context->occupied_cost == FLT_MAX) return FLT_MAX;
+
+    return score + occupancy_context->occupied_cost * count;
+}
+
+RL_Path *rl_path_create_occupancy(const RL_Map map, const RL_Occupancy *occupancy, RL_Point start, RL_Point end, int mover, float occupied_cost)
+{
+    return rl_path_create_occupancy_ex(map, occupancy, start, end, mover, occupied_cost, NULL);
+}
+
+RL_Path *rl_path_create_occupancy_ex(const RL_Map map, const RL_Occupancy *occupancy, RL_Point start, RL_Point end, int mover, float occupied_cost, const RL_Allocator *allocator)
+{
+    RL_ASSERT(occupancy != NULL);
+    if (occupancy == NULL) return NULL;
+    RL_Graph graph = rl_graph_create_ex(map.width, map.height, NULL, allocator);
+    RL_ASSERT(graph.nodes);
+    if (graph.nodes == NULL) return NULL;
+    RL_TRACE_BEGIN("rl_path_create_occupancy");
+    /* scored from the end, so the end is reachable even when occupied */
+    RL_OccupancyContext context = rl_occupancy_context(graph, map, occupancy, mover, occupied_cost);
+    rl_graph_score_with_context(graph, &context, end, rl_graph_score_occupancy);
+    RL_Path *path = rl_path_create_from_graph(graph, map, start);
+    RL_TRACE_END("rl_path_create_occupancy");
+    RL_ASSERT(path);
+    rl_graph_destroy(graph);
+
+    return path;
+}
+
 void rl_graph_score(RL_Graph graph, const RL_Map map, RL_Point start, RL_ScoreFun score_f)
 {
     RL_GraphContext context = rl_graph_context(graph, map);
@@ -2821,50 +7897,114 @@ void rl_graph_score_with_context(RL_Graph graph, void *context, RL_Point start,
 {
     RL_ASSERT(graph.nodes != NULL && graph.length > 0);
     if (graph.nodes == NULL || graph.length == 0) return;
-    if (graph.neighbors == NULL) {
-        graph.neighbors = rl_graph_neighbors_ordinal_passable;
-    }
-    if (score_f == NULL) {
-        score_f = rl_graph_score_simple;
-    }
-
-    RL_GraphNode *current;
-    RL_Heap *heap = rl_heap_create(graph.length, &rl_scored_graph_heap_comparison);
 
     /* reset scores of dijkstra map, setting the start point to 0 */
+    bool found = false;
     for (size_t i=0; i < graph.length; i++) {
         RL_GraphNode *node = &graph.nodes[i];
         if (node->point.x == start.x && node->point.y == start.y) {
             node->score = 0;
-            current = node;
+            found = true;
         } else {
             node->score = FLT_MAX;
         }
     }
 
-    RL_ASSERT(current != NULL);
-    if (current == NULL) return;
+    RL_ASSERT(found);
+    if (!found) return;
+
+    rl_graph_score_seeded(graph, context, score_f);
+}
+
+void rl_graph_score_seeded(RL_Graph graph, void *context, RL_ScoreFun score_f)
+{
+    RL_GraphScorer scorer;
+    if (rl_graph_scorer_begin(&scorer, graph, context, score_f) != RL_OK) return;
+    rl_graph_scorer_step(&scorer, (size_t) -1);
+}
+
+RL_Status rl_graph_scorer_begin(RL_GraphScorer *scorer, RL_Graph graph, void *context, RL_ScoreFun score_f)
+{
+    RL_ASSERT(scorer != NULL);
+    if (scorer == NULL) return RL_ErrorNullParameter;
+    memset(scorer, 0, sizeof(*scorer));
+    RL_ASSERT(graph.nodes != NULL && graph.length > 0);
+    if (graph.nodes == NULL || graph.length == 0) return RL_ErrorNullParameter;
+    if (graph.neighbors == NULL) {
+        graph.neighbors = rl_graph_neighbors_ordinal_passable;
+    }
+    scorer->graph = graph;
+    scorer->context = context;
+    scorer->score_f = score_f ? score_f : rl_graph_score_simple;
+    scorer->open = rl_heap_create_ex(graph.length, &rl_scored_graph_heap_comparison, graph.allocator);
+    RL_ASSERT(scorer->open != NULL);
+    if (scorer->open == NULL) return RL_ErrorMemory;
+    /* collect the seeds so a multi-source graph is heapified in O(n) rather than inserted one by one */
+    size_t seed_count = 0;
+    for (size_t i=0; i < graph.length; i++) {
+        if (graph.nodes[i].score < FLT_MAX) seed_count++;
+    }
+    if (seed_count == 0) return RL_OK;
+    void **seeds = (void**) rl_malloc(graph.allocator, sizeof(*seeds) * seed_count);
+    RL_ASSERT(seeds != NULL && seed_count <= INT_MAX);
+    if (seeds == NULL || seed_count > INT_MAX) {
+        if (seeds) rl_free(graph.allocator, seeds);
+        rl_graph_scorer_end(scorer);
+        return RL_ErrorMemory;
+    }
+    seed_count = 0;
+    for (size_t i=0; i < graph.length; i++) {
+        if (graph.nodes[i].score < FLT_MAX) seeds[seed_count++] = &graph.nodes[i];
+    }
+    bool inserted = rl_heap_insert_bulk(scorer->open, seeds, (int) seed_count);
+    rl_free(graph.allocator, seeds);
+    if (!inserted) {
+        scorer->open = NULL; /* rl_heap_insert_bulk destroys the heap when it fails to grow */
+        return RL_ErrorMemory;
+    }
+
+    return RL_OK;
+}
+
+bool rl_graph_scorer_step(RL_GraphScorer *scorer, size_t max_expansions)
+{
+    RL_ASSERT(scorer != NULL);
+    if (scorer == NULL) return true;
+    if (scorer->open == NULL) return true;
 
-    rl_heap_insert(heap, (void*) current);
-    current = (RL_GraphNode*) rl_heap_pop(heap);
-    while (current) {
+    RL_TRACE_BEGIN("rl_graph_score");
+    for (size_t expansions = 0; expansions < max_expansions && rl_heap_length(scorer->open) > 0; ++expansions) {
+        RL_GraphNode *current = (RL_GraphNode*) rl_heap_pop(scorer->open);
         RL_GraphNode *neighbors[RL_MAX_NEIGHBOR_COUNT];
-        size_t neighbors_count = graph.neighbors(context, current->point, neighbors);
+        size_t neighbors_count = scorer->graph.neighbors(scorer->context, current->point, neighbors);
+        RL_STATS_ADD(dijkstra_expansions, 1);
+        scorer->expansions++;
         for (size_t i=0; i<neighbors_count; i++) {
             RL_GraphNode *neighbor = neighbors[i];
-            float distance = score_f(context, current, neighbor);
+            float distance = scorer->score_f(scorer->context, current, neighbor);
             if (distance < neighbor->score) {
                 if (neighbor->score == FLT_MAX) {
-                    rl_heap_insert(heap, neighbor);
+                    rl_heap_insert(scorer->open, neighbor);
                 }
                 neighbor->score = distance;
             }
         }
-
-        current = (RL_GraphNode *) rl_heap_pop(heap);
     }
+    RL_TRACE_END("rl_graph_score");
+    if (rl_heap_length(scorer->open) > 0) return false;
+    rl_graph_scorer_end(scorer);
 
-    rl_heap_destroy(heap);
+    return true;
+}
+
+void rl_graph_scorer_end(RL_GraphScorer *scorer)
+{
+    RL_ASSERT(scorer != NULL);
+    if (scorer == NULL) return;
+    if (scorer->open) {
+        rl_heap_destroy(scorer->open);
+        scorer->open = NULL;
+    }
 }
 
 void rl_graph_convert_to_axial(RL_Graph graph)
@@ -2892,7 +8032,7 @@ void rl_graph_reset(RL_Graph graph)
 void rl_graph_destroy(RL_Graph graph)
 {
     if (graph.nodes) {
-        RL_FREE(graph.nodes);
+        rl_free(graph.allocator, graph.nodes);
     }
 }
 
@@ -2999,13 +8139,18 @@ void rl_graph_node_sort_neighbors(RL_GraphNode **neighbors, size_t neighbors_cou
 
 #if RL_ENABLE_FOV
 RL_FOV rl_fov_create(unsigned int width, unsigned int height)
+{
+    return rl_fov_create_ex(width, height, NULL);
+}
+
+RL_FOV rl_fov_create_ex(unsigned int width, unsigned int height, const RL_Allocator *allocator)
 {
     RL_FOV fov = {0};
     unsigned char *memory;
     RL_ASSERT(width > 0 && height > 0);
     RL_ASSERT(width != UINT_MAX && !(width > UINT_MAX / height)); /* check for overflow */
     /* allocate all the memory we need at once */
-    memory = (unsigned char*) RL_CALLOC(sizeof(*fov.visibility)*width*height, 1);
+    memory = (unsigned char*) rl_calloc(allocator, sizeof(*fov.visibility)*width*height, 1);
     RL_ASSERT(memory != NULL);
     if (memory == NULL) return fov;
     fov.width = width;
@@ -3016,9 +8161,14 @@ RL_FOV rl_fov_create(unsigned int width, unsigned int height)
 }
 
 void rl_fov_destroy(RL_FOV fov)
+{
+    rl_fov_destroy_ex(fov, NULL);
+}
+
+void rl_fov_destroy_ex(RL_FOV fov, const RL_Allocator *allocator)
 {
     if (fov.visibility) {
-        RL_FREE(fov.visibility);
+        rl_free(allocator, fov.visibility);
     }
 }
 
@@ -3029,13 +8179,14 @@ typedef struct {
 
 /* adapted from: https://www.adammil.net/blog/v125_Roguelike_Vision_Algorithms.html#shadowcode (public domain) */
 /* also see: https://www.roguebasin.com/index.php/FOV_using_recursive_shadowcasting */
-RL_Status rl_fov_calculate_recursive(void *map, unsigned int origin_x, unsigned int origin_y, RL_IsInRangeFun in_range_f, RL_IsOpaqueFun opaque_f, RL_MarkAsVisibleFun mark_visible_f, unsigned int octant, float original_x, RL_Slope top, RL_Slope bottom)
+/* scans the columns of the octant up to max_x - a column only depends on the columns before it */
+static RL_Status rl_fov_scan(void *map, unsigned int origin_x, unsigned int origin_y, RL_IsInRangeFun in_range_f, RL_IsOpaqueFun opaque_f, RL_MarkAsVisibleFun mark_visible_f, unsigned int octant, float original_x, RL_Slope top, RL_Slope bottom, int max_x)
 {
     int x;
     RL_ASSERT(in_range_f);
     RL_ASSERT(opaque_f);
     RL_ASSERT(mark_visible_f);
-    for(x = original_x; x < RL_MAX_RECURSION; x++)
+    for(x = original_x; x < RL_MAX_RECURSION && x <= max_x; x++)
     {
         /* compute the Y coordinates where the top vector leaves the column (on the right) and where the bottom vector */
         /* enters the column (on the left). this equals (x+0.5)*top+0.5 and (x-0.5)*bottom+0.5 respectively, which can */
@@ -3061,6 +8212,7 @@ RL_Status rl_fov_calculate_recursive(void *map, unsigned int origin_x, unsigned
                 case 7: tx += x; ty += y; break;
             }
 
+            RL_STATS_ADD(fov_cells_visited, 1);
             inRange = in_range_f(tx, ty, map);
             if(inRange) {
                 if (RL_FOV_SYMMETRIC && (y != topY || top.Y*(int)x >= top.X*y) && (y != bottomY || bottom.Y*(int)x <= bottom.X*y)) {
@@ -3083,7 +8235,11 @@ RL_Status rl_fov_calculate_recursive(void *map, unsigned int origin_x, unsigned
                     newBottom.Y = y*2 + 1; /* (x*2-1, y*2+1) is a vector to the top-left of the opaque tile */
                     newBottom.X = x*2 - 1;
                     if(!inRange || y == bottomY) { bottom = newBottom; break; } /* don't recurse unless we have to */
-                    else if (inRange) rl_fov_calculate_recursive(map, origin_x, origin_y, in_range_f, opaque_f, mark_visible_f, octant, x+1, top, newBottom);
+                    else if (inRange) {
+                        RL_STATS_PUSH_DEPTH();
+                        rl_fov_scan(map, origin_x, origin_y, in_range_f, opaque_f, mark_visible_f, octant, x+1, top, newBottom, max_x);
+                        RL_STATS_POP_DEPTH();
+                    }
                 }
                 wasOpaque = 1;
             }
@@ -3102,7 +8258,12 @@ RL_Status rl_fov_calculate_recursive(void *map, unsigned int origin_x, unsigned
         }
     }
 
-    return RL_ErrorRecursion;
+    return x > max_x ? RL_OK : RL_ErrorRecursion;
+}
+
+RL_Status rl_fov_calculate_recursive(void *map, unsigned int origin_x, unsigned int origin_y, RL_IsInRangeFun in_range_f, RL_IsOpaqueFun opaque_f, RL_MarkAsVisibleFun mark_visible_f, unsigned int octant, float original_x, RL_Slope top, RL_Slope bottom)
+{
+    return rl_fov_scan(map, origin_x, origin_y, in_range_f, opaque_f, mark_visible_f, octant, original_x, top, bottom, RL_MAX_RECURSION);
 }
 
 struct RL_FOVMap {
@@ -3180,12 +8341,137 @@ RL_Status rl_fov_calculate_ex(void *context, unsigned int x, unsigned int y, RL_
     RL_Status status = RL_OK;
     RL_Slope from = { 1, 1 };
     RL_Slope to = { 0, 1 };
+    RL_TRACE_BEGIN("rl_fov_calculate");
     mark_visible_f(x, y, context);
     for (octant=0; octant<8; ++octant) {
-        RL_Status r = rl_fov_calculate_recursive(context, x, y, in_range_f, opaque_f, mark_visible_f, octant, 1, from, to);
+        RL_Status r;
+        RL_STATS_PUSH_DEPTH();
+        r = rl_fov_calculate_recursive(context, x, y, in_range_f, opaque_f, mark_visible_f, octant, 1, from, to);
+        RL_STATS_POP_DEPTH();
         if (r != RL_OK)
             status = r;
     }
+    RL_TRACE_END("rl_fov_calculate");
+
+    return status;
+}
+
+/* marks the visible tiles within a box around the targets */
+struct RL_FOVQuery {
+    struct RL_FOVMap fovmap; /* first so the query can be passed to the RL_FOVMap functions */
+    unsigned int x, y, width, height;
+    RL_Byte *marks;
+};
+
+static void rl_fovquery_mark_visible_f(unsigned int x, unsigned int y, void *context)
+{
+    struct RL_FOVQuery *query = (struct RL_FOVQuery*) context;
+    if (x >= query->x && y >= query->y && x - query->x < query->width && y - query->y < query->height) {
+        query->marks[(x - query->x) + (y - query->y) * query->width] = 1;
+    }
+}
+
+/* column of the target within the octant, or 0 if the octant doesn't hold the target (see rl_fov_scan) */
+static int rl_fov_octant_column(unsigned int octant, int dx, int dy)
+{
+    int x, y;
+    switch (octant) {
+        case 0: x = dx; y = -dy; break;
+        case 1: x = -dy; y = dx; break;
+        case 2: x = -dy; y = -dx; break;
+        case 3: x = -dx; y = -dy; break;
+        case 4: x = -dx; y = dy; break;
+        case 5: x = dy; y = -dx; break;
+        case 6: x = dy; y = dx; break;
+        default: x = dx; y = dy; break;
+    }
+
+    return x >= 1 && y >= 0 && y <= x ? x : 0;
+}
+
+/* scans the octants holding the targets, up to the farthest target column in each */
+static RL_Status rl_fov_query(struct RL_FOVQuery *query, const RL_Point *targets, size_t count)
+{
+    RL_Slope from = { 1, 1 };
+    RL_Slope to = { 0, 1 };
+    RL_Status status = RL_OK;
+    unsigned int octant;
+    size_t i;
+    rl_fovquery_mark_visible_f(query->fovmap.origin_x, query->fovmap.origin_y, query);
+    for (octant = 0; octant < 8; ++octant) {
+        int max_x = 0;
+        for (i = 0; i < count; ++i) {
+            int column = rl_fov_octant_column(octant, (int) targets[i].x - (int) query->fovmap.origin_x, (int) targets[i].y - (int) query->fovmap.origin_y);
+            if (column > max_x) max_x = column;
+        }
+        if (max_x > 0) {
+            RL_Status r = rl_fov_scan(query, query->fovmap.origin_x, query->fovmap.origin_y, rl_fovmap_in_range_f, rl_fovmap_opaque_f, rl_fovquery_mark_visible_f, octant, 1, from, to, max_x);
+            if (r != RL_OK) status = r;
+        }
+    }
+
+    return status;
+}
+
+bool rl_fov_can_see(const RL_Map map, unsigned int x, unsigned int y, unsigned int target_x, unsigned int target_y, int fov_radius)
+{
+    struct RL_FOVQuery query;
+    RL_Byte mark = 0;
+    RL_Point target;
+    RL_ASSERT(map.tiles != NULL);
+    if (map.tiles == NULL || !rl_map_in_bounds(map, x, y) || !rl_map_in_bounds(map, target_x, target_y)) return false;
+    query.fovmap.map = map;
+    query.fovmap.origin_x = x;
+    query.fovmap.origin_y = y;
+    query.fovmap.fov_radius = fov_radius;
+    query.x = target_x;
+    query.y = target_y;
+    query.width = query.height = 1;
+    query.marks = &mark;
+    target.x = target_x;
+    target.y = target_y;
+    rl_fov_query(&query, &target, 1);
+
+    return mark != 0;
+}
+
+RL_Status rl_fov_can_see_many(const RL_Map map, unsigned int x, unsigned int y, int fov_radius, const RL_Point *targets, size_t count, bool *visible)
+{
+    struct RL_FOVQuery query;
+    RL_Status status;
+    unsigned int max_x, max_y;
+    size_t i;
+    RL_ASSERT(map.tiles != NULL && (count == 0 || (targets != NULL && visible != NULL)));
+    if (map.tiles == NULL || (count > 0 && (targets == NULL || visible == NULL))) return RL_ErrorNullParameter;
+    if (!rl_map_in_bounds(map, x, y)) return RL_ErrorInvalidParameter;
+    /* box around the origin & the targets on the map */
+    query.x = max_x = x;
+    query.y = max_y = y;
+    for (i = 0; i < count; ++i) {
+        visible[i] = false;
+        if (!rl_map_in_bounds(map, targets[i].x, targets[i].y)) continue;
+        if (targets[i].x < query.x) query.x = targets[i].x;
+        if (targets[i].y < query.y) query.y = targets[i].y;
+        if (targets[i].x > max_x) max_x = targets[i].x;
+        if (targets[i].y > max_y) max_y = targets[i].y;
+    }
+    query.width = max_x - query.x + 1;
+    query.height = max_y - query.y + 1;
+    query.marks = (RL_Byte*) rl_calloc(NULL, (size_t) query.width * query.height, sizeof(*query.marks));
+    RL_ASSERT(query.marks != NULL);
+    if (query.marks == NULL) return RL_ErrorMemory;
+    query.fovmap.map = map;
+    query.fovmap.origin_x = x;
+    query.fovmap.origin_y = y;
+    query.fovmap.fov_radius = fov_radius;
+    RL_TRACE_BEGIN("rl_fov_can_see_many");
+    status = rl_fov_query(&query, targets, count);
+    for (i = 0; i < count; ++i) {
+        if (!rl_map_in_bounds(map, targets[i].x, targets[i].y)) continue;
+        visible[i] = query.marks[((unsigned int) targets[i].x - query.x) + ((unsigned int) targets[i].y - query.y) * query.width] != 0;
+    }
+    RL_TRACE_END("rl_fov_can_see_many");
+    rl_free(NULL, query.marks);
 
     return status;
 }
@@ -3207,6 +8493,269 @@ bool rl_fov_is_seen(const RL_FOV map, unsigned int x, unsigned int y)
     }
     return map.visibility[x + y*map.width] == RL_TileSeen;
 }
+
+#if RL_ENABLE_PATHFINDING
+/* frontier - a known passable tile next to an unknown passable tile */
+static bool rl_explore_is_frontier(const RL_Explore *explore, unsigned int x, unsigned int y)
+{
+    int dx, dy;
+    if (!explore->known[x + y*explore->map.width] || !RL_PASSABLE_F(explore->map, x, y)) return false;
+    for (dy = -1; dy <= 1; ++dy) {
+        for (dx = -1; dx <= 1; ++dx) {
+            unsigned int nx = x + dx, ny = y + dy;
+            if (!rl_map_in_bounds(explore->map, nx, ny)) continue;
+            if (!explore->known[nx + ny*explore->map.width] && RL_PASSABLE_F(explore->map, nx, ny)) return true;
+        }
+    }
+
+    return false;
+}
+
+/* adds or removes the tile from the frontier set */
+static void rl_explore_refresh(RL_Explore *explore, unsigned int x, unsigned int y)
+{
+    size_t idx = x + y*explore->map.width;
+    bool frontier = rl_explore_is_frontier(explore, x, y);
+    if (frontier && explore->frontier_index[idx] < 0) {
+        explore->frontier_index[idx] = explore->frontier_length;
+        explore->frontier[explore->frontier_length++] = idx;
+    } else if (!frontier && explore->frontier_index[idx] >= 0) {
+        size_t last = explore->frontier[--explore->frontier_length];
+        explore->frontier[explore->frontier_index[idx]] = last;
+        explore->frontier_index[last] = explore->frontier_index[idx];
+        explore->frontier_index[idx] = -1;
+    }
+}
+
+RL_Explore *rl_explore_create(const RL_Map map, const RL_FOV fov, RL_ScoreFun score_f, RL_NeighborsFun neighbors_f)
+{
+    return rl_explore_create_ex(map, fov, score_f, neighbors_f, NULL);
+}
+
+RL_Explore *rl_explore_create_ex(const RL_Map map, const RL_FOV fov, RL_ScoreFun score_f, RL_NeighborsFun neighbors_f, const RL_Allocator *allocator)
+{
+    RL_Explore *explore;
+    size_t length = (size_t) map.width * map.height, i;
+    RL_ASSERT(map.tiles != NULL && fov.visibility != NULL && map.width == fov.width && map.height == fov.height);
+    if (map.tiles == NULL || fov.visibility == NULL || map.width != fov.width || map.height != fov.height) return NULL;
+    explore = (RL_Explore*) rl_calloc(allocator, 1, sizeof(*explore));
+    RL_ASSERT(explore);
+    if (explore == NULL) return NULL;
+    explore->allocator = allocator;
+    explore->map = map;
+    explore->fov = fov;
+    explore->known = (RL_Byte*) rl_calloc(allocator, length, sizeof(*explore->known));
+    explore->frontier_index = (int*) rl_malloc(allocator, sizeof(*explore->frontier_index) * length);
+    explore->frontier = (size_t*) rl_malloc(allocator, sizeof(*explore->frontier) * length);
+    explore->graph = rl_graph_create_ex(map.width, map.height, neighbors_f, allocator);
+    explore->score_f = score_f ? score_f : rl_graph_score_simple;
+    explore->visited = (unsigned int*) rl_calloc(allocator, length, sizeof(*explore->visited));
+    if (explore->known == NULL || explore->frontier_index == NULL || explore->frontier == NULL ||
+            explore->graph.nodes == NULL || explore->visited == NULL) {
+        rl_explore_destroy(explore);
+        return NULL;
+    }
+    for (i = 0; i < length; ++i) {
+        explore->frontier_index[i] = -1;
+    }
+    rl_explore_update(explore, 0, 0, -1);
+
+    return explore;
+}
+
+void rl_explore_destroy(RL_Explore *explore)
+{
+    if (explore == NULL) return;
+    if (explore->known) rl_free(explore->allocator, explore->known);
+    if (explore->frontier_index) rl_free(explore->allocator, explore->frontier_index);
+    if (explore->frontier) rl_free(explore->allocator, explore->frontier);
+    if (explore->graph.nodes) rl_graph_destroy(explore->graph);
+    if (explore->visited) rl_free(explore->allocator, explore->visited);
+    if (explore->open) rl_free(explore->allocator, explore->open);
+    rl_free(explore->allocator, explore);
+}
+
+RL_Status rl_explore_update(RL_Explore *explore, unsigned int x, unsigned int y, int fov_radius)
+{
+    unsigned int min_x = 0, min_y = 0, max_x, max_y, cur_x, cur_y;
+    RL_ASSERT(explore != NULL);
+    if (explore == NULL) return RL_ErrorNullParameter;
+    max_x = explore->map.width - 1;
+    max_y = explore->map.height - 1;
+    if (fov_radius >= 0) {
+        if (!rl_map_in_bounds(explore->map, x, y)) return RL_ErrorInvalidParameter;
+        if (x > (unsigned int) fov_radius) min_x = x - fov_radius;
+        if (y > (unsigned int) fov_radius) min_y = y - fov_radius;
+        if (x + fov_radius < max_x) max_x = x + fov_radius;
+        if (y + fov_radius < max_y) max_y = y + fov_radius;
+    }
+    /* mark the newly seen tiles with 2, then refresh the frontier around them */
+    for (cur_y = min_y; cur_y <= max_y; ++cur_y) {
+        for (cur_x = min_x; cur_x <= max_x; ++cur_x) {
+            size_t idx = cur_x + cur_y*explore->map.width;
+            if (!explore->known[idx] && explore->fov.visibility[idx] != RL_TileCannotSee) explore->known[idx] = 2;
+        }
+    }
+    for (cur_y = min_y; cur_y <= max_y; ++cur_y) {
+        for (cur_x = min_x; cur_x <= max_x; ++cur_x) {
+            int dx, dy;
+            if (explore->known[cur_x + cur_y*explore->map.width] != 2) continue;
+            explore->known[cur_x + cur_y*explore->map.width] = 1;
+            for (dy = -1; dy <= 1; ++dy) {
+                for (dx = -1; dx <= 1; ++dx) {
+                    if (rl_map_in_bounds(explore->map, cur_x + dx, cur_y + dy)) rl_explore_refresh(explore, cur_x + dx, cur_y + dy);
+                }
+            }
+        }
+    }
+
+    return RL_OK;
+}
+
+typedef struct {
+    RL_Explore *explore;
+    size_t target;
+    RL_Point *next;
+    bool found;
+} RL_ExploreSearch;
+
+static bool rl_explore_settle(void *user, size_t index, float distance)
+{
+    RL_ExploreSearch *search = (RL_ExploreSearch*) user;
+    RL_UNUSED(distance);
+    if (index != search->target) return true;
+    search->found = true;
+
+    return false;
+}
+
+static bool rl_explore_enter(void *user, size_t from, size_t to)
+{
+    RL_ExploreSearch *search = (RL_ExploreSearch*) user;
+    RL_Map map = search->explore->map;
+    if (!search->explore->known[to]) return false;
+    /* searching backwards - the tile relaxing the player is the next step */
+    if (to == search->target) *search->next = rl_point(from % map.width, from / map.width);
+
+    return true;
+}
+
+RL_Status rl_explore_next(RL_Explore *explore, RL_Point from, RL_Point *next)
+{
+    RL_Map map;
+    RL_GraphContext context;
+    RL_GraphNode *neighbors[RL_MAX_NEIGHBOR_COUNT];
+    RL_ExploreSearch search;
+    RL_ScoredRelax relax;
+    RL_Status status;
+    size_t i, target;
+    RL_ASSERT(explore != NULL && next != NULL);
+    if (explore == NULL || next == NULL) return RL_ErrorNullParameter;
+    map = explore->map;
+    if (!rl_map_in_bounds(map, from.x, from.y)) return RL_ErrorInvalidParameter;
+    target = (size_t) from.x + (size_t) from.y * map.width;
+    *next = from;
+    if (explore->frontier_length == 0) return RL_ErrorNotFound;
+    context = rl_graph_context(explore->graph, map);
+    if (explore->frontier_index[target] >= 0) {
+        /* already on the frontier - step into the unknown */
+        size_t count = explore->graph.neighbors(&context, explore->graph.nodes[target].point, neighbors);
+        for (i = 0; i < count; ++i) {
+            size_t n = (size_t) (neighbors[i] - explore->graph.nodes);
+            if (!explore->known[n]) {
+                *next = rl_point(n % map.width, n / map.width);
+                return RL_OK;
+            }
+        }
+    }
+
+    /* multi source Dijkstra from the frontier, stopping when the player is reached */
+    if (++explore->generation == 0) {
+        memset(explore->visited, 0, sizeof(*explore->visited) * map.width * map.height);
+        explore->generation = 1;
+    }
+    search.explore = explore;
+    search.target = target;
+    search.next = next;
+    search.found = false;
+    relax = (RL_ScoredRelax) {
+        .graph = explore->graph,
+        .context = &context,
+        .score_f = explore->score_f,
+        .visited = explore->visited,
+        .generation = explore->generation,
+        .max_distance = FLT_MAX,
+        .open = &explore->open,
+        .open_len = &explore->open_len,
+        .open_cap = &explore->open_cap,
+        .allocator = explore->allocator,
+        .settle_f = rl_explore_settle,
+        .enter_f = rl_explore_enter,
+        .user = &search,
+    };
+    explore->open_len = 0;
+    for (i = 0; i < explore->frontier_length; ++i) {
+        if (!rl_scored_relax_seed(&relax, explore->frontier[i])) return RL_ErrorMemory;
+    }
+    status = rl_scored_relax(&relax);
+    if (status != RL_OK) return status;
+    if (search.found) return RL_OK;
+    *next = from;
+
+    return RL_ErrorNotFound;
+}
+
+RL_Status rl_graph_score_approach(RL_Graph graph, RL_FOV fov, const RL_Map map, RL_Point target, float range)
+{
+    RL_GraphContext context;
+    RL_Status status;
+    unsigned int x, y;
+    RL_ASSERT(graph.nodes != NULL && fov.visibility != NULL && map.tiles != NULL);
+    if (graph.nodes == NULL || fov.visibility == NULL || map.tiles == NULL) return RL_ErrorNullParameter;
+    if (graph.length != (size_t) map.width * map.height || fov.width != map.width || fov.height != map.height) return RL_ErrorInvalidParameter;
+    if (!rl_map_in_bounds(map, target.x, target.y) || range < 1) return RL_ErrorInvalidParameter;
+    /* clear the FOV so tiles seen from a previous target aren't seeded */
+    memset(fov.visibility, RL_TileCannotSee, sizeof(*fov.visibility) * fov.width * fov.height);
+    status = rl_fov_calculate(fov, map, target.x, target.y, (int) ceilf(range));
+    if (status != RL_OK) return status;
+
+    rl_graph_reset(graph);
+    for (y = 0; y < map.height; ++y) {
+        for (x = 0; x < map.width; ++x) {
+            float distance;
+            if (!rl_fov_is_visible(fov, x, y) || !RL_PASSABLE_F(map, x, y)) continue;
+            if (x == target.x && y == target.y) continue;
+            distance = RL_FOV_DISTANCE_F(target, rl_point(x, y));
+            if (distance > range) continue;
+            graph.nodes[x + y*map.width].score = floorf(range - distance);
+        }
+    }
+    context = rl_graph_context(graph, map);
+    rl_graph_score_seeded(graph, &context, NULL);
+
+    return RL_OK;
+}
+
+RL_Graph rl_graph_create_approach(const RL_Map map, RL_Point target, float range)
+{
+    return rl_graph_create_approach_ex(map, target, range, NULL);
+}
+
+RL_Graph rl_graph_create_approach_ex(const RL_Map map, RL_Point target, float range, const RL_Allocator *allocator)
+{
+    RL_Graph graph = rl_graph_create_from_map_ex(map, NULL, allocator);
+    RL_FOV fov;
+    if (graph.nodes == NULL) return graph;
+    fov = rl_fov_create_ex(map.width, map.height, allocator);
+    if (fov.visibility == NULL || rl_graph_score_approach(graph, fov, map, target, range) != RL_OK) {
+        rl_graph_destroy(graph);
+        graph.nodes = NULL;
+    }
+    rl_fov_destroy_ex(fov, allocator);
+
+    return graph;
+}
+#endif /* RL_ENABLE_PATHFINDING */
 #endif /* if RL_ENABLE_FOV */
 
 #if RL_ENABLE_FILE
@@ -3230,6 +8779,11 @@ bool rl_file_save_map(const RL_Map data, void *file)
 }
 
 bool rl_file_load_map(RL_Map *data, void *file)
+{
+    return rl_file_load_map_ex(data, file, NULL);
+}
+
+bool rl_file_load_map_ex(RL_Map *data, void *file, const RL_Allocator *allocator)
 {
     int version;
     RL_Map dest;
@@ -3246,9 +8800,13 @@ bool rl_file_load_map(RL_Map *data, void *file)
         return false;
     }
     RL_ASSERT(dest.width > 0 && dest.height > 0);
-    dest.tiles = (RL_Byte*) malloc(sizeof(*dest.tiles) * dest.width * dest.height);
+    dest.tiles = (RL_Byte*) rl_malloc(allocator, sizeof(*dest.tiles) * dest.width * dest.height);
     RL_ASSERT(dest.tiles != NULL);
+    if (dest.tiles == NULL) {
+        return false;
+    }
     if (fread(dest.tiles, sizeof(*dest.tiles), dest.width * dest.height, (FILE*) file) < dest.width * dest.height) {
+        rl_free(allocator, dest.tiles);
         return false;
     }
 
@@ -3278,6 +8836,11 @@ bool rl_file_save_fov(const RL_FOV data, void *file)
 }
 
 bool rl_file_load_fov(RL_FOV *data, void *file)
+{
+    return rl_file_load_fov_ex(data, file, NULL);
+}
+
+bool rl_file_load_fov_ex(RL_FOV *data, void *file, const RL_Allocator *allocator)
 {
     int version;
     RL_FOV dest;
@@ -3294,9 +8857,13 @@ bool rl_file_load_fov(RL_FOV *data, void *file)
         return false;
     }
     RL_ASSERT(dest.width > 0 && dest.height > 0);
-    dest.visibility = (RL_Byte*) RL_MALLOC(sizeof(*dest.visibility) * dest.width * dest.height);
+    dest.visibility = (RL_Byte*) rl_malloc(allocator, sizeof(*dest.visibility) * dest.width * dest.height);
     RL_ASSERT(dest.visibility != NULL);
+    if (dest.visibility == NULL) {
+        return false;
+    }
     if (fread(dest.visibility, sizeof(*dest.visibility), dest.width * dest.height, (FILE*)file) < dest.width * dest.height) {
+        rl_free(allocator, dest.visibility);
         return false;
     }
 
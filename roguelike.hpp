@@ -0,0 +1,484 @@
+/**
+ * roguelike.hpp
+ *
+ * Optional C++17 layer for roguelike.h (see roguelike.h for the license).
+ *
+ * Provides RAII wrappers for the library structs (rl::Map, rl::Graph, rl::FOV & rl::BSP) along with templated
+ * versions of the Dijkstra, A* & FOV algorithms. The neighbor, cost & opaque policies are template parameters so they
+ * get inlined - passing a lambda costs the same as writing the loop by hand, unlike the function pointers in the C API.
+ *
+ * The wrappers own the same structs as the C API, so both can be mixed freely:
+ *
+ *  #define RL_IMPLEMENTATION // in one C or C++ file, as with roguelike.h
+ *  #include "roguelike.hpp"
+ *
+ *  rl::Map map(80, 25);
+ *  rl_mapgen_bsp(map, RL_MAPGEN_BSP_DEFAULTS);
+ *  rl::Graph graph(map.width(), map.height());
+ *  rl::dijkstra<rl::Ordinal>(graph, rl_point(x, y), rl::PassableCost(map));
+ *  RL_Path *path = rl_path_create_from_graph(graph, map, rl_point(player_x, player_y));
+ *
+ * Cost policies are called with (from_x, from_y, to_x, to_y) and return the cost to step between the two tiles, or
+ * rl::unreachable if the step isn't allowed. Neighbor policies are called with (x, y, visit) and call visit(x, y) for
+ * each neighbor - out of bounds neighbors are skipped by the algorithms.
+ */
+#ifndef RL_ROGUELIKE_HPP
+#define RL_ROGUELIKE_HPP
+
+#include "roguelike.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#ifndef RL_ASSERT
+#include <cassert>
+#define RL_ASSERT(expr) (assert(expr));
+#endif
+#ifndef RL_MAX_RECURSION
+#define RL_MAX_RECURSION 100
+#endif
+#ifndef RL_FOV_SYMMETRIC
+#define RL_FOV_SYMMETRIC 1
+#endif
+
+namespace rl {
+
+/* Cost of an unreachable tile (same as an unscored node in RL_Graph). */
+constexpr float unreachable = FLT_MAX;
+
+/**
+ * RAII wrappers - these are move only & convert implicitly to the wrapped struct so they can be passed to the C API.
+ * Check for allocation failure with operator bool.
+ */
+
+class Map {
+public:
+    Map() : map_(), allocator_(nullptr) {}
+    Map(unsigned int width, unsigned int height, const RL_Allocator *allocator = nullptr)
+        : map_(rl_map_create_ex(width, height, allocator)), allocator_(allocator) {}
+    ~Map() { if (map_.tiles) rl_map_destroy_ex(map_, allocator_); }
+    Map(const Map&) = delete;
+    Map &operator=(const Map&) = delete;
+    Map(Map &&other) noexcept : map_(std::exchange(other.map_, RL_Map())), allocator_(other.allocator_) {}
+    Map &operator=(Map &&other) noexcept
+    {
+        std::swap(map_, other.map_);
+        std::swap(allocator_, other.allocator_);
+        return *this;
+    }
+
+    explicit operator bool() const { return map_.tiles != nullptr; }
+    operator RL_Map() const { return map_; }
+    RL_Map &get() { return map_; }
+    const RL_Map &get() const { return map_; }
+
+    unsigned int width() const { return map_.width; }
+    unsigned int height() const { return map_.height; }
+    bool in_bounds(unsigned int x, unsigned int y) const { return x < map_.width && y < map_.height; }
+    bool passable(unsigned int x, unsigned int y) const { return rl_map_is_passable(map_, x, y); }
+    bool opaque(unsigned int x, unsigned int y) const { return rl_map_is_opaque(map_, x, y); }
+    RL_Byte &operator()(unsigned int x, unsigned int y) { return map_.tiles[x + y*map_.width]; }
+    RL_Byte operator()(unsigned int x, unsigned int y) const { return map_.tiles[x + y*map_.width]; }
+
+private:
+    RL_Map map_;
+    const RL_Allocator *allocator_;
+};
+
+class Graph {
+public:
+    Graph() : graph_(), width_(0), height_(0) {}
+    Graph(unsigned int width, unsigned int height, RL_NeighborsFun neighbors_f = nullptr, const RL_Allocator *allocator = nullptr)
+        : graph_(rl_graph_create_ex(width, height, neighbors_f, allocator)), width_(width), height_(height) {}
+    ~Graph() { if (graph_.nodes) rl_graph_destroy(graph_); }
+    Graph(const Graph&) = delete;
+    Graph &operator=(const Graph&) = delete;
+    Graph(Graph &&other) noexcept
+        : graph_(std::exchange(other.graph_, RL_Graph())), width_(other.width_), height_(other.height_) {}
+    Graph &operator=(Graph &&other) noexcept
+    {
+        std::swap(graph_, other.graph_);
+        std::swap(width_, other.width_);
+        std::swap(height_, other.height_);
+        return *this;
+    }
+
+    explicit operator bool() const { return graph_.nodes != nullptr; }
+    operator RL_Graph() const { return graph_; }
+    RL_Graph &get() { return graph_; }
+    const RL_Graph &get() const { return graph_; }
+
+    unsigned int width() const { return width_; }
+    unsigned int height() const { return height_; }
+    RL_GraphNode &node(unsigned int x, unsigned int y) { return graph_.nodes[x + y*width_]; }
+    const RL_GraphNode &node(unsigned int x, unsigned int y) const { return graph_.nodes[x + y*width_]; }
+    float score(unsigned int x, unsigned int y) const { return graph_.nodes[x + y*width_].score; }
+    bool is_scored(unsigned int x, unsigned int y) const { return score(x, y) < unreachable; }
+
+private:
+    RL_Graph graph_;
+    unsigned int width_;
+    unsigned int height_;
+};
+
+class FOV {
+public:
+    FOV() : fov_(), allocator_(nullptr) {}
+    FOV(unsigned int width, unsigned int height, const RL_Allocator *allocator = nullptr)
+        : fov_(rl_fov_create_ex(width, height, allocator)), allocator_(allocator) {}
+    ~FOV() { if (fov_.visibility) rl_fov_destroy_ex(fov_, allocator_); }
+    FOV(const FOV&) = delete;
+    FOV &operator=(const FOV&) = delete;
+    FOV(FOV &&other) noexcept : fov_(std::exchange(other.fov_, RL_FOV())), allocator_(other.allocator_) {}
+    FOV &operator=(FOV &&other) noexcept
+    {
+        std::swap(fov_, other.fov_);
+        std::swap(allocator_, other.allocator_);
+        return *this;
+    }
+
+    explicit operator bool() const { return fov_.visibility != nullptr; }
+    operator RL_FOV() const { return fov_; }
+    RL_FOV &get() { return fov_; }
+    const RL_FOV &get() const { return fov_; }
+
+    unsigned int width() const { return fov_.width; }
+    unsigned int height() const { return fov_.height; }
+    bool visible(unsigned int x, unsigned int y) const { return rl_fov_is_visible(fov_, x, y); }
+    bool seen(unsigned int x, unsigned int y) const { return rl_fov_is_seen(fov_, x, y); }
+
+private:
+    RL_FOV fov_;
+    const RL_Allocator *allocator_;
+};
+
+class BSP {
+public:
+    BSP() : root_(nullptr) {}
+    BSP(unsigned int width, unsigned int height, const RL_Allocator *allocator = nullptr)
+        : root_(rl_bsp_create_ex(width, height, allocator)) {}
+    ~BSP() { if (root_) rl_bsp_destroy(root_); }
+    BSP(const BSP&) = delete;
+    BSP &operator=(const BSP&) = delete;
+    BSP(BSP &&other) noexcept : root_(std::exchange(other.root_, nullptr)) {}
+    BSP &operator=(BSP &&other) noexcept
+    {
+        std::swap(root_, other.root_);
+        return *this;
+    }
+
+    explicit operator bool() const { return root_ != nullptr; }
+    operator RL_BSP*() const { return root_; }
+    RL_BSP *get() const { return root_; }
+    RL_BSP *operator->() const { return root_; }
+
+private:
+    RL_BSP *root_;
+};
+
+/**
+ * Neighbor policies
+ */
+
+/* Up to 4 neighbors (no diagonals). */
+struct Cardinal {
+    template <typename Visit>
+    void operator()(unsigned int x, unsigned int y, Visit &&visit) const
+    {
+        visit(x + 1, y);
+        visit(x - 1, y);
+        visit(x, y + 1);
+        visit(x, y - 1);
+    }
+
+    /* admissible A* heuristic for unit cost steps */
+    static float distance(unsigned int from_x, unsigned int from_y, unsigned int to_x, unsigned int to_y)
+    {
+        return std::abs((int) from_x - (int) to_x) + std::abs((int) from_y - (int) to_y);
+    }
+};
+
+/* Up to 8 neighbors (including diagonals) - same order as rl_graph_neighbors_ordinal. */
+struct Ordinal {
+    template <typename Visit>
+    void operator()(unsigned int x, unsigned int y, Visit &&visit) const
+    {
+        visit(x + 1, y);
+        visit(x - 1, y);
+        visit(x, y + 1);
+        visit(x, y - 1);
+        visit(x + 1, y + 1);
+        visit(x + 1, y - 1);
+        visit(x - 1, y + 1);
+        visit(x - 1, y - 1);
+    }
+
+    /* admissible A* heuristic for unit cost steps, with diagonal steps costing up to 1.4 */
+    static float distance(unsigned int from_x, unsigned int from_y, unsigned int to_x, unsigned int to_y)
+    {
+        int dx = std::abs((int) from_x - (int) to_x);
+        int dy = std::abs((int) from_y - (int) to_y);
+        return dx > dy ? dx + 0.4f * dy : dy + 0.4f * dx;
+    }
+};
+
+/**
+ * Cost policies
+ */
+
+/* Default cost - same as rl_graph_score with a NULL score_f: 1 for cardinal steps, 1.4 for diagonal steps & blocks
+ * tiles that are not passable. */
+struct PassableCost {
+    RL_Map map;
+
+    explicit PassableCost(const RL_Map &map) : map(map) {}
+
+    float operator()(unsigned int from_x, unsigned int from_y, unsigned int to_x, unsigned int to_y) const
+    {
+        if (!rl_map_is_passable(map, to_x, to_y)) return unreachable;
+        return from_x == to_x || from_y == to_y ? 1.0f : 1.4f;
+    }
+};
+
+namespace detail {
+    struct QueueEntry {
+        float priority;
+        float score;
+        size_t index;
+
+        bool operator>(const QueueEntry &other) const { return priority > other.priority; }
+    };
+    typedef std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry> > Queue;
+}
+
+/**
+ * Scores the graph with the Dijkstra algorithm starting at start, writing the scores into the graph nodes (unreachable
+ * nodes are set to rl::unreachable). The graph can then be used with the C API, e.g. rl_path_create_from_graph.
+ *
+ * Duplicate queue entries are skipped when popped (lazy deletion) instead of decreasing the key in place.
+ */
+template <typename Neighbors = Ordinal, typename Cost>
+void dijkstra(RL_Graph graph, unsigned int width, RL_Point start, Cost &&cost, Neighbors neighbors = Neighbors())
+{
+    RL_ASSERT(graph.nodes != NULL && width > 0);
+    if (graph.nodes == nullptr || width == 0) return;
+    unsigned int height = graph.length / width;
+    unsigned int start_x = start.x, start_y = start.y;
+    for (size_t i = 0; i < graph.length; ++i) {
+        graph.nodes[i].score = unreachable;
+    }
+    if (start_x >= width || start_y >= height) return;
+
+    detail::Queue queue;
+    graph.nodes[start_x + start_y*width].score = 0;
+    queue.push({ 0, 0, start_x + start_y*(size_t) width });
+    while (!queue.empty()) {
+        detail::QueueEntry current = queue.top();
+        queue.pop();
+        if (current.score > graph.nodes[current.index].score) continue; /* stale entry */
+        unsigned int x = current.index % width, y = current.index / width;
+        neighbors(x, y, [&](unsigned int nx, unsigned int ny) {
+            if (nx >= width || ny >= height) return;
+            float step = cost(x, y, nx, ny);
+            if (step >= unreachable) return;
+            float score = current.score + step;
+            RL_GraphNode &neighbor = graph.nodes[nx + ny*width];
+            if (score < neighbor.score) {
+                neighbor.score = score;
+                queue.push({ score, score, nx + ny*(size_t) width });
+            }
+        });
+    }
+}
+
+template <typename Neighbors = Ordinal, typename Cost>
+void dijkstra(Graph &graph, RL_Point start, Cost &&cost, Neighbors neighbors = Neighbors())
+{
+    dijkstra<Neighbors>(graph.get(), graph.width(), start, std::forward<Cost>(cost), neighbors);
+}
+
+/**
+ * Finds the shortest path from start to end with the A* algorithm. Returns the path including both start & end, or an
+ * empty path if end is unreachable.
+ *
+ * Unlike dijkstra the graph is scored from start (each expanded node has its distance from start, unexpanded nodes
+ * are set to rl::unreachable). The heuristic is called like the cost policy & must not overestimate the cost -
+ * pass Neighbors::distance for unit step costs.
+ */
+template <typename Neighbors = Ordinal, typename Cost, typename Heuristic>
+std::vector<RL_Point> astar(RL_Graph graph, unsigned int width, RL_Point start, RL_Point end, Cost &&cost, Heuristic &&heuristic, Neighbors neighbors = Neighbors())
+{
+    std::vector<RL_Point> path;
+    RL_ASSERT(graph.nodes != NULL && width > 0);
+    if (graph.nodes == nullptr || width == 0) return path;
+    unsigned int height = graph.length / width;
+    unsigned int start_x = start.x, start_y = start.y, end_x = end.x, end_y = end.y;
+    for (size_t i = 0; i < graph.length; ++i) {
+        graph.nodes[i].score = unreachable;
+    }
+    if (start_x >= width || start_y >= height || end_x >= width || end_y >= height) return path;
+
+    std::vector<size_t> parents(graph.length);
+    size_t start_index = start_x + start_y*(size_t) width, end_index = end_x + end_y*(size_t) width;
+    detail::Queue queue;
+    graph.nodes[start_index].score = 0;
+    parents[start_index] = start_index;
+    queue.push({ heuristic(start_x, start_y, end_x, end_y), 0, start_index });
+    while (!queue.empty()) {
+        detail::QueueEntry current = queue.top();
+        queue.pop();
+        if (current.score > graph.nodes[current.index].score) continue; /* stale entry */
+        if (current.index == end_index) break;
+        unsigned int x = current.index % width, y = current.index / width;
+        neighbors(x, y, [&](unsigned int nx, unsigned int ny) {
+            if (nx >= width || ny >= height) return;
+            float step = cost(x, y, nx, ny);
+            if (step >= unreachable) return;
+            float score = current.score + step;
+            size_t index = nx + ny*(size_t) width;
+            if (score < graph.nodes[index].score) {
+                graph.nodes[index].score = score;
+                parents[index] = current.index;
+                queue.push({ score + heuristic(nx, ny, end_x, end_y), score, index });
+            }
+        });
+    }
+    if (graph.nodes[end_index].score >= unreachable) return path;
+
+    for (size_t index = end_index; ; index = parents[index]) {
+        path.push_back(rl_point(index % width, index / width));
+        if (index == start_index) break;
+    }
+    std::reverse(path.begin(), path.end());
+
+    return path;
+}
+
+template <typename Neighbors = Ordinal, typename Cost, typename Heuristic>
+std::vector<RL_Point> astar(Graph &graph, RL_Point start, RL_Point end, Cost &&cost, Heuristic &&heuristic, Neighbors neighbors = Neighbors())
+{
+    return astar<Neighbors>(graph.get(), graph.width(), start, end, std::forward<Cost>(cost), std::forward<Heuristic>(heuristic), neighbors);
+}
+
+/* Same as above using Neighbors::distance as the heuristic. */
+template <typename Neighbors = Ordinal, typename Cost>
+std::vector<RL_Point> astar(Graph &graph, RL_Point start, RL_Point end, Cost &&cost)
+{
+    return astar<Neighbors>(graph.get(), graph.width(), start, end, std::forward<Cost>(cost), &Neighbors::distance);
+}
+
+namespace detail {
+    struct Slope {
+        int y, x;
+    };
+
+    /* same shadowcasting algorithm as rl_fov_calculate_recursive, with the callbacks inlined */
+    template <typename InRange, typename Opaque, typename Mark>
+    RL_Status shadowcast(int origin_x, int origin_y, InRange &in_range, Opaque &opaque, Mark &mark, int octant, int original_x, Slope top, Slope bottom)
+    {
+        for (int x = original_x; x < RL_MAX_RECURSION; ++x) {
+            int top_y = top.x == 1 ? x : ((x*2+1) * top.y + top.x - 1) / (top.x*2);
+            int bottom_y = bottom.y == 0 ? 0 : ((x*2-1) * bottom.y + bottom.x) / (bottom.x*2);
+            int was_opaque = -1; /* 0:false, 1:true, -1:not applicable */
+            for (int y = top_y; y >= bottom_y; --y) {
+                int tx = origin_x, ty = origin_y;
+                switch (octant) { /* translate local coordinates to map coordinates */
+                    case 0: tx += x; ty -= y; break;
+                    case 1: tx += y; ty -= x; break;
+                    case 2: tx -= y; ty -= x; break;
+                    case 3: tx -= x; ty -= y; break;
+                    case 4: tx -= x; ty += y; break;
+                    case 5: tx -= y; ty += x; break;
+                    case 6: tx += y; ty += x; break;
+                    case 7: tx += x; ty += y; break;
+                }
+
+                bool is_in_range = in_range(tx, ty);
+                if (is_in_range && (!RL_FOV_SYMMETRIC || ((y != top_y || top.y*x >= top.x*y) && (y != bottom_y || bottom.y*x <= bottom.x*y)))) {
+                    mark(tx, ty);
+                }
+                if (x == original_x && !is_in_range) {
+                    return RL_OK;
+                }
+
+                if (!is_in_range || opaque(tx, ty)) {
+                    if (was_opaque == 0) {
+                        Slope new_bottom = { y*2 + 1, x*2 - 1 };
+                        if (!is_in_range || y == bottom_y) { bottom = new_bottom; break; }
+                        shadowcast(origin_x, origin_y, in_range, opaque, mark, octant, x + 1, top, new_bottom);
+                    }
+                    was_opaque = 1;
+                } else {
+                    if (was_opaque > 0) {
+                        top.y = y*2 + 1;
+                        top.x = x*2 + 1;
+                    }
+                    was_opaque = 0;
+                }
+            }
+
+            if (was_opaque != 0) {
+                return RL_OK;
+            }
+        }
+
+        return RL_ErrorRecursion;
+    }
+}
+
+/**
+ * Calculates FOV with the same shadowcasting algorithm as rl_fov_calculate, but with an inlined opaque policy called
+ * with (x, y) for tiles within the bounds of the FOV. Set fov_radius to a negative value for unlimited FOV.
+ *
+ * Note that this sets previously visible tiles to RL_TileSeen.
+ */
+template <typename Opaque>
+RL_Status fov(RL_FOV fov, unsigned int x, unsigned int y, int fov_radius, Opaque &&opaque)
+{
+    RL_ASSERT(fov.visibility != NULL);
+    if (fov.visibility == nullptr) return RL_ErrorNullParameter;
+    if (x >= fov.width || y >= fov.height) return RL_ErrorInvalidParameter;
+    size_t length = fov.width * (size_t) fov.height;
+    for (size_t i = 0; i < length; ++i) {
+        if (fov.visibility[i] == RL_TileVisible) fov.visibility[i] = RL_TileSeen;
+    }
+
+    int origin_x = x, origin_y = y;
+    auto in_range = [&](int tx, int ty) {
+        long dx = tx - origin_x, dy = ty - origin_y;
+        return fov_radius < 0 || dx*dx + dy*dy <= (long) fov_radius * fov_radius;
+    };
+    auto is_opaque = [&](int tx, int ty) {
+        if (tx < 0 || ty < 0 || (unsigned int) tx >= fov.width || (unsigned int) ty >= fov.height) return true;
+        return (bool) opaque((unsigned int) tx, (unsigned int) ty);
+    };
+    auto mark = [&](int tx, int ty) {
+        if (tx < 0 || ty < 0 || (unsigned int) tx >= fov.width || (unsigned int) ty >= fov.height) return;
+        fov.visibility[tx + ty*fov.width] = RL_TileVisible;
+    };
+
+    RL_Status status = RL_OK;
+    mark(origin_x, origin_y);
+    for (int octant = 0; octant < 8; ++octant) {
+        RL_Status r = detail::shadowcast(origin_x, origin_y, in_range, is_opaque, mark, octant, 1, detail::Slope{ 1, 1 }, detail::Slope{ 0, 1 });
+        if (r != RL_OK) status = r;
+    }
+
+    return status;
+}
+
+/* Same as above using rl_map_is_opaque for the map. */
+inline RL_Status fov(RL_FOV fov_map, const RL_Map &map, unsigned int x, unsigned int y, int fov_radius)
+{
+    return fov(fov_map, x, y, fov_radius, [&map](unsigned int tx, unsigned int ty) { return rl_map_is_opaque(map, tx, ty); });
+}
+
+} /* namespace rl */
+
+#endif /* RL_ROGUELIKE_HPP */
@@ -0,0 +1,259 @@
+/**
+ * roguelike_coro.hpp
+ *
+ * Optional C++20 coroutine layer for roguelike.h (see roguelike.h for the license).
+ *
+ * Wraps long running library work (automata generation, Dijkstra scoring, A* searches & batches of FOV calculations)
+ * in awaitable tasks. Each task does a slice of work, then suspends & hands itself back to an executor, so the work can
+ * share one executor with the rest of a server without blocking it. Cancellation is requested with a std::stop_token,
+ * which is checked before the first slice & between slices.
+ *
+ * An executor is anything with a schedule(std::coroutine_handle<>) method that resumes the handle later (e.g. on the
+ * next tick of your event loop). rl::ManualExecutor is a simple queue:
+ *
+ *  #define RL_IMPLEMENTATION // in one C or C++ file, as with roguelike.h
+ *  #include "roguelike_coro.hpp"
+ *
+ *  rl::ManualExecutor executor;
+ *  std::stop_source stop;
+ *  rl::Task<RL_Status> task = rl::generate_automata(executor, map, RL_MAPGEN_AUTOMATA_DEFAULTS, stop.get_token());
+ *  task.start();
+ *  while (!task.done()) executor.run_one(); // e.g. once per frame
+ *  RL_Status status = task.result();
+ *
+ * Destroying a task that hasn't finished is the same as cancelling it - the library memory owned by the task is freed
+ * with its coroutine frame. Make sure the executor won't resume it afterwards (see rl::ManualExecutor::clear).
+ *
+ * Tasks can also be awaited from other coroutines with co_await. Arguments are copied into the task, but the library
+ * structs only reference their memory - the map, graph & FOV memory must outlive the task.
+ */
+#ifndef RL_ROGUELIKE_CORO_HPP
+#define RL_ROGUELIKE_CORO_HPP
+
+#include "roguelike.h"
+
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <span>
+#include <stop_token>
+#include <utility>
+
+namespace rl {
+
+/**
+ * Lazily started coroutine task - the body doesn't run until the task is awaited or start is called.
+ */
+template <typename T>
+class Task {
+public:
+    struct promise_type {
+        T value{};
+        std::exception_ptr exception;
+        std::coroutine_handle<> continuation;
+
+        Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        auto final_suspend() noexcept
+        {
+            struct FinalAwaiter {
+                bool await_ready() noexcept { return false; }
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> h) noexcept
+                {
+                    /* resume whoever awaited this task */
+                    if (h.promise().continuation) return h.promise().continuation;
+                    return std::noop_coroutine();
+                }
+                void await_resume() noexcept {}
+            };
+            return FinalAwaiter{};
+        }
+        void return_value(T v) { value = std::move(v); }
+        void unhandled_exception() { exception = std::current_exception(); }
+    };
+
+    Task(Task &&other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+    Task &operator=(Task &&other) noexcept
+    {
+        std::swap(handle_, other.handle_);
+        return *this;
+    }
+    Task(const Task&) = delete;
+    Task &operator=(const Task&) = delete;
+    ~Task() { if (handle_) handle_.destroy(); }
+
+    /* Runs the task until its first suspension - use this to start a task outside of a coroutine. */
+    void start() { if (handle_ && !handle_.done()) handle_.resume(); }
+
+    bool done() const { return !handle_ || handle_.done(); }
+
+    /* The value returned by the task - only valid once done. Rethrows any exception thrown by the task. */
+    T &result()
+    {
+        if (handle_.promise().exception) std::rethrow_exception(handle_.promise().exception);
+        return handle_.promise().value;
+    }
+
+    bool await_ready() const noexcept { return done(); }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+    {
+        handle_.promise().continuation = awaiting;
+        return handle_;
+    }
+    T await_resume() { return std::move(result()); }
+
+private:
+    explicit Task(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+
+    std::coroutine_handle<promise_type> handle_;
+};
+
+/* Suspends the current coroutine & schedules it on the executor. */
+template <typename Executor>
+auto yield(Executor &executor)
+{
+    struct YieldAwaiter {
+        Executor &executor;
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> h) { executor.schedule(h); }
+        void await_resume() const noexcept {}
+    };
+    return YieldAwaiter{ executor };
+}
+
+/* Deleters for the C state owned by a task - the coroutine frame destroys them whether the task finishes, is cancelled
+ * or is destroyed while suspended. */
+struct MapgenAutomataEnd {
+    void operator()(RL_MapgenAutomata *gen) const { rl_mapgen_automata_end(gen); }
+};
+struct GraphScorerEnd {
+    void operator()(RL_GraphScorer *scorer) const { rl_graph_scorer_end(scorer); }
+};
+struct PathSearchDestroy {
+    void operator()(RL_PathSearch *search) const { rl_path_search_destroy(search); }
+};
+
+/* Single threaded FIFO executor - call run_one or run from your main loop. */
+class ManualExecutor {
+public:
+    void schedule(std::coroutine_handle<> h) { queue_.push_back(h); }
+
+    /* Resumes the next scheduled coroutine, returns false if nothing was scheduled. */
+    bool run_one()
+    {
+        if (queue_.empty()) return false;
+        std::coroutine_handle<> h = queue_.front();
+        queue_.pop_front();
+        h.resume();
+        return true;
+    }
+
+    /* Resumes scheduled coroutines until there are none left. */
+    void run() { while (run_one()) {} }
+
+    bool empty() const { return queue_.empty(); }
+
+    /* Drops the scheduled coroutines without resuming them, e.g. before destroying the tasks that scheduled them. */
+    void clear() { queue_.clear(); }
+
+private:
+    std::deque<std::coroutine_handle<>> queue_;
+};
+
+/**
+ * Generates an automata map with rl_mapgen_automata_step, yielding after each work_budget units of work (at least
+ * 1). Returns RL_ErrorCancelled if a stop was requested (the map is left partially generated).
+ */
+template <typename Executor>
+Task<RL_Status> generate_automata(Executor &executor, RL_Map map, RL_MapgenConfigAutomata config, std::stop_token stop = {}, unsigned long work_budget = 4096)
+{
+    if (stop.stop_requested()) co_return RL_ErrorCancelled;
+    if (work_budget == 0) work_budget = 1; /* a zero budget never progresses */
+    RL_MapgenAutomata gen;
+    RL_Status status = rl_mapgen_automata_begin(&gen, map, config);
+    std::unique_ptr<RL_MapgenAutomata, MapgenAutomataEnd> guard(&gen); /* ends the generator, doesn't free it */
+    if (status != RL_OK) co_return status;
+    while (!rl_mapgen_automata_step(&gen, work_budget)) {
+        co_await yield(executor);
+        if (stop.stop_requested()) co_return RL_ErrorCancelled;
+    }
+
+    co_return gen.status;
+}
+
+/**
+ * Scores the graph with the Dijkstra algorithm (same as rl_graph_score, see RL_GraphScorer), yielding after each
+ * expansions_per_slice nodes (at least 1). Returns RL_ErrorCancelled if a stop was requested (the scores are incomplete).
+ */
+template <typename Executor>
+Task<RL_Status> score(Executor &executor, RL_Graph graph, RL_Map map, RL_Point start, RL_ScoreFun score_f = nullptr, std::stop_token stop = {}, size_t expansions_per_slice = 4096)
+{
+    if (stop.stop_requested()) co_return RL_ErrorCancelled;
+    if (graph.nodes == nullptr || map.tiles == nullptr) co_return RL_ErrorNullParameter;
+    if (!rl_map_in_bounds(map, start.x, start.y)) co_return RL_ErrorInvalidParameter;
+    if (expansions_per_slice == 0) expansions_per_slice = 1; /* a zero budget never progresses */
+    RL_GraphContext context = rl_graph_context(graph, map); /* referenced by the scorer, lives in the coroutine frame */
+    rl_graph_reset(graph);
+    graph.nodes[(size_t) start.x + (size_t) start.y * map.width].score = 0;
+    RL_GraphScorer scorer;
+    RL_Status status = rl_graph_scorer_begin(&scorer, graph, &context, score_f);
+    std::unique_ptr<RL_GraphScorer, GraphScorerEnd> guard(&scorer); /* ends the scorer, doesn't free it */
+    if (status != RL_OK) co_return status;
+    while (!rl_graph_scorer_step(&scorer, expansions_per_slice)) {
+        co_await yield(executor);
+        if (stop.stop_requested()) co_return RL_ErrorCancelled;
+    }
+
+    co_return RL_OK;
+}
+
+/**
+ * Finds a path with the incremental A* search (see rl_path_search_create), yielding after each expansions_per_slice
+ * nodes (at least 1). Returns NULL if there is no path or a stop was requested. Make sure to call rl_path_destroy on the path.
+ */
+template <typename Executor>
+Task<RL_Path*> search(Executor &executor, RL_Map map, RL_Point start, RL_Point end, std::stop_token stop = {}, size_t expansions_per_slice = 256,
+                      RL_ScoreFun score_f = nullptr, RL_NeighborsFun neighbors_f = nullptr, RL_DistanceFun heuristic_f = nullptr)
+{
+    if (stop.stop_requested()) co_return nullptr;
+    if (expansions_per_slice == 0) expansions_per_slice = 1; /* a zero budget never progresses */
+    std::unique_ptr<RL_PathSearch, PathSearchDestroy> search(rl_path_search_create(map, start, end, score_f, neighbors_f, heuristic_f));
+    if (search == nullptr) co_return nullptr;
+    while (!rl_path_search_step(search.get(), expansions_per_slice)) {
+        co_await yield(executor);
+        if (stop.stop_requested()) co_return nullptr;
+    }
+
+    co_return search->found ? rl_path_search_path(search.get()) : nullptr;
+}
+
+/**
+ * Calculates the FOV from each origin into the FOV at the same position (same as rl_fov_calculate), yielding after
+ * each fovs_per_slice calculations (at least 1). Returns RL_ErrorCancelled if a stop was requested, or the first error returned by
+ * rl_fov_calculate.
+ */
+template <typename Executor>
+Task<RL_Status> fov_batch(Executor &executor, RL_Map map, std::span<RL_FOV> fovs, std::span<const RL_Point> origins, int fov_radius,
+                          std::stop_token stop = {}, size_t fovs_per_slice = 16)
+{
+    RL_Status status = RL_OK;
+    if (stop.stop_requested()) co_return RL_ErrorCancelled;
+    if (fovs.size() != origins.size()) co_return RL_ErrorInvalidParameter;
+    if (fovs_per_slice == 0) fovs_per_slice = 1; /* avoids dividing by zero below */
+    for (size_t i = 0; i < fovs.size(); ++i) {
+        RL_Status r = rl_fov_calculate(fovs[i], map, origins[i].x, origins[i].y, fov_radius);
+        if (r != RL_OK && status == RL_OK) status = r;
+        if ((i + 1) % fovs_per_slice == 0 && i + 1 < fovs.size()) {
+            co_await yield(executor);
+            if (stop.stop_requested()) co_return RL_ErrorCancelled;
+        }
+    }
+
+    co_return status;
+}
+
+} /* namespace rl */
+
+#endif /* RL_ROGUELIKE_CORO_HPP */